@@ -0,0 +1,186 @@
+// Compares the compile-time log classifier against the to_lower + find code
+// it replaced (isLogFile followed by getLogFileType), over a corpus of
+// filenames typical of game install and Proton prefix directories. Also
+// checks that both agree on every name.
+//
+// Usage: classifier-bench [corpus size] [iterations]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_classifier.hpp"
+
+namespace
+{
+    // The classification code from before the automaton, kept verbatim for comparison
+    std::string legacyLower(std::string_view sv)
+    {
+        std::string result;
+        result.reserve(sv.size());
+        std::transform(sv.begin(), sv.end(), std::back_inserter(result),
+                       [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+        return result;
+    }
+
+    bool legacyIsLogFile(std::string_view filename)
+    {
+        std::string lowerFilename = legacyLower(filename);
+
+        for (const auto &ext : SteamUtils::logFileExtensions)
+        {
+            if (lowerFilename.length() >= ext.length() &&
+                lowerFilename.compare(lowerFilename.length() - ext.length(),
+                                      ext.length(), ext) == 0)
+            {
+                return true;
+            }
+        }
+
+        static constexpr std::array logPatterns = {
+            std::string_view{"log"}, std::string_view{"crash"}, std::string_view{"error"},
+            std::string_view{"debug"}, std::string_view{"console"}, std::string_view{"output"},
+            std::string_view{"stderr"}, std::string_view{"stdout"}, std::string_view{"trace"},
+            std::string_view{"dump"}, std::string_view{"report"}};
+
+        for (const auto &pattern : logPatterns)
+        {
+            if (lowerFilename.find(pattern) != std::string::npos)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::string legacyLogFileType(std::string_view filename)
+    {
+        std::string lowerFilename = legacyLower(filename);
+
+        if (lowerFilename.find("crash") != std::string::npos ||
+            lowerFilename.find("dump") != std::string::npos)
+        {
+            return "crash_log";
+        }
+        if (lowerFilename.find("error") != std::string::npos)
+        {
+            return "error_log";
+        }
+        if (lowerFilename.find("debug") != std::string::npos)
+        {
+            return "debug_log";
+        }
+        if (lowerFilename.find("console") != std::string::npos)
+        {
+            return "console_log";
+        }
+        return "game_log";
+    }
+
+    std::vector<std::string> buildCorpus(std::size_t size)
+    {
+        static constexpr const char *kStems[] = {
+            "sharedassets", "level", "resources", "globalgamemanagers", "UnityPlayer", "d3dcompiler_47",
+            "steam_api64", "mono-2.0-bdwgc", "texture_atlas", "Player", "output_log", "crash",
+            "UnityCrashHandler64", "error", "debug", "console", "Launcher", "vcredist_x64", "shader_cache",
+            "pak_chunk", "localization_en", "Config", "Engine", "GameUserSettings", "Saved", "dxvk",
+            "vkd3d-proton", "steam-123456", "Report", "minidump", "stdout", "PhysX3_x64", "FMOD", "LICENSE"};
+        static constexpr const char *kExtensions[] = {
+            ".assets", ".resS", ".dll", ".exe", ".pak", ".ucas", ".utoc", ".bank", ".json", ".ini", ".cfg",
+            ".log", ".txt", ".dmp", ".mdmp", ".bin", ".dat", ".xml", ".so", ".vdf", ".bak", ".LOG", ".out"};
+
+        std::vector<std::string> corpus;
+        corpus.reserve(size);
+        std::uint32_t seed = 12345;
+        auto random = [&seed]
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return seed >> 8;
+        };
+
+        while (corpus.size() < size)
+        {
+            std::string name = kStems[random() % std::size(kStems)];
+            if (random() % 3 == 0)
+            {
+                name += std::to_string(random() % 1000);
+            }
+            name += kExtensions[random() % std::size(kExtensions)];
+            corpus.push_back(std::move(name));
+        }
+        return corpus;
+    }
+
+    template <typename Fn>
+    double timeNsPerName(const std::vector<std::string> &corpus, int iterations, Fn &&fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (const auto &name : corpus)
+            {
+                fn(name);
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (static_cast<double>(corpus.size()) * iterations);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t corpusSize = argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 100000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<std::string> corpus = buildCorpus(corpusSize);
+
+    std::size_t logs = 0;
+    std::size_t mismatches = 0;
+    for (const auto &name : corpus)
+    {
+        bool legacyLog = legacyIsLogFile(name);
+        SteamUtils::LogClassification classification = SteamUtils::classifyLogFile(name);
+        logs += classification.isLog ? 1 : 0;
+        if (legacyLog != classification.isLog ||
+            (legacyLog && legacyLogFileType(name) != SteamUtils::logCategoryName(classification.category)))
+        {
+            if (mismatches++ < 10)
+            {
+                std::cout << "mismatch: " << name << '\n';
+            }
+        }
+    }
+
+    std::cout << corpus.size() << " names (" << logs << " logs), " << iterations << " iterations, "
+              << mismatches << " mismatches\n\n";
+
+    std::size_t sink = 0;
+    double legacyNs = timeNsPerName(corpus, iterations, [&sink](const std::string &name)
+                                    {
+                                        if (legacyIsLogFile(name))
+                                        {
+                                            sink += legacyLogFileType(name).size();
+                                        } });
+    double classifierNs = timeNsPerName(corpus, iterations, [&sink](const std::string &name)
+                                        {
+                                            SteamUtils::LogClassification classification = SteamUtils::classifyLogFile(name);
+                                            if (classification.isLog)
+                                            {
+                                                sink += SteamUtils::logCategoryName(classification.category).size();
+                                            } });
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  legacy      " << std::setw(8) << legacyNs << " ns/name\n"
+              << "  classifier  " << std::setw(8) << classifierNs << " ns/name  ("
+              << std::setprecision(2) << legacyNs / classifierNs << "x)\n"
+              << "\n(checksum " << sink << ")\n";
+    return mismatches == 0 ? 0 : 1;
+}
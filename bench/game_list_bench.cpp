@@ -0,0 +1,137 @@
+// Renders the game selection screen headlessly (Dear ImGui with no window and
+// no renderer backend) over a synthetic library, scrolling the list a little
+// every frame, and reports the CPU time per frame and the vertices submitted.
+//
+// Usage: game-list-bench [game count] [frames]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <imgui.h>
+
+#include "app_state.hpp"
+#include "fonts.hpp"
+#include "game_selection_screen.hpp"
+#include "logger.hpp"
+
+namespace
+{
+    constexpr int kWarmupFrames = 10;
+    constexpr float kFrameBudgetMs = 16.6f;
+
+    std::vector<SteamUtils::GameInfo> makeGames(int count)
+    {
+        std::vector<SteamUtils::GameInfo> games;
+        games.reserve(static_cast<std::size_t>(count));
+        for (int i = 0; i < count; ++i)
+        {
+            std::string appId = std::to_string(200000 + i);
+            games.push_back({"Synthetic Game " + std::to_string(i) + ": Definitive Edition", appId,
+                             "SyntheticGame" + appId, "/games/SteamLibrary"});
+        }
+        return games;
+    }
+
+    struct FrameStats
+    {
+        double averageMs = 0;
+        double p99Ms = 0;
+        double maxMs = 0;
+        int vertices = 0; // most in any frame
+    };
+
+    FrameStats renderFrames(int gameCount, int frames)
+    {
+        ImGui::CreateContext();
+        ImGuiIO &io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        // Nothing uploads textures here, so the font atlas only has to be built
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+        UIFonts::LoadFonts(io);
+
+        AppState state;
+        state.currentScreen = Screen::GameSelection;
+        state.steamDir = "/games/Steam";
+        state.steamDirFound = true;
+        state.games = makeGames(gameCount);
+
+        std::vector<double> times;
+        FrameStats stats;
+        for (int frame = -kWarmupFrames; frame < frames; ++frame)
+        {
+            io.DisplaySize = ImVec2(1600.0f, 900.0f);
+            io.DeltaTime = 1.0f / 60.0f;
+            // Hover the list and scroll it further down every frame
+            io.AddMousePosEvent(800.0f, 600.0f);
+            io.AddMouseWheelEvent(0.0f, -1.0f);
+
+            const auto start = std::chrono::steady_clock::now();
+            ImGui::NewFrame();
+            ImGui::SetNextWindowPos(ImVec2(0, 0));
+            ImGui::SetNextWindowSize(io.DisplaySize);
+            ImGui::Begin("Steam Log Collector", nullptr,
+                         ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse |
+                             ImGuiWindowFlags_NoTitleBar);
+            RenderGameSelectionScreen(state);
+            ImGui::End();
+            ImGui::Render();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if (frame >= 0)
+            {
+                times.push_back(ms);
+                stats.vertices = std::max(stats.vertices, ImGui::GetDrawData()->TotalVtxCount);
+            }
+        }
+        ImGui::DestroyContext();
+
+        std::sort(times.begin(), times.end());
+        for (double ms : times)
+        {
+            stats.averageMs += ms;
+        }
+        stats.averageMs /= static_cast<double>(times.size());
+        stats.p99Ms = times[times.size() * 99 / 100];
+        stats.maxMs = times.back();
+        return stats;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int gameCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 600;
+
+    Logger::setOutput(nullptr);
+    IMGUI_CHECKVERSION();
+
+    std::vector<int> gameCounts = {100, 1000, gameCount};
+    std::sort(gameCounts.begin(), gameCounts.end());
+    gameCounts.erase(std::unique(gameCounts.begin(), gameCounts.end()), gameCounts.end());
+
+    std::cout << "Rendering the game list for " << frames << " frames at 1600x900\n";
+    std::cout << std::left << std::setw(9) << "games" << std::right << std::setw(12) << "avg ms" << std::setw(12)
+              << "p99 ms" << std::setw(12) << "max ms" << std::setw(12) << "vertices" << '\n';
+
+    bool overBudget = false;
+    for (int count : gameCounts)
+    {
+        const FrameStats stats = renderFrames(count, frames);
+        std::cout << std::left << std::setw(9) << count << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << stats.averageMs << std::setw(12) << stats.p99Ms << std::setw(12) << stats.maxMs
+                  << std::setw(12) << stats.vertices << '\n';
+        overBudget = overBudget || stats.p99Ms > kFrameBudgetMs;
+    }
+
+    if (overBudget)
+    {
+        std::cerr << "Frame time exceeded " << kFrameBudgetMs << " ms\n";
+        return 1;
+    }
+    return 0;
+}
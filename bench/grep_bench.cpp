@@ -0,0 +1,234 @@
+// Measures the cross-file log search (grepLogs) on a synthetic corpus mixing
+// many small logs with a few large ones: GB/s and matching lines from 1 thread
+// up to the hardware concurrency (doubling each step). Fails if any thread
+// count finds a different set of hits than the single-threaded run. A second,
+// small corpus of logs with 256 KB lines (crash dumps, binary junk) checks that
+// regex searches over them finish instead of overflowing the stack.
+//
+// Usage: grep-bench [large file MB] [small file count] [iterations] [max threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "log_grep.hpp"
+#include "logger.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr int kLargeFiles = 3;
+
+    void writeLog(const fs::path &path, std::size_t bytes, std::mt19937 &rng)
+    {
+        static const char *const kMessages[] = {
+            "Loading asset bundle shared_textures", "Frame time 16.6 ms", "Connected to matchmaking server",
+            "Shader cache hit", "Audio device changed", "Saving profile", "Warning: texture streaming budget exceeded",
+            "Error: failed to load localization key MENU_PLAY"};
+        std::ofstream out(path, std::ios::binary);
+        std::size_t written = 0;
+        for (std::uint64_t line = 0; written < bytes; ++line)
+        {
+            std::string text = "[" + std::to_string(line) + "] " + kMessages[rng() % std::size(kMessages)] + '\n';
+            out << text;
+            written += text.size();
+        }
+    }
+
+    std::vector<SteamUtils::LogFile> createCorpus(int largeMegabytes, int smallCount)
+    {
+        fs::path dir = fs::temp_directory_path() / "slc-grep-bench" /
+                       (std::to_string(largeMegabytes) + "-" + std::to_string(smallCount));
+        if (!fs::exists(dir))
+        {
+            fs::create_directories(dir);
+            std::mt19937 rng(42);
+            for (int i = 0; i < kLargeFiles; ++i)
+            {
+                writeLog(dir / ("large" + std::to_string(i) + ".log"), static_cast<std::size_t>(largeMegabytes) << 20, rng);
+            }
+            for (int i = 0; i < smallCount; ++i)
+            {
+                writeLog(dir / ("small" + std::to_string(i) + ".log"), 1024 + rng() % (64 * 1024), rng);
+            }
+        }
+
+        std::vector<SteamUtils::LogFile> logs;
+        for (const auto &entry : fs::directory_iterator(dir))
+        {
+            logs.push_back({entry.path(), entry.path().filename().string(), entry.file_size(), 0, "Log"});
+        }
+        return logs;
+    }
+
+    std::vector<SteamUtils::LogFile> createLongLineCorpus()
+    {
+        constexpr int kFiles = 4;
+        constexpr std::size_t kLongLineBytes = 256 * 1024;
+        fs::path dir = fs::temp_directory_path() / "slc-grep-bench" / "long-lines";
+        if (!fs::exists(dir))
+        {
+            fs::create_directories(dir);
+            std::mt19937 rng(7);
+            for (int i = 0; i < kFiles; ++i)
+            {
+                const fs::path path = dir / ("crash" + std::to_string(i) + ".log");
+                writeLog(path, 64 * 1024, rng);
+                std::ofstream out(path, std::ios::binary | std::ios::app);
+                for (int line = 0; line < 8; ++line)
+                {
+                    std::string junk(kLongLineBytes, 'x');
+                    for (char &c : junk)
+                    {
+                        c = static_cast<char>('a' + rng() % 26);
+                    }
+                    out << junk << '\n'
+                        << "[" << line << "] Frame time 12.5 ms\n";
+                }
+            }
+        }
+
+        std::vector<SteamUtils::LogFile> logs;
+        for (const auto &entry : fs::directory_iterator(dir))
+        {
+            logs.push_back({entry.path(), entry.path().filename().string(), entry.file_size(), 0, "Log"});
+        }
+        return logs;
+    }
+
+    using HitKey = std::tuple<std::size_t, std::uint64_t, std::uint64_t>;
+
+    std::vector<HitKey> runGrep(const std::vector<SteamUtils::LogFile> &logs, const SteamUtils::TextMatcher &matcher,
+                                unsigned threads, SteamUtils::GrepStats &stats)
+    {
+        std::vector<HitKey> hits;
+        SteamUtils::GrepOptions options;
+        options.threads = threads;
+        options.maxHits = static_cast<std::size_t>(-1);
+        options.onHits = [&hits](const std::vector<SteamUtils::GrepHit> &batch)
+        {
+            for (const auto &hit : batch)
+            {
+                hits.emplace_back(hit.fileIndex, hit.lineNumber, hit.offset);
+            }
+        };
+        stats = SteamUtils::grepLogs(logs, matcher, options);
+        std::sort(hits.begin(), hits.end());
+        return hits;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int largeMegabytes = argc > 1 ? std::atoi(argv[1]) : 256;
+    int smallCount = argc > 2 ? std::atoi(argv[2]) : 2000;
+    int iterations = argc > 3 ? std::atoi(argv[3]) : 3;
+    unsigned maxThreads = argc > 4 ? static_cast<unsigned>(std::atoi(argv[4]))
+                                   : std::max(1u, std::thread::hardware_concurrency());
+
+    Logger::setOutput(nullptr);
+    const std::vector<SteamUtils::LogFile> logs = createCorpus(largeMegabytes, smallCount);
+    std::uint64_t totalBytes = 0;
+    for (const auto &log : logs)
+    {
+        totalBytes += log.size;
+    }
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    const std::pair<const char *, SteamUtils::SearchOptions> patterns[] = {
+        {"failed to load", {false, false}},
+        {"WARNING", {true, false}},
+        {"Frame time 1[0-9]\\.", {false, true}}};
+
+    std::cout << "Searching " << logs.size() << " logs (" << kLargeFiles << " x " << largeMegabytes << " MB + "
+              << smallCount << " small, " << SteamUtils::formatFileSize(totalBytes) << ") with " << iterations
+              << " iterations\n";
+
+    bool mismatch = false;
+    for (const auto &[text, searchOptions] : patterns)
+    {
+        SteamUtils::TextMatcher matcher;
+        if (!matcher.compile(text, searchOptions))
+        {
+            std::cerr << "Bad pattern " << text << ": " << matcher.error() << '\n';
+            return 1;
+        }
+
+        std::cout << "\n\"" << text << "\"" << (searchOptions.regex ? " (regex)" : "")
+                  << (searchOptions.ignoreCase ? " (ignore case)" : "") << '\n';
+        std::cout << std::left << std::setw(9) << "threads" << std::right << std::setw(12) << "ms" << std::setw(10)
+                  << "GB/s" << std::setw(12) << "hits" << std::setw(10) << "speedup" << '\n';
+
+        SteamUtils::GrepStats stats;
+        const std::vector<HitKey> expected = runGrep(logs, matcher, 1, stats); // also warms the page cache
+        double baseline = 0;
+        for (unsigned threads : threadCounts)
+        {
+            double totalMs = 0;
+            for (int i = 0; i < iterations; ++i)
+            {
+                if (runGrep(logs, matcher, threads, stats) != expected)
+                {
+                    std::cerr << "Mismatch with " << threads << " threads\n";
+                    mismatch = true;
+                }
+                totalMs += stats.seconds * 1000.0;
+            }
+
+            double ms = totalMs / iterations;
+            if (threads == 1)
+            {
+                baseline = ms;
+            }
+            std::cout << std::left << std::setw(9) << threads << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(12) << ms << std::setw(10) << std::setprecision(2)
+                      << static_cast<double>(totalBytes) / (ms / 1000.0) / 1e9 << std::setw(12) << stats.hits
+                      << std::setw(9) << baseline / ms << "x\n";
+        }
+    }
+
+    // Patterns that make std::regex backtrack over the whole line; each line is capped, so this must just finish
+    const std::vector<SteamUtils::LogFile> longLineLogs = createLongLineCorpus();
+    std::cout << "\nLong lines: " << longLineLogs.size() << " logs with 256 KB lines\n";
+    std::cout << std::left << std::setw(24) << "pattern" << std::right << std::setw(9) << "threads" << std::setw(12)
+              << "ms" << std::setw(10) << "hits" << std::setw(10) << "clipped" << '\n';
+    for (const char *text : {"Frame time 1[0-9]\\.", ".*zzzz", "[a-z]+[0-9]"})
+    {
+        SteamUtils::TextMatcher matcher;
+        if (!matcher.compile(text, {false, true}))
+        {
+            std::cerr << "Bad pattern " << text << ": " << matcher.error() << '\n';
+            return 1;
+        }
+        SteamUtils::GrepStats stats;
+        const std::vector<HitKey> expected = runGrep(longLineLogs, matcher, 1, stats);
+        for (unsigned threads : {1u, maxThreads})
+        {
+            if (runGrep(longLineLogs, matcher, threads, stats) != expected)
+            {
+                std::cerr << "Mismatch with " << threads << " threads\n";
+                mismatch = true;
+            }
+            std::cout << std::left << std::setw(24) << text << std::right << std::setw(9) << threads << std::fixed
+                      << std::setprecision(1) << std::setw(12) << stats.seconds * 1000.0 << std::setw(10) << stats.hits
+                      << std::setw(10) << stats.clippedLines << '\n';
+        }
+    }
+    return mismatch ? 1 : 0;
+}
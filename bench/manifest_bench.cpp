@@ -0,0 +1,124 @@
+// Measures batched manifest ingestion (getInstalledGames) on a synthetic
+// steamapps directory: games/s and per-phase timings from 1 thread up to the
+// hardware concurrency (doubling each step).
+//
+// Usage: manifest-bench [manifest count] [iterations] [max threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.hpp"
+#include "steam-utils.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    fs::path createSyntheticLibrary(int manifestCount)
+    {
+        fs::path steamDir = fs::temp_directory_path() / "slc-manifest-bench" / std::to_string(manifestCount);
+        fs::path steamapps = steamDir / "steamapps";
+        if (fs::exists(steamapps))
+        {
+            return steamDir;
+        }
+        fs::create_directories(steamapps);
+
+        for (int i = 0; i < manifestCount; ++i)
+        {
+            int appId = 100000 + i * 10;
+            std::ofstream out(steamapps / ("appmanifest_" + std::to_string(appId) + ".acf"), std::ios::binary);
+            out << "\"AppState\"\n{\n"
+                << "\t\"appid\"\t\t\"" << appId << "\"\n"
+                << "\t\"universe\"\t\t\"1\"\n"
+                << "\t\"name\"\t\t\"Benchmark Game " << appId << "\"\n"
+                << "\t\"StateFlags\"\t\t\"4\"\n"
+                << "\t\"installdir\"\t\t\"BenchGame" << appId << "\"\n"
+                << "\t\"LastUpdated\"\t\t\"1700000000\"\n"
+                << "\t\"SizeOnDisk\"\t\t\"123456789\"\n"
+                << "\t\"buildid\"\t\t\"12345678\"\n"
+                << "\t\"InstalledDepots\"\n\t{\n"
+                << "\t\t\"" << appId + 1 << "\"\n\t\t{\n"
+                << "\t\t\t\"manifest\"\t\t\"1234567890123456789\"\n"
+                << "\t\t\t\"size\"\t\t\"987654321\"\n"
+                << "\t\t}\n\t}\n"
+                << "\t\"UserConfig\"\n\t{\n\t\t\"language\"\t\t\"english\"\n\t}\n"
+                << "}\n";
+        }
+        return steamDir;
+    }
+
+    SteamUtils::GameScanStats runIngest(const fs::path &steamDir, unsigned threads)
+    {
+        SteamUtils::GameScanStats stats;
+        SteamUtils::GameScanOptions options;
+        options.threads = threads;
+        options.stats = &stats;
+
+        // Silence the log lines so they do not dominate the timing
+        Logger::setOutput(nullptr);
+        (void)SteamUtils::getInstalledGames(steamDir, options);
+        Logger::setOutput(&std::cout);
+        return stats;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int manifestCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+    unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3]))
+                                   : std::max(1u, std::thread::hardware_concurrency());
+
+    fs::path steamDir = createSyntheticLibrary(manifestCount);
+    std::cout << "Ingesting " << manifestCount << " manifests from " << steamDir.string()
+              << " (" << iterations << " iterations)\n\n";
+    std::cout << std::left << std::setw(9) << "threads" << std::right
+              << std::setw(12) << "total ms" << std::setw(14) << "enumerate ms" << std::setw(12) << "parse ms"
+              << std::setw(14) << "games/s" << std::setw(10) << "speedup" << '\n';
+
+    runIngest(steamDir, 1); // warm the page cache
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double baseline = 0;
+    for (unsigned threads : threadCounts)
+    {
+        SteamUtils::GameScanStats total;
+        for (int i = 0; i < iterations; ++i)
+        {
+            SteamUtils::GameScanStats stats = runIngest(steamDir, threads);
+            total.gameCount = stats.gameCount;
+            total.libraryMs += stats.libraryMs;
+            total.enumerateMs += stats.enumerateMs;
+            total.parseMs += stats.parseMs;
+        }
+
+        double enumerateMs = total.enumerateMs / iterations;
+        double parseMs = total.parseMs / iterations;
+        double totalMs = (total.libraryMs + total.enumerateMs + total.parseMs) / iterations;
+        double gamesPerSecond = static_cast<double>(total.gameCount) / (totalMs / 1000.0);
+        if (threads == 1)
+        {
+            baseline = totalMs;
+        }
+
+        std::cout << std::left << std::setw(9) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << totalMs << std::setw(14) << enumerateMs << std::setw(12) << parseMs
+                  << std::setw(14) << std::setprecision(0) << gamesPerSecond
+                  << std::setw(9) << std::setprecision(2) << baseline / totalMs << "x\n";
+    }
+    return 0;
+}
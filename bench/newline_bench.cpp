@@ -0,0 +1,125 @@
+// Measures newline indexing throughput (GB/s) for each NewlineScanner against
+// a memchr loop over the same in-memory log text, checks that they all find
+// the same line starts, and times a full background LineIndex build.
+//
+// Usage: newline-bench [megabytes] [iterations] [average line length]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "line_index.hpp"
+
+namespace
+{
+    std::string buildText(std::size_t bytes, std::size_t averageLine)
+    {
+        std::string text;
+        text.reserve(bytes);
+        std::uint32_t seed = 12345;
+        auto random = [&seed]
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return seed >> 8;
+        };
+
+        while (text.size() < bytes)
+        {
+            // Mostly ordinary lines, with the odd long stack-trace style line
+            std::size_t length = random() % (2 * averageLine);
+            if (random() % 100 == 0)
+            {
+                length *= 20;
+            }
+            for (std::size_t i = 0; i < length && text.size() < bytes; ++i)
+            {
+                text.push_back(static_cast<char>(' ' + random() % 94));
+            }
+            text.push_back('\n');
+        }
+        text.resize(bytes);
+        return text;
+    }
+
+    void memchrLineStarts(const char *data, std::size_t size, std::vector<std::uint64_t> &out)
+    {
+        const char *cursor = data;
+        const char *end = data + size;
+        while (const void *newline = std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)))
+        {
+            cursor = static_cast<const char *>(newline) + 1;
+            out.push_back(static_cast<std::uint64_t>(cursor - data));
+        }
+    }
+
+    template <typename Fn>
+    double timeGbPerSecond(std::size_t bytes, int iterations, std::vector<std::uint64_t> &out, Fn &&fn)
+    {
+        double best = 0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            out.clear();
+            auto start = std::chrono::steady_clock::now();
+            fn(out);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, static_cast<double>(bytes) / elapsed.count() / 1e9);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t megabytes = argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 512;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::size_t averageLine = argc > 3 ? static_cast<std::size_t>(std::atol(argv[3])) : 80;
+
+    const std::string text = buildText(megabytes * 1024 * 1024, averageLine);
+    std::vector<std::uint64_t> reference;
+    reference.reserve(text.size() / averageLine * 2);
+    memchrLineStarts(text.data(), text.size(), reference);
+    std::cout << megabytes << " MB, " << reference.size() << " lines, best of " << iterations
+              << " runs (fastest available: " << SteamUtils::newlineScannerName(SteamUtils::bestNewlineScanner()) << ")\n\n";
+
+    std::vector<std::uint64_t> out;
+    out.reserve(reference.capacity());
+    double memchrGbps = timeGbPerSecond(text.size(), iterations, out, [&text](std::vector<std::uint64_t> &starts)
+                                        { memchrLineStarts(text.data(), text.size(), starts); });
+    std::cout << std::fixed << std::setprecision(2) << "  memchr  " << std::setw(7) << memchrGbps << " GB/s\n";
+
+    int mismatches = 0;
+    const SteamUtils::NewlineScanner scanners[] = {SteamUtils::NewlineScanner::Scalar, SteamUtils::NewlineScanner::Sse2,
+                                                   SteamUtils::NewlineScanner::Avx2};
+    for (SteamUtils::NewlineScanner scanner : scanners)
+    {
+        if (scanner > SteamUtils::bestNewlineScanner())
+        {
+            continue; // not supported on this CPU
+        }
+        double gbps = timeGbPerSecond(text.size(), iterations, out, [&text, scanner](std::vector<std::uint64_t> &starts)
+                                      { SteamUtils::findLineStarts(text.data(), text.size(), 0, starts, scanner); });
+        bool same = out == reference;
+        mismatches += same ? 0 : 1;
+        std::cout << "  " << std::left << std::setw(6) << SteamUtils::newlineScannerName(scanner) << std::right << "  "
+                  << std::setw(7) << gbps << " GB/s  (" << gbps / memchrGbps << "x memchr)" << (same ? "" : "  MISMATCH")
+                  << '\n';
+    }
+
+    // End to end, as the preview does it: worker thread, chunked publishing into the block table
+    SteamUtils::LineIndex index;
+    auto start = std::chrono::steady_clock::now();
+    index.start(text.data(), text.size());
+    index.wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    bool sameCount = index.lineCount() == reference.size() + (text.back() == '\n' ? 0 : 1);
+    mismatches += sameCount ? 0 : 1;
+    std::cout << "\n  LineIndex  " << std::setw(7) << static_cast<double>(text.size()) / elapsed.count() / 1e9
+              << " GB/s, " << index.lineCount() << " lines" << (sameCount ? "" : "  MISMATCH") << '\n';
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Compares the KeyValues tokenizer against the line-based parser it replaced:
+// in-memory throughput (MB/s) over one large concatenated buffer, and
+// end-to-end manifests/s parsing real appmanifest files from disk.
+//
+// Usage: vdf-bench [manifest count] [iterations]
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "steam-utils.hpp"
+#include "vdf.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::string makeManifest(int appId)
+    {
+        std::ostringstream out;
+        out << "\"AppState\"\n{\n"
+            << "\t\"appid\"\t\t\"" << appId << "\"\n"
+            << "\t\"universe\"\t\t\"1\"\n"
+            << "\t\"LauncherPath\"\t\t\"C:\\\\Program Files (x86)\\\\Steam\\\\steam.exe\"\n"
+            << "\t\"name\"\t\t\"Benchmark Game " << appId << "\"\n"
+            << "\t\"StateFlags\"\t\t\"4\"\n"
+            << "\t\"installdir\"\t\t\"BenchGame" << appId << "\"\n"
+            << "\t\"LastUpdated\"\t\t\"1700000000\"\n"
+            << "\t\"SizeOnDisk\"\t\t\"" << appId * 1024L << "\"\n"
+            << "\t\"buildid\"\t\t\"12345678\"\n"
+            << "\t\"LastOwner\"\t\t\"76561190000000000\"\n"
+            << "\t\"AutoUpdateBehavior\"\t\t\"0\"\n"
+            << "\t\"InstalledDepots\"\n\t{\n";
+        for (int depot = 0; depot < 4; ++depot)
+        {
+            out << "\t\t\"" << appId + depot + 1 << "\"\n\t\t{\n"
+                << "\t\t\t\"manifest\"\t\t\"1234567890123456789\"\n"
+                << "\t\t\t\"size\"\t\t\"987654321\"\n"
+                << "\t\t}\n";
+        }
+        out << "\t}\n"
+            << "\t\"UserConfig\"\n\t{\n\t\t\"language\"\t\t\"english\"\n\t}\n"
+            << "\t\"MountedConfig\"\n\t{\n\t\t\"language\"\t\t\"english\"\n\t}\n"
+            << "}\n";
+        return out.str();
+    }
+
+    // The getline parser from before the tokenizer, kept verbatim for comparison
+    SteamUtils::GameInfo legacyParse(std::istream &file)
+    {
+        SteamUtils::GameInfo game;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t") + 1);
+
+            if (line.find("\"appid\"") == 0)
+            {
+                size_t start = line.find("\"", 8);
+                size_t end = line.find("\"", start + 1);
+                if (start != std::string::npos && end != std::string::npos)
+                {
+                    game.appId = line.substr(start + 1, end - start - 1);
+                }
+            }
+            else if (line.find("\"name\"") == 0)
+            {
+                size_t start = line.find("\"", 7);
+                size_t end = line.find("\"", start + 1);
+                if (start != std::string::npos && end != std::string::npos)
+                {
+                    game.name = line.substr(start + 1, end - start - 1);
+                }
+            }
+            else if (line.find("\"installdir\"") == 0)
+            {
+                size_t start = line.find("\"", 12);
+                size_t end = line.find("\"", start + 1);
+                if (start != std::string::npos && end != std::string::npos)
+                {
+                    game.installDir = line.substr(start + 1, end - start - 1);
+                }
+            }
+        }
+        return game;
+    }
+
+    template <typename Fn>
+    double timeMs(int iterations, Fn &&fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            fn();
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / iterations;
+    }
+
+    void report(const char *name, double ms, std::size_t bytes, std::size_t manifests)
+    {
+        double seconds = ms / 1000.0;
+        std::cout << "  " << std::left << std::setw(10) << name
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(10) << ms << " ms"
+                  << std::setw(12) << (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds << " MB/s"
+                  << std::setw(14) << std::setprecision(0) << static_cast<double>(manifests) / seconds << " manifests/s\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int manifestCount = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::vector<std::string> manifests;
+    std::size_t totalBytes = 0;
+    for (int i = 0; i < manifestCount; ++i)
+    {
+        manifests.push_back(makeManifest(100000 + i * 10));
+        totalBytes += manifests.back().size();
+    }
+
+    std::cout << manifestCount << " manifests, " << totalBytes / 1024 << " KiB, " << iterations << " iterations\n\n";
+
+    std::size_t checksum = 0;
+
+    std::cout << "In memory:\n";
+    report("legacy", timeMs(iterations, [&]
+                            {
+                                for (const auto &text : manifests)
+                                {
+                                    std::istringstream stream(text);
+                                    checksum += legacyParse(stream).installDir.size();
+                                } }),
+           totalBytes, manifests.size());
+
+    report("tokenizer", timeMs(iterations, [&]
+                               {
+                                   SteamUtils::KeyValuesDocument document;
+                                   for (const auto &text : manifests)
+                                   {
+                                       document.parse(text);
+                                       const SteamUtils::KeyValue *appState = document.root().find("AppState");
+                                       checksum += appState ? appState->get("installdir").size() : 0;
+                                   } }),
+           totalBytes, manifests.size());
+
+    fs::path dir = fs::temp_directory_path() / "slc-vdf-bench";
+    fs::create_directories(dir);
+    std::vector<fs::path> paths;
+    for (std::size_t i = 0; i < manifests.size(); ++i)
+    {
+        paths.push_back(dir / ("appmanifest_" + std::to_string(i) + ".acf"));
+        std::ofstream(paths.back(), std::ios::binary) << manifests[i];
+    }
+
+    std::cout << "\nFrom disk:\n";
+    report("legacy", timeMs(iterations, [&]
+                            {
+                                for (const auto &path : paths)
+                                {
+                                    std::ifstream file(path);
+                                    checksum += legacyParse(file).installDir.size();
+                                } }),
+           totalBytes, paths.size());
+
+    report("tokenizer", timeMs(iterations, [&]
+                               {
+                                   for (const auto &path : paths)
+                                   {
+                                       checksum += SteamUtils::parseAcfFile(path).installDir.size();
+                                   } }),
+           totalBytes, paths.size());
+
+    fs::remove_all(dir);
+    std::cout << "\n(checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,221 @@
+// Compares the portable std::filesystem walker against the getdents64 walker,
+// and a warm scan-index replay: wall time over several runs, plus a syscall
+// census of one run taken by tracing a forked child with ptrace.
+//
+// Usage: walker-bench [directory] [iterations]
+// Without a directory a synthetic game tree is generated in the temp dir.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "logger.hpp"
+#include "steam-utils.hpp"
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define SLC_BENCH_PTRACE 1
+#include <elf.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/ptrace.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+using SteamUtils::WalkerBackend;
+
+namespace
+{
+    constexpr int kDirectories = 200;
+    constexpr int kFilesPerDirectory = 40;
+
+    fs::path createSyntheticTree()
+    {
+        fs::path root = fs::temp_directory_path() / "slc-walker-bench" / "steamapps" / "common" / "BenchGame";
+        if (fs::exists(root))
+        {
+            return root;
+        }
+
+        static constexpr const char *kNames[] = {
+            "texture.dds", "model.mdl", "sound.wem", "Player.log", "config.ini",
+            "strings.csv", "shader.bin", "level.pak", "mesh.obj", "data.json"};
+
+        for (int d = 0; d < kDirectories; ++d)
+        {
+            fs::path dir = root / ("dir" + std::to_string(d / 20)) / ("sub" + std::to_string(d));
+            fs::create_directories(dir);
+            for (int f = 0; f < kFilesPerDirectory; ++f)
+            {
+                std::ofstream(dir / (std::to_string(f) + "_" + kNames[f % 10])) << "x";
+            }
+        }
+        return root;
+    }
+
+    struct Config
+    {
+        const char *name;
+        WalkerBackend backend;
+        bool useIndex;
+    };
+
+    constexpr Config kConfigs[] = {
+        {"portable", WalkerBackend::Portable, false},
+        {"getdents64", WalkerBackend::Getdents, false},
+        {"index", WalkerBackend::Getdents, true},
+    };
+
+    std::size_t runScan(const fs::path &gameRoot, const Config &config)
+    {
+        SteamUtils::GameInfo game;
+        game.name = "BenchGame";
+        game.appId = "0";
+        game.installDir = gameRoot.filename().string();
+
+        SteamUtils::ScanOptions options;
+        options.threads = 1;
+        options.backend = config.backend;
+        options.useIndex = config.useIndex;
+
+        // Silence the per-file log lines so they do not dominate the timing
+        Logger::setOutput(nullptr);
+        std::size_t found = SteamUtils::findGameLogs(gameRoot.parent_path().parent_path().parent_path(), game, options).size();
+        Logger::setOutput(&std::cout);
+        return found;
+    }
+
+#ifdef SLC_BENCH_PTRACE
+    long syscallNumber(pid_t pid)
+    {
+        user_regs_struct regs{};
+        iovec io{&regs, sizeof(regs)};
+        if (ptrace(PTRACE_GETREGSET, pid, reinterpret_cast<void *>(NT_PRSTATUS), &io) != 0)
+        {
+            return -1;
+        }
+#if defined(__x86_64__)
+        return static_cast<long>(regs.orig_rax);
+#else
+        return static_cast<long>(regs.regs[8]);
+#endif
+    }
+
+    std::string syscallGroup(long nr)
+    {
+        switch (nr)
+        {
+        case SYS_getdents64:
+            return "getdents64";
+        case SYS_openat:
+            return "openat";
+        case SYS_close:
+            return "close";
+        case SYS_newfstatat:
+        case SYS_fstat:
+        case SYS_statx:
+#if defined(__x86_64__)
+        case SYS_stat:
+        case SYS_lstat:
+#endif
+            return "stat family";
+        case SYS_write:
+            return "write";
+        default:
+            return "other";
+        }
+    }
+
+    std::map<std::string, long> countSyscalls(const fs::path &gameRoot, const Config &config)
+    {
+        std::map<std::string, long> counts;
+
+        pid_t child = fork();
+        if (child == 0)
+        {
+            int devNull = open("/dev/null", O_WRONLY);
+            dup2(devNull, STDOUT_FILENO);
+            ptrace(PTRACE_TRACEME, 0, nullptr, nullptr);
+            raise(SIGSTOP);
+            runScan(gameRoot, config);
+            std::fflush(stdout);
+            _exit(0);
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+        ptrace(PTRACE_SETOPTIONS, child, nullptr, reinterpret_cast<void *>(PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL));
+
+        bool entering = true;
+        while (true)
+        {
+            ptrace(PTRACE_SYSCALL, child, nullptr, nullptr);
+            if (waitpid(child, &status, 0) < 0 || WIFEXITED(status) || WIFSIGNALED(status))
+            {
+                break;
+            }
+            if (WIFSTOPPED(status) && WSTOPSIG(status) == (SIGTRAP | 0x80))
+            {
+                if (entering)
+                {
+                    counts[syscallGroup(syscallNumber(child))]++;
+                    counts["total"]++;
+                }
+                entering = !entering;
+            }
+        }
+        return counts;
+    }
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    fs::path gameRoot = (argc > 1 && argv[1][0] != '\0') ? fs::path(argv[1]) : createSyntheticTree();
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+#ifndef _WIN32
+    // Keep the benchmark's scan index out of the user's real cache
+    fs::path cacheDir = fs::temp_directory_path() / "slc-walker-bench" / "cache";
+    setenv("XDG_CACHE_HOME", cacheDir.c_str(), 1);
+#endif
+
+    std::cout << "Walking: " << gameRoot.string() << " (" << iterations << " iterations)\n\n";
+
+    for (const Config &config : kConfigs)
+    {
+        std::size_t found = runScan(gameRoot, config); // warm the dentry cache (and the index)
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            found = runScan(gameRoot, config);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << std::left << std::setw(12) << config.name
+                  << " files=" << found
+                  << "  avg=" << std::fixed << std::setprecision(2) << elapsed.count() / iterations << " ms\n";
+
+#ifdef SLC_BENCH_PTRACE
+        for (const auto &[group, count] : countSyscalls(gameRoot, config))
+        {
+            std::cout << "    " << std::setw(14) << group << count << '\n';
+        }
+#else
+        std::cout << "    (syscall counting requires Linux on x86_64 or aarch64)\n";
+#endif
+        std::cout << '\n';
+    }
+    return 0;
+}
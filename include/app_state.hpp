@@ -1,10 +1,21 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "steam-utils.hpp"
+#include "log_grep.hpp"
+#include "log_watcher.hpp"
+#include "log_view.hpp"
 
 enum class Screen
 {
@@ -13,6 +24,147 @@ enum class Screen
     LogFiles
 };
 
+// "Copy Selected" runs on a background thread; the UI reads these counters every frame
+struct CopyTask
+{
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+    std::atomic<std::size_t> filesDone{0};
+    std::atomic<std::size_t> fileCount{0};
+    std::atomic<std::uint64_t> bytesCopied{0};
+    std::atomic<std::uint64_t> totalBytes{0};
+    std::atomic<std::uint64_t> bytesPerSecond{0};
+    int copiedCount = 0; // written by the worker before finished is set
+    std::filesystem::path outputDir;
+
+    ~CopyTask()
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+};
+
+// "Search All Logs" also runs on a background thread; hits are appended under the mutex as they stream in
+struct GrepTask
+{
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+    std::atomic<bool> cancel{false};
+    std::atomic<std::size_t> filesDone{0};
+    std::mutex mutex; // guards hits
+    std::vector<SteamUtils::GrepHit> hits;
+    std::vector<SteamUtils::LogFile> logFiles; // what GrepHit::fileIndex refers to; the watcher may change state.logFiles
+    SteamUtils::TextMatcher matcher;
+    SteamUtils::GrepStats stats; // written by the worker before finished is set
+    char query[256] = "";
+    SteamUtils::SearchOptions options;
+    bool showResults = false;
+
+    ~GrepTask()
+    {
+        cancel = true;
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+};
+
+// Display strings for one row of the log files table, formatted when the row arrives or its file changes
+struct LogRowText
+{
+    std::string size; // empty until formatted
+    std::string modified;
+    std::uintmax_t sizeBytes = 0; // the values the strings were formatted from
+    std::int64_t modifiedNs = 0;
+};
+
+// One level of the log files table's sort; state.logFiles itself stays in discovery order
+struct LogSortKey
+{
+    enum class Column
+    {
+        Name,
+        Type,
+        Size,
+        Modified
+    };
+
+    Column column;
+    bool descending;
+};
+
+// Log discovery for the selected game runs on a background thread as well; found files wait in pending for the UI
+struct LogScanTask
+{
+    std::thread worker;
+    std::atomic<bool> finished{false};
+    std::atomic<bool> cancel{false};
+    std::atomic<std::size_t> directoriesScanned{0};
+    std::atomic<std::size_t> filesFound{0};
+    std::mutex mutex; // guards pending
+    std::vector<SteamUtils::LogFile> pending;
+    std::vector<SteamUtils::VisitedDirectory> visited; // written by the worker before finished is set
+    int maxDepth = 0;
+    bool discard = false; // the user left the game, so whatever the worker still finds is dropped
+
+    ~LogScanTask()
+    {
+        cancel = true;
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+};
+
+// One Steam detection and game listing run. The worker holds a reference too, so a run the user
+// walked away from can wind down on its own while the next one starts
+struct SteamDiscoveryJob
+{
+    std::filesystem::path manualDir; // empty: probe the usual install locations
+    std::atomic<bool> cancel{false};
+    std::atomic<bool> steamFound{false}; // steamDir is set and games start arriving in pending
+    std::atomic<bool> finished{false};
+    std::atomic<std::size_t> pathsProbed{0};
+    std::atomic<std::size_t> pathCount{0};
+    std::atomic<std::size_t> manifestsParsed{0};
+    std::atomic<std::size_t> manifestCount{0};
+    std::mutex mutex; // guards probing and pending
+    std::filesystem::path probing;
+    std::vector<SteamUtils::GameInfo> pending;
+    std::filesystem::path steamDir;          // written before steamFound is set
+    std::vector<SteamUtils::GameInfo> games; // in library order; written before finished is set, like error
+    std::string error;
+};
+
+struct SteamDiscoveryTask
+{
+    std::shared_ptr<SteamDiscoveryJob> job; // the run the UI follows, if any
+    std::thread worker;
+    std::vector<std::pair<std::shared_ptr<SteamDiscoveryJob>, std::thread>> abandoned; // joined once finished
+
+    ~SteamDiscoveryTask()
+    {
+        if (job)
+        {
+            abandoned.emplace_back(std::move(job), std::move(worker));
+        }
+        for (auto &[abandonedJob, abandonedWorker] : abandoned)
+        {
+            abandonedJob->cancel = true;
+        }
+        for (auto &[abandonedJob, abandonedWorker] : abandoned)
+        {
+            abandonedWorker.join();
+        }
+    }
+};
+
 struct AppState
 {
     Screen currentScreen = Screen::Welcome;
@@ -20,22 +172,35 @@ struct AppState
     std::filesystem::path steamDir;
     char manualSteamDir[512] = "";
     std::vector<SteamUtils::GameInfo> games;
+    SteamDiscoveryTask steamDiscovery;
     std::vector<SteamUtils::LogFile> logFiles;
     std::vector<bool> selectedLogs;
+    std::vector<LogRowText> logRowText; // parallels logFiles, like selectedLogs
+    std::size_t selectedLogCount = 0;   // number of true entries in selectedLogs
+    std::vector<LogSortKey> logSort;    // primary key first
+    std::vector<std::size_t> logOrder;  // table row -> index into logFiles, rebuilt when logOrderDirty
+    bool logOrderDirty = true;
+    SteamUtils::LogWatcher logWatcher;
+    CopyTask copyTask;
+    GrepTask grepTask;
+    LogScanTask logScan;
     int selectedGameIndex = -1;
     int previewLogIndex = -1;
 
     bool steamDirFound = false;
-    bool scanningGames = false;
-    bool scanningLogs = false;
+    bool scanningGames = false; // games are still arriving from steamDiscovery
+    bool scanningLogs = false; // logScan has a worker that has not been joined yet
 
     std::string errorMessage;
     std::string statusMessage;
-    std::string previewContent;
+
+    SteamUtils::LogView preview; // the file shown in the preview window, mapped while it is open
+    char previewQuery[256] = "";
+    SteamUtils::SearchOptions previewSearchOptions;
+    std::size_t previewMatch = 0;      // index of the highlighted match in preview.search()
+    bool previewScrollToMatch = false; // scroll to it once its line is indexed
+    std::optional<std::uint64_t> previewJumpOffset; // opened from a grep hit: select the match at this offset
 
     bool showAboutPopup = false;
     bool showPreviewWindow = false;
 };
-
-constexpr size_t kMaxPreviewBytes = 1024 * 1024; // 1 MB
-constexpr size_t kReadBufferSize = 4096;
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "logger.hpp"
+
+// Optional binary diagnostics sink. Events are fixed-size records pushed into
+// a lock-free ring and appended to a file by a background thread. Free-form
+// text (log messages, file names, errors) is copied into the ring slot and
+// written once, next to the record; small repeating vocabularies (directories,
+// game names) can be interned and referenced by id. Both end up as entries of
+// a string block. tools/log_decode.cpp turns a file back into text or JSON.
+//
+// File layout: a BinaryLogHeader, then blocks. Each block is a
+// BinaryLogBlockHeader followed by either `count` BinaryLogRecords or `count`
+// strings (uint32 id, uint32 length, bytes). A block cut short by a crash is
+// ignored by the decoder.
+
+namespace BinaryLog
+{
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief What a record describes; the meaning of its fields is given by kEventInfo
+     */
+    enum class Event : std::uint16_t
+    {
+        Message,           // s0 = text of a Logger::log call
+        Dropped,           // v0 = records lost because the ring was full
+        GamesEnumerated,   // v0 = games, v1 = manifests, v2 = elapsed ns
+        ScanStarted,       // s0 = game name, s1 = search root
+        LogFileFound,      // s0 = directory, s1 = file name, v0 = size, v1 = mtime ns, v2 = category
+        ScanFinished,      // s0 = game name, v0 = log files, v1 = elapsed ns
+        FileCopied,        // s0 = source, v0 = bytes, v1 = copy method, v2 = 1 if deduplicated
+        FileCopyFailed,    // s0 = source, s1 = error
+        CollectionFinished // v0 = files copied, v1 = bytes, v2 = elapsed ns
+    };
+
+    inline constexpr std::size_t kEventCount = static_cast<std::size_t>(Event::CollectionFinished) + 1;
+
+    /**
+     * @brief Decoder-side description of an event: its name and the names of the fields it uses (nullptr = unused)
+     */
+    struct EventInfo
+    {
+        const char *name;
+        const char *values[3];
+        const char *strings[2];
+    };
+
+    inline constexpr EventInfo kEventInfo[kEventCount] = {
+        {"message", {nullptr, nullptr, nullptr}, {"text", nullptr}},
+        {"dropped", {"records", nullptr, nullptr}, {nullptr, nullptr}},
+        {"games_enumerated", {"games", "manifests", "elapsed_ns"}, {nullptr, nullptr}},
+        {"scan_started", {nullptr, nullptr, nullptr}, {"game", "root"}},
+        {"log_file_found", {"size", "mtime_ns", "category"}, {"directory", "file"}},
+        {"scan_finished", {"files", "elapsed_ns", nullptr}, {"game", nullptr}},
+        {"file_copied", {"bytes", "method", "deduplicated"}, {"source", nullptr}},
+        {"file_copy_failed", {nullptr, nullptr, nullptr}, {"source", "error"}},
+        {"collection_finished", {"files", "bytes", "elapsed_ns"}, {nullptr, nullptr}},
+    };
+
+    struct BinaryLogHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::int64_t startNs;
+    };
+
+    struct BinaryLogBlockHeader
+    {
+        std::uint32_t kind; // kRecordBlock or kStringBlock
+        std::uint32_t count;
+        std::uint64_t bytes; // payload size after this header
+    };
+
+    struct BinaryLogRecord
+    {
+        std::int64_t timeNs; // since the Unix epoch
+        std::uint16_t event;
+        std::uint8_t level; // SeverityLevel
+        std::uint8_t reserved;
+        std::uint32_t thread; // small per-process thread number
+        std::uint64_t values[3];
+        std::uint32_t strings[2]; // ids of entries in earlier string blocks, 0 = none
+    };
+
+    static_assert(std::is_trivially_copyable_v<BinaryLogRecord> && sizeof(BinaryLogRecord) == 48);
+    static_assert(sizeof(BinaryLogHeader) % 8 == 0 && sizeof(BinaryLogBlockHeader) % 8 == 0);
+
+    inline constexpr char kMagic[8] = {'S', 'L', 'C', 'B', 'L', 'O', 'G', '\0'};
+    inline constexpr std::uint32_t kVersion = 1;
+    inline constexpr std::uint32_t kRecordBlock = 1;
+    inline constexpr std::uint32_t kStringBlock = 2;
+
+    /**
+     * @brief A string field of an event: an id returned by intern(), or text copied into the record
+     *
+     * Copied text longer than the ring slot allows is cut short.
+     */
+    struct StringArg
+    {
+        StringArg() = default;
+        StringArg(std::string_view text) noexcept : text(text), isText(true) {}
+        StringArg(const std::string &text) noexcept : text(text), isText(true) {}
+        StringArg(const char *text) noexcept : text(text), isText(true) {}
+
+        std::uint32_t id = 0;
+        std::string_view text;
+        bool isText = false;
+    };
+
+    namespace detail
+    {
+        inline std::atomic<bool> enabled{false};
+
+        void push(Event event, SeverityLevel level, std::uint64_t v0, std::uint64_t v1, std::uint64_t v2,
+                  const StringArg &s0, const StringArg &s1) noexcept;
+    }
+
+    /**
+     * @brief Starts writing events to a file (replacing it)
+     * @return False if the file cannot be created or a sink is already open
+     */
+    [[nodiscard]] bool open(const fs::path &path);
+
+    /**
+     * @brief Opens the file named by the SLC_BINARY_LOG environment variable, if set
+     */
+    void openFromEnvironment();
+
+    /**
+     * @brief Writes everything pending and closes the file (also done at exit)
+     */
+    void close();
+
+    /**
+     * @brief Whether events are being recorded (one relaxed load; check before preparing arguments)
+     */
+    [[nodiscard]] inline bool enabled() noexcept
+    {
+        return detail::enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the id of a string, assigning one (and queueing its text) the first time it is seen
+     *
+     * Meant for values that repeat across many events, such as directories;
+     * the table is capped, and once it is full the text is passed inline.
+     *
+     * @return An id, the text itself when the table is full, or nothing when the sink is closed
+     */
+    [[nodiscard]] StringArg intern(std::string_view text);
+
+    /**
+     * @brief Records one event; a no-op when the sink is closed
+     */
+    inline void emit(Event event, SeverityLevel level, std::uint64_t v0 = 0, std::uint64_t v1 = 0, std::uint64_t v2 = 0,
+                     const StringArg &s0 = {}, const StringArg &s1 = {}) noexcept
+    {
+        if (enabled())
+        {
+            detail::push(event, level, v0, v1, v2, s0, s1);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "content_store.hpp"
+
+namespace SteamUtils
+{
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief What happened to a source file since the last incremental collection
+     */
+    enum class FileChange
+    {
+        New,       // not collected before
+        Unchanged, // same stamp (or same size and windows), mirror copy intact
+        Appended,  // grew, and the previously copied bytes are still there: copy only the tail
+        Rewritten  // truncated, rotated, replaced or edited in place: copy again in full
+    };
+
+    [[nodiscard]] const char *fileChangeName(FileChange change) noexcept;
+
+    /**
+     * @brief State of one source file as of its last copy into the mirror
+     */
+    struct ManifestEntry
+    {
+        std::string mirrorName;      // file name inside the mirror directory
+        FileStamp stamp;             // size is the size of the mirror copy
+        std::uint64_t prefixHash = 0; // XXH64 of the first kWindowBytes of the copied data
+        std::uint64_t tailHash = 0;   // XXH64 of the last kWindowBytes of the copied data
+    };
+
+    /**
+     * @brief Per-game record of what an incremental mirror holds, keyed by source path
+     *
+     * Appends are detected by re-hashing two small windows of the source (its
+     * start, and the bytes just before the old end) instead of the whole file.
+     */
+    class CollectionManifest
+    {
+    public:
+        static constexpr std::uint64_t kWindowBytes = 4096;
+        static constexpr const char *kFileName = ".collect-manifest";
+
+        /**
+         * @brief Loads a manifest; a missing or unreadable file yields an empty manifest
+         */
+        void load(const fs::path &manifestPath);
+
+        /**
+         * @brief Writes the manifest atomically (temporary file + rename)
+         * @return True on success
+         */
+        bool save(const fs::path &manifestPath) const;
+
+        [[nodiscard]] const ManifestEntry *find(const std::string &source) const;
+        void set(const std::string &source, ManifestEntry entry);
+
+        /**
+         * @brief Picks a mirror file name not used by any other source ("name", "name_2", ...)
+         */
+        [[nodiscard]] std::string reserveName(std::string_view sanitizedName);
+
+        /**
+         * @brief Compares a source file with what was copied last time
+         * @param source Source path
+         * @param stamp Current stamp of the source
+         * @param mirrorFile Path of the mirror copy
+         */
+        [[nodiscard]] FileChange classify(const std::string &source, const FileStamp &stamp, const fs::path &mirrorFile) const;
+
+        /**
+         * @brief Hashes the first and last kWindowBytes of a file's first length bytes
+         * @return False if the file is shorter than length or cannot be read
+         */
+        [[nodiscard]] static bool hashWindows(const fs::path &file, std::uint64_t length, std::uint64_t &prefixHash,
+                                              std::uint64_t &tailHash);
+
+        [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+    private:
+        std::unordered_map<std::string, ManifestEntry> entries_;
+        std::unordered_set<std::string> names_;
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SteamUtils
+{
+    /**
+     * @brief Streaming XXH64 (non-cryptographic, several GB/s), used to identify file contents
+     */
+    class Xxh64
+    {
+    public:
+        explicit Xxh64(std::uint64_t seed = 0) noexcept { reset(seed); }
+
+        void reset(std::uint64_t seed = 0) noexcept;
+        void update(const void *data, std::size_t length) noexcept;
+        [[nodiscard]] std::uint64_t digest() const noexcept;
+
+        /**
+         * @brief Hashes one buffer in a single call
+         */
+        [[nodiscard]] static std::uint64_t hash(const void *data, std::size_t length, std::uint64_t seed = 0) noexcept;
+
+    private:
+        std::uint64_t seed_ = 0;
+        std::uint64_t totalLength_ = 0;
+        std::uint64_t accumulators_[4] = {};
+        unsigned char buffer_[32] = {};
+        std::size_t buffered_ = 0;
+    };
+
+    /**
+     * @brief Formats a 64-bit hash as 16 lowercase hex digits
+     */
+    [[nodiscard]] std::string toHex(std::uint64_t hash);
+}
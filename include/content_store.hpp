@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "copy_engine.hpp"
+
+namespace SteamUtils
+{
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief What a single stat says about a file's contents; equal stamps mean "not modified"
+     */
+    struct FileStamp
+    {
+        std::uint64_t size = 0;
+        std::int64_t mtimeNs = 0;
+        std::uint64_t inode = 0;
+        std::uint64_t device = 0;
+
+        [[nodiscard]] bool operator==(const FileStamp &other) const noexcept
+        {
+            return size == other.size && mtimeNs == other.mtimeNs && inode == other.inode && device == other.device;
+        }
+    };
+
+    /**
+     * @brief Reads the stamp of a regular file with a single stat
+     * @return False if the path does not exist or is not a regular file
+     */
+    [[nodiscard]] bool readFileStamp(const fs::path &file, FileStamp &stamp);
+
+    /**
+     * @brief A temporary name next to target for write-then-rename, unique across processes and threads
+     *
+     * Concurrent writers of the same target (two CLI runs, CLI and GUI) each
+     * get their own file, so a rename only ever moves a complete one into place.
+     */
+    [[nodiscard]] fs::path uniqueTempPath(const fs::path &target);
+
+    /**
+     * @brief What ContentStore::prune() removed
+     */
+    struct PruneResult
+    {
+        std::size_t blobsRemoved = 0;
+        std::uintmax_t bytesFreed = 0;
+    };
+
+    /**
+     * @brief Content-addressed blob store shared by all collections
+     *
+     * Every file is stored once under <root>/<xx>/<xxh64>-<size> and hardlinked
+     * into the collection directories that contain it. A stat cache maps source
+     * paths to the hash of the contents they had, so unchanged files are linked
+     * without being read again.
+     */
+    class ContentStore
+    {
+    public:
+        explicit ContentStore(fs::path root) : root_(std::move(root)) {}
+
+        /**
+         * @brief Creates the store directory and loads the stat cache
+         * @return False if the store directory cannot be created
+         */
+        [[nodiscard]] bool open();
+
+        /**
+         * @brief Makes destination a link to the blob holding source's contents, storing the blob if needed
+         * @param job Source, destination and expected size
+         * @param onBytes Optional, called with the bytes read so far while a new blob is written
+         * @return Outcome; contentHash is set on success, deduplicated when no data was written
+         */
+        [[nodiscard]] CopyResult store(const CopyJob &job, const std::function<void(std::uintmax_t)> &onBytes = {});
+
+        /**
+         * @brief Writes the stat cache back atomically (temporary file + rename)
+         * @return True on success or when nothing changed
+         */
+        bool save();
+
+        /**
+         * @brief Removes blobs no collection links to any more (link count 1) and their cached hashes
+         *
+         * Blobs stored or linked within the last minute are kept (outside Windows),
+         * so a collection running at the same time does not lose the blob it is linking.
+         * Call save() afterwards to write the trimmed cache.
+         *
+         * @return Number of blobs removed and the bytes they held
+         */
+        PruneResult prune();
+
+        [[nodiscard]] const fs::path &root() const noexcept { return root_; }
+        [[nodiscard]] fs::path blobPath(std::uint64_t hash, std::uint64_t size) const;
+
+    private:
+        struct CachedHash
+        {
+            FileStamp stamp;
+            std::uint64_t hash = 0;
+        };
+
+        [[nodiscard]] bool lookup(const std::string &source, const FileStamp &stamp, std::uint64_t &hash);
+        void remember(const std::string &source, const FileStamp &stamp, std::uint64_t hash);
+        [[nodiscard]] bool hashIntoStore(const fs::path &source, const std::function<void(std::uintmax_t)> &onBytes,
+                                         CopyResult &result, std::uint64_t &size);
+        bool linkBlob(const fs::path &blob, const fs::path &destination, CopyResult &result);
+
+        fs::path root_;
+        std::mutex mutex_;
+        std::unordered_map<std::string, CachedHash> cache_;
+        bool dirty_ = false;
+    };
+}
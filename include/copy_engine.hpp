@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SteamUtils
+{
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief How a file ended up being copied
+     */
+    enum class CopyMethod
+    {
+        None,          // copy failed before any data moved
+        Reflink,       // FICLONE: shares extents, no data copied (btrfs, xfs, ...)
+        CopyFileRange, // in-kernel copy, no round trip through user space
+        Buffered,      // read/write loop
+        Hardlink       // linked to a blob in the content store, no data copied
+    };
+
+    /**
+     * @brief Gets a short display name for a copy method
+     */
+    [[nodiscard]] const char *copyMethodName(CopyMethod method) noexcept;
+
+    struct CopyJob
+    {
+        fs::path source;
+        fs::path destination;
+        std::uintmax_t size = 0;         // expected bytes to copy, used for progress and scheduling
+        std::uintmax_t appendOffset = 0; // > 0: destination already holds this many leading bytes of source
+    };
+
+    struct CopyResult
+    {
+        bool success = false;
+        CopyMethod method = CopyMethod::None;
+        std::uintmax_t bytesCopied = 0;
+        std::string error;
+        std::uint64_t contentHash = 0; // set by content-store copies
+        bool deduplicated = false;     // content was already in the store
+    };
+
+    /**
+     * @brief Snapshot passed to the progress callback
+     */
+    struct CopyProgress
+    {
+        std::size_t jobIndex = 0;            // job that advanced
+        bool jobFinished = false;            // true once for every job, successful or not
+        std::uintmax_t jobBytesCopied = 0;
+        std::size_t jobsDone = 0;
+        std::size_t jobCount = 0;
+        std::uintmax_t totalBytesCopied = 0;
+        std::uintmax_t totalBytes = 0;       // sum of CopyJob::size
+        double bytesPerSecond = 0;           // average since the copy started
+    };
+
+    /**
+     * @brief Progress callback; invoked from worker threads, one call at a time
+     */
+    using CopyProgressCallback = std::function<void(const CopyProgress &)>;
+
+    /**
+     * @brief Copies one job, calling onBytes with the running byte count; must be thread-safe
+     */
+    using CopyFunction = std::function<CopyResult(const CopyJob &, const std::function<void(std::uintmax_t)> &onBytes)>;
+
+    struct CopyOptions
+    {
+        unsigned concurrency = 4; // files copied at once; 0 = hardware concurrency
+        CopyProgressCallback onProgress;
+        CopyFunction copy;        // empty = copyFileFast
+    };
+
+    /**
+     * @brief Copies one file, trying a reflink, then copy_file_range, then a buffered copy
+     * @param source File to copy
+     * @param destination Destination path, overwritten if it exists
+     * @param onBytes Optional, called with the bytes copied so far after every chunk
+     * @return Outcome, including the method that succeeded
+     */
+    [[nodiscard]] CopyResult copyFileFast(const fs::path &source, const fs::path &destination,
+                                          const std::function<void(std::uintmax_t)> &onBytes = {});
+
+    /**
+     * @brief Copies the part of source past offset onto the end of a destination that already holds the rest
+     * @param source File that has grown since it was copied
+     * @param destination Earlier copy; anything past offset is truncated first
+     * @param offset Bytes already present in destination
+     * @param onBytes Optional, called with the bytes appended so far
+     * @return Outcome; bytesCopied counts only the appended bytes. On failure destination is cut back to offset
+     */
+    [[nodiscard]] CopyResult appendFileTail(const fs::path &source, const fs::path &destination, std::uintmax_t offset,
+                                            const std::function<void(std::uintmax_t)> &onBytes = {});
+
+    /**
+     * @brief Copies a set of files with bounded concurrency
+     *
+     * Large files are started first so one multi-gigabyte dump does not end up
+     * running alone at the end.
+     *
+     * @param jobs Files to copy; jobs with an appendOffset only copy their new tail
+     * @param options Concurrency and progress reporting
+     * @return One result per job, in job order
+     */
+    [[nodiscard]] std::vector<CopyResult> copyFiles(const std::vector<CopyJob> &jobs, const CopyOptions &options);
+}
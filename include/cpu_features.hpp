@@ -0,0 +1,23 @@
+#pragma once
+
+// Runtime CPU feature checks for the hand-vectorized scanners. x86-64 always
+// has SSE2; AVX2 code is compiled per function with SLC_TARGET_AVX2 and only
+// called when cpuHasAvx2() says so, so the binary still runs on older CPUs.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SLC_HAVE_X86_SIMD 1
+#endif
+
+#if defined(SLC_HAVE_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define SLC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SLC_TARGET_AVX2
+#endif
+
+namespace SteamUtils
+{
+    /**
+     * @brief Whether AVX2 instructions can be used (CPU support and OS-saved YMM state); checked once
+     */
+    [[nodiscard]] bool cpuHasAvx2() noexcept;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "steam-utils.hpp"
+
+namespace SteamUtils
+{
+    /**
+     * @brief Scans a single directory level for log files
+     * @param directory Directory to scan
+     * @param backend Enumeration strategy; Getdents falls back to Portable off Linux
+     * @param logFiles Output vector the discovered log files are appended to
+     * @param onSubdirectory Called with the path of every subdirectory found
+     * @return False if the directory does not exist or could not be opened
+     */
+    bool scanDirectoryLevel(const fs::path &directory, WalkerBackend backend, std::vector<LogFile> &logFiles,
+                            const std::function<void(const fs::path &)> &onSubdirectory);
+
+    /**
+     * @brief Stats a single known log file and appends it, used when replaying a cached directory listing
+     * @param directory Directory containing the file
+     * @param filename Name of the file
+     * @param logFiles Output vector the log file is appended to
+     * @return False if the file is gone or no longer a regular file
+     */
+    bool restatLogFile(const fs::path &directory, std::string_view filename, std::vector<LogFile> &logFiles);
+}
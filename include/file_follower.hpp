@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace SteamUtils
+{
+    /**
+     * @brief Tells a reader when a single file may have changed, without blocking
+     *
+     * On Linux an inotify watch on the file's directory reports writes,
+     * truncation and rotation (the name being replaced) as they happen, so an
+     * idle file costs one non-blocking read per check. Elsewhere, or if inotify
+     * is unavailable, changed() simply fires every kPollInterval.
+     */
+    class FileFollower
+    {
+    public:
+        static constexpr std::chrono::milliseconds kPollInterval{250};
+
+        FileFollower() = default;
+        ~FileFollower();
+
+        FileFollower(const FileFollower &) = delete;
+        FileFollower &operator=(const FileFollower &) = delete;
+
+        /**
+         * @brief Starts watching a file, replacing any previous one
+         */
+        void start(const std::filesystem::path &path);
+
+        void stop() noexcept;
+
+        [[nodiscard]] bool isRunning() const noexcept { return running_; }
+
+        /**
+         * @brief Whether the file may have changed since the last call; the caller re-stats it to find out how
+         */
+        [[nodiscard]] bool changed();
+
+    private:
+        std::string filename_;
+        std::chrono::steady_clock::time_point lastCheck_;
+        int fd_ = -1;
+        bool running_ = false;
+    };
+}
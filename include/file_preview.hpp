@@ -1,11 +1,12 @@
 #pragma once
 
-#include <filesystem>
-#include <string>
-
 #include "app_state.hpp"
 
-std::string ReadFileContent(const std::filesystem::path &filePath,
-                            size_t maxBytes = kMaxPreviewBytes);
+/**
+ * @brief Maps a log file into the preview window and shows it
+ * @param logIndex Index into state.logFiles
+ * @return False if the file cannot be opened
+ */
+bool OpenPreview(AppState &state, int logIndex);
 
 void RenderPreviewWindow(AppState &state);
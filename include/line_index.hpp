@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "published_offsets.hpp"
+
+namespace SteamUtils
+{
+    /**
+     * @brief Implementation used to find '\n' bytes
+     */
+    enum class NewlineScanner
+    {
+        Scalar, // eight bytes at a time in general-purpose registers, any CPU
+        Sse2,   // 16 bytes per compare (x86-64 baseline)
+        Avx2    // 32 bytes per compare, picked at runtime when the CPU has it
+    };
+
+    [[nodiscard]] const char *newlineScannerName(NewlineScanner scanner) noexcept;
+
+    /**
+     * @brief Fastest scanner the running CPU supports
+     */
+    [[nodiscard]] NewlineScanner bestNewlineScanner() noexcept;
+
+    /**
+     * @brief Appends base + i + 1 for every data[i] == '\n', i.e. where each following line starts
+     */
+    void findLineStarts(const char *data, std::size_t size, std::uint64_t base, std::vector<std::uint64_t> &out,
+                        NewlineScanner scanner = bestNewlineScanner());
+
+    /**
+     * @brief Number of '\n' bytes in data
+     */
+    [[nodiscard]] std::size_t countNewlines(const char *data, std::size_t size,
+                                            NewlineScanner scanner = bestNewlineScanner()) noexcept;
+
+    /**
+     * @brief Line start offsets of a buffer, built on a worker thread and readable while it grows
+     *
+     * Offsets are kept in PublishedOffsets, so the UI thread can read lines
+     * that have already been indexed without locking while the worker carries on.
+     */
+    class LineIndex
+    {
+    public:
+        LineIndex() = default;
+        ~LineIndex();
+
+        LineIndex(const LineIndex &) = delete;
+        LineIndex &operator=(const LineIndex &) = delete;
+
+        /**
+         * @brief Starts indexing a buffer in the background, discarding any previous index
+         * @param data Must stay valid until cancel() or the destructor returns
+         */
+        void start(const char *data, std::size_t size, NewlineScanner scanner = bestNewlineScanner());
+
+        /**
+         * @brief Indexes bytes appended since the previous start()/resume(), keeping the lines already published
+         * @param data The same content as before, possibly remapped, and now `size` bytes long
+         * @param size New size; must not be smaller than the part already indexed
+         */
+        void resume(const char *data, std::size_t size, NewlineScanner scanner = bestNewlineScanner());
+
+        /**
+         * @brief Stops the worker (if running) and clears the index
+         */
+        void cancel() noexcept;
+
+        /**
+         * @brief Blocks until the whole buffer is indexed
+         */
+        void wait();
+
+        /**
+         * @brief Lines whose end is known so far; all of them once isComplete()
+         */
+        [[nodiscard]] std::size_t lineCount() const noexcept;
+
+        /**
+         * @brief Byte offset where a line starts
+         * @param index Below lineCount(), or equal to it while indexing (the next line's start)
+         */
+        [[nodiscard]] std::uint64_t lineStart(std::size_t index) const noexcept
+        {
+            return starts_[index];
+        }
+
+        /**
+         * @brief Number of line starts published, including the last one whose end is not found yet
+         */
+        [[nodiscard]] std::size_t startCount() const noexcept { return starts_.size(); }
+
+        [[nodiscard]] std::size_t indexedBytes() const noexcept { return indexedBytes_.load(std::memory_order_relaxed); }
+        [[nodiscard]] bool isComplete() const noexcept { return complete_.load(std::memory_order_acquire); }
+
+    private:
+        void run(const char *data, std::size_t begin, std::size_t size, NewlineScanner scanner);
+
+        PublishedOffsets starts_; // capped at 2^32 lines
+        std::atomic<std::size_t> indexedBytes_{0};
+        std::atomic<bool> complete_{false};
+        std::atomic<bool> cancel_{false};
+        std::thread worker_;
+    };
+}
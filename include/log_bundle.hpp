@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace SteamUtils
+{
+    namespace fs = std::filesystem;
+
+    // On-disk layout: a header, the member contents back to back, then the index
+    // (fixed-size entries, a string blob) and a fixed-size footer at the very end.
+    // Readers only touch the footer, the index and the one member they want.
+
+    struct BundleString
+    {
+        std::uint64_t offset;
+        std::uint32_t length;
+        std::uint32_t reserved;
+    };
+
+    struct BundleHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    struct BundleEntry
+    {
+        std::uint64_t dataOffset;
+        std::uint64_t size;
+        std::int64_t lastModifiedNs;
+        BundleString name;
+        BundleString originalPath;
+        BundleString type;
+    };
+
+    struct BundleFooter
+    {
+        std::uint64_t entriesOffset;
+        std::uint64_t entryCount;
+        std::uint64_t stringsOffset;
+        std::uint64_t stringsSize;
+        std::int64_t createdNs;
+        BundleString gameName;
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    static_assert(std::is_trivially_copyable_v<BundleEntry> && sizeof(BundleEntry) % 8 == 0);
+    static_assert(std::is_trivially_copyable_v<BundleFooter> && sizeof(BundleFooter) % 8 == 0);
+
+    inline constexpr char kBundleMagic[8] = {'S', 'L', 'C', 'B', 'N', 'D', 'L', '\0'};
+    inline constexpr char kBundleIndexMagic[8] = {'S', 'L', 'C', 'B', 'I', 'D', 'X', '\0'};
+    inline constexpr std::uint32_t kBundleVersion = 1;
+    inline constexpr std::string_view kBundleExtension = ".slcb";
+
+    /**
+     * @brief Metadata of one file stored in a bundle
+     */
+    struct BundleMember
+    {
+        std::string name;
+        std::string originalPath;
+        std::string type;
+        std::uint64_t dataOffset = 0;
+        std::uint64_t size = 0;
+        std::int64_t lastModifiedNs = 0;
+    };
+
+    /**
+     * @brief Streams files into a bundle, then appends the index on finish()
+     */
+    class BundleWriter
+    {
+    public:
+        BundleWriter() = default;
+        ~BundleWriter();
+
+        BundleWriter(const BundleWriter &) = delete;
+        BundleWriter &operator=(const BundleWriter &) = delete;
+
+        /**
+         * @brief Creates the bundle file and writes its header
+         * @param bundlePath Destination; written as a temporary file and renamed by finish()
+         * @param gameName Game the logs belong to, stored in the index
+         * @return False if the file cannot be created
+         */
+        [[nodiscard]] bool open(const fs::path &bundlePath, std::string_view gameName);
+
+        /**
+         * @brief Appends one file's contents to the bundle
+         * @param source File to read
+         * @param name Member name inside the bundle; a bare file name, without separators
+         * @param type Log type recorded in the index
+         * @param lastModifiedNs Modification time recorded in the index
+         * @return False if the name is not a bare file name or the file could not be read (nothing is added) or the bundle could not be written
+         */
+        [[nodiscard]] bool addFile(const fs::path &source, std::string_view name, std::string_view type,
+                                   std::int64_t lastModifiedNs);
+
+        /**
+         * @brief Writes the index and footer and moves the bundle into place
+         * @return True on success
+         */
+        [[nodiscard]] bool finish();
+
+        [[nodiscard]] std::size_t memberCount() const noexcept { return entries_.size(); }
+
+    private:
+        [[nodiscard]] BundleString intern(std::string_view text);
+        void abandon() noexcept;
+
+        fs::path bundlePath_;
+        fs::path tempPath_;
+        std::ofstream out_;
+        std::uint64_t offset_ = 0;
+        std::vector<BundleEntry> entries_;
+        std::string strings_;
+        BundleString gameName_{};
+    };
+
+    /**
+     * @brief Reads a bundle's index and extracts individual members by seeking
+     */
+    class BundleReader
+    {
+    public:
+        /**
+         * @brief Opens a bundle and loads its index (member contents are not read)
+         * @param bundlePath Bundle file
+         * @return False if the file is missing, truncated, not a bundle, or names a member with a path
+         */
+        [[nodiscard]] bool open(const fs::path &bundlePath);
+
+        [[nodiscard]] const std::vector<BundleMember> &members() const noexcept { return members_; }
+        [[nodiscard]] const std::string &gameName() const noexcept { return gameName_; }
+        [[nodiscard]] std::int64_t createdNs() const noexcept { return createdNs_; }
+
+        /**
+         * @brief Looks a member up by name, or by its 1-based position when the key is a number
+         * @return Index into members(), std::nullopt if there is no such member
+         */
+        [[nodiscard]] std::optional<std::size_t> find(std::string_view key) const;
+
+        /**
+         * @brief Copies one member's contents to a stream
+         * @return False on a read or write error
+         */
+        [[nodiscard]] bool extract(const BundleMember &member, std::ostream &out);
+
+        /**
+         * @brief Copies one member's contents to a file
+         * @return False on a read or write error
+         */
+        [[nodiscard]] bool extract(const BundleMember &member, const fs::path &destination);
+
+    private:
+        std::ifstream in_;
+        std::uint64_t fileSize_ = 0;
+        std::vector<BundleMember> members_;
+        std::string gameName_;
+        std::int64_t createdNs_ = 0;
+    };
+}
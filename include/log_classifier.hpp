@@ -0,0 +1,250 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "steam-utils.hpp"
+
+namespace SteamUtils
+{
+    /**
+     * @brief Log category of a file, derived from its name
+     */
+    enum class LogCategory : std::uint8_t
+    {
+        None, // not a log file
+        Game,
+        Crash,
+        Error,
+        Debug,
+        Console
+    };
+
+    struct LogClassification
+    {
+        bool isLog;
+        LogCategory category;
+    };
+
+    /**
+     * @brief Gets the LogFile::type string of a category
+     * @return "crash_log", "error_log", "debug_log", "console_log", "game_log", or empty for None
+     */
+    [[nodiscard]] constexpr std::string_view logCategoryName(LogCategory category) noexcept
+    {
+        switch (category)
+        {
+        case LogCategory::Crash:
+            return "crash_log";
+        case LogCategory::Error:
+            return "error_log";
+        case LogCategory::Debug:
+            return "debug_log";
+        case LogCategory::Console:
+            return "console_log";
+        case LogCategory::Game:
+            return "game_log";
+        case LogCategory::None:
+            break;
+        }
+        return {};
+    }
+
+    namespace detail
+    {
+        /**
+         * Case-insensitive Aho-Corasick automaton over logFilePatterns (anywhere in
+         * the name) and logFileExtensions (at the end of the name), built entirely at
+         * compile time. Bytes are first mapped to a small alphabet of the characters
+         * the patterns use, which keeps the transition table in a few kilobytes.
+         */
+        class LogClassifierAutomaton
+        {
+        public:
+            constexpr LogClassifierAutomaton()
+            {
+                for (std::string_view pattern : logFilePatterns)
+                {
+                    addClasses(pattern);
+                }
+                for (std::string_view extension : logFileExtensions)
+                {
+                    addClasses(extension);
+                }
+
+                for (std::size_t i = 0; i < logFilePatterns.size(); ++i)
+                {
+                    matches_[insert(logFilePatterns[i])] |= static_cast<std::uint16_t>(1u << i);
+                }
+                for (std::string_view extension : logFileExtensions)
+                {
+                    matches_[insert(extension)] |= kExtensionBit;
+                }
+
+                link();
+
+                crashMask_ = patternBit("crash") | patternBit("dump");
+                errorMask_ = patternBit("error");
+                debugMask_ = patternBit("debug");
+                consoleMask_ = patternBit("console");
+            }
+
+            [[nodiscard]] constexpr LogClassification classify(std::string_view filename) const noexcept
+            {
+                std::uint8_t state = 0;
+                std::uint16_t seen = 0;
+                for (char c : filename)
+                {
+                    state = next_[state][classOf_[static_cast<unsigned char>(c)]];
+                    seen |= matches_[state];
+                }
+
+                // Patterns count anywhere; extensions only when one ends at the last character
+                bool isLog = (seen & ~kExtensionBit) != 0 || (matches_[state] & kExtensionBit) != 0;
+                if (!isLog)
+                {
+                    return {false, LogCategory::None};
+                }
+                if (seen & crashMask_)
+                {
+                    return {true, LogCategory::Crash};
+                }
+                if (seen & errorMask_)
+                {
+                    return {true, LogCategory::Error};
+                }
+                if (seen & debugMask_)
+                {
+                    return {true, LogCategory::Debug};
+                }
+                if (seen & consoleMask_)
+                {
+                    return {true, LogCategory::Console};
+                }
+                return {true, LogCategory::Game};
+            }
+
+            [[nodiscard]] constexpr std::size_t stateCount() const noexcept { return stateCount_; }
+
+        private:
+            static constexpr std::size_t kMaxStates = 160;
+            static constexpr std::size_t kMaxClasses = 32;
+            static constexpr std::uint16_t kExtensionBit = 0x8000;
+            static_assert(logFilePatterns.size() < 15, "pattern bits must not collide with kExtensionBit");
+
+            static constexpr char lower(char c) noexcept
+            {
+                return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+            }
+
+            constexpr void addClasses(std::string_view text)
+            {
+                for (char c : text)
+                {
+                    char l = lower(c);
+                    if (classOf_[static_cast<unsigned char>(l)] == 0)
+                    {
+                        classOf_[static_cast<unsigned char>(l)] = classCount_;
+                        if (l >= 'a' && l <= 'z')
+                        {
+                            classOf_[static_cast<unsigned char>(l - 'a' + 'A')] = classCount_;
+                        }
+                        classCount_++;
+                    }
+                }
+            }
+
+            constexpr std::size_t insert(std::string_view text)
+            {
+                std::size_t state = 0;
+                for (char c : text)
+                {
+                    std::uint8_t cls = classOf_[static_cast<unsigned char>(c)];
+                    if (next_[state][cls] == 0)
+                    {
+                        next_[state][cls] = static_cast<std::uint8_t>(stateCount_++);
+                    }
+                    state = next_[state][cls];
+                }
+                return state;
+            }
+
+            // Breadth-first failure links, folding them into a complete transition table
+            constexpr void link()
+            {
+                std::array<std::uint8_t, kMaxStates> fail{};
+                std::array<std::uint8_t, kMaxStates> queue{};
+                std::size_t head = 0;
+                std::size_t tail = 0;
+
+                for (std::size_t cls = 0; cls < classCount_; ++cls)
+                {
+                    if (next_[0][cls] != 0)
+                    {
+                        queue[tail++] = next_[0][cls];
+                    }
+                }
+
+                while (head < tail)
+                {
+                    std::uint8_t state = queue[head++];
+                    for (std::size_t cls = 0; cls < classCount_; ++cls)
+                    {
+                        std::uint8_t child = next_[state][cls];
+                        if (child != 0)
+                        {
+                            fail[child] = next_[fail[state]][cls];
+                            matches_[child] |= matches_[fail[child]];
+                            queue[tail++] = child;
+                        }
+                        else
+                        {
+                            next_[state][cls] = next_[fail[state]][cls];
+                        }
+                    }
+                }
+            }
+
+            constexpr std::uint16_t patternBit(std::string_view pattern) const
+            {
+                for (std::size_t i = 0; i < logFilePatterns.size(); ++i)
+                {
+                    if (logFilePatterns[i] == pattern)
+                    {
+                        return static_cast<std::uint16_t>(1u << i);
+                    }
+                }
+                return 0;
+            }
+
+            std::array<std::uint8_t, 256> classOf_{};
+            std::uint8_t classCount_ = 1; // class 0 = any character no pattern uses
+            std::array<std::array<std::uint8_t, kMaxClasses>, kMaxStates> next_{};
+            std::array<std::uint16_t, kMaxStates> matches_{};
+            std::size_t stateCount_ = 1;
+            std::uint16_t crashMask_ = 0;
+            std::uint16_t errorMask_ = 0;
+            std::uint16_t debugMask_ = 0;
+            std::uint16_t consoleMask_ = 0;
+        };
+
+        inline constexpr LogClassifierAutomaton kLogClassifier{};
+    }
+
+    /**
+     * @brief Classifies a filename in one pass, without allocating
+     * @param filename Name of the file (not a full path)
+     * @return Whether the file is a log file, and its category
+     */
+    [[nodiscard]] constexpr LogClassification classifyLogFile(std::string_view filename) noexcept
+    {
+        return detail::kLogClassifier.classify(filename);
+    }
+
+    static_assert(classifyLogFile("Player.LOG").category == LogCategory::Game);
+    static_assert(classifyLogFile("crash_2024.dmp").category == LogCategory::Crash);
+    static_assert(classifyLogFile("readme.txt").isLog && !classifyLogFile("texture.dds").isLog);
+    static_assert(!classifyLogFile("notes.txt.bak").isLog);
+}
@@ -2,4 +2,16 @@
 
 #include "app_state.hpp"
 
+/**
+ * @brief Starts finding a game's logs on a background thread and switches to the log files screen, which fills in as they arrive
+ * @param gameIndex Index into state.games
+ * @return False if the previous scan has not wound down yet
+ */
+bool StartLogScan(AppState &state, int gameIndex);
+
+/**
+ * @brief Moves newly found logs into state.logFiles and wraps up a finished scan; call every frame while one may run
+ */
+void UpdateLogScan(AppState &state);
+
 void RenderLogFilesScreen(AppState &state);
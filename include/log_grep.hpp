@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "steam-utils.hpp"
+#include "text_search.hpp"
+
+namespace SteamUtils
+{
+    /**
+     * @brief One line of a log that matches a grep pattern
+     */
+    struct GrepHit
+    {
+        std::size_t fileIndex = 0;   // into the searched LogFile list
+        std::uint64_t lineNumber = 0; // 1-based
+        std::uint64_t offset = 0;     // byte offset of the first match on the line
+        std::string context;          // the line (or the part of a long one around the match), without its terminator
+        std::size_t contextMatch = 0; // where the match starts in context
+    };
+
+    /**
+     * @brief Snapshot passed to the progress callback
+     */
+    struct GrepProgress
+    {
+        std::size_t filesDone = 0;
+        std::size_t fileCount = 0;
+        std::uint64_t bytesSearched = 0;
+        std::uint64_t totalBytes = 0; // sum of LogFile::size
+        std::size_t hits = 0;
+    };
+
+    /**
+     * @brief Receives hits in batches; each file's hits arrive in order, files interleave
+     */
+    using GrepHitCallback = std::function<void(const std::vector<GrepHit> &)>;
+
+    /**
+     * @brief Progress callback; called when a file (or a slice of a large one) is done
+     */
+    using GrepProgressCallback = std::function<void(const GrepProgress &)>;
+
+    struct GrepOptions
+    {
+        unsigned threads = 0;         // 0 = hardware concurrency
+        std::size_t maxHits = 100000; // the search stops once this many lines matched
+        GrepHitCallback onHits;       // both callbacks run on worker threads, one call at a time
+        GrepProgressCallback onProgress;
+        const std::atomic<bool> *cancel = nullptr; // set it to stop early
+    };
+
+    struct GrepStats
+    {
+        std::size_t filesSearched = 0;
+        std::size_t filesWithHits = 0;
+        std::size_t filesFailed = 0; // could not be mapped
+        std::uint64_t bytesSearched = 0;
+        std::size_t hits = 0;
+        std::size_t clippedLines = 0; // regex only: lines searched just in their first TextMatcher::kMaxRegexLineBytes
+        bool truncated = false;       // stopped at maxHits
+        bool cancelled = false;
+        double seconds = 0;
+    };
+
+    /**
+     * @brief Searches log files in parallel for lines matching a pattern
+     *
+     * Every file is memory-mapped and scanned with TextMatcher. Files larger
+     * than a few megabytes are split at line boundaries into slices that run
+     * as separate tasks on a work-stealing pool, so a handful of huge logs
+     * keeps every core busy just like thousands of small ones do.
+     *
+     * @param logFiles Files to search, e.g. from findGameLogs
+     * @param matcher Compiled pattern
+     * @param options Threads, limits, callbacks and cancellation
+     * @return Totals for the whole search
+     */
+    GrepStats grepLogs(const std::vector<LogFile> &logFiles, const TextMatcher &matcher, const GrepOptions &options);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "content_store.hpp"
+#include "file_follower.hpp"
+#include "line_index.hpp"
+#include "mapped_file.hpp"
+#include "text_search.hpp"
+
+namespace SteamUtils
+{
+    /**
+     * @brief What LogView::follow() found
+     */
+    enum class FollowUpdate
+    {
+        None,
+        Appended,  // new lines were added at the end
+        Truncated, // the file shrank (rewritten in place) and was reloaded
+        Replaced   // a new file took the name (log rotation) and was loaded
+    };
+
+    /**
+     * @brief A log file mapped into memory with an index of where each line starts
+     *
+     * open() only maps the file; the line index is built on a worker thread and
+     * lines become readable as it goes, so even multi-GB files show their first
+     * screen immediately. Looking up any indexed line is O(1).
+     *
+     * While following, appended bytes are mapped in and only they are indexed.
+     * A file truncated in place is only noticed at the next follow() call;
+     * until then its lost pages read as zeros (see MappedFile), so lines and
+     * the workers stay safe but may show blanks. Growth is only trusted when
+     * the first and last few KB already shown are unchanged, so a truncation
+     * followed by new writes past the old size is still reloaded.
+     * A search keeps running across follow() updates and covers new lines too.
+     */
+    class LogView
+    {
+    public:
+        LogView() = default;
+        ~LogView() { close(); }
+
+        LogView(const LogView &) = delete;
+        LogView &operator=(const LogView &) = delete;
+
+        /**
+         * @brief Maps a file and starts indexing it, replacing the one currently open
+         * @return False if the file cannot be mapped
+         */
+        [[nodiscard]] bool open(const std::filesystem::path &path);
+
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept { return file_.isOpen(); }
+        [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+        [[nodiscard]] std::size_t size() const noexcept { return file_.size(); }
+
+        /**
+         * @brief Lines indexed so far; grows until isIndexed()
+         */
+        [[nodiscard]] std::size_t lineCount() const noexcept { return index_.lineCount(); }
+        [[nodiscard]] bool isIndexed() const noexcept { return index_.isComplete(); }
+        [[nodiscard]] std::size_t indexedBytes() const noexcept { return index_.indexedBytes(); }
+
+        /**
+         * @brief Text of a line without its "\n" or "\r\n" terminator
+         * @param index Line number, from 0 to lineCount() - 1
+         */
+        [[nodiscard]] std::string_view line(std::size_t index) const noexcept;
+
+        /**
+         * @brief Byte offset of the first character of a line
+         * @param index Line number, from 0 to lineCount() - 1
+         */
+        [[nodiscard]] std::uint64_t lineOffset(std::size_t index) const noexcept { return index_.lineStart(index); }
+
+        /**
+         * @brief Line holding a byte offset, among the lines indexed so far
+         */
+        [[nodiscard]] std::size_t lineAt(std::uint64_t offset) const noexcept;
+
+        /**
+         * @brief Searches the file on a worker thread, replacing the previous search
+         * @return False if the pattern is empty or not a valid regex (see search().matcher().error())
+         */
+        bool startSearch(std::string pattern, SearchOptions options);
+        void clearSearch() noexcept { search_.cancel(); }
+        [[nodiscard]] const TextSearch &search() const noexcept { return search_; }
+
+        /**
+         * @brief Starts or stops watching the open file for changes
+         */
+        void setFollowing(bool following);
+        [[nodiscard]] bool isFollowing() const noexcept { return follower_.isRunning(); }
+
+        /**
+         * @brief Applies whatever happened to the file since the last call; cheap when nothing did
+         * @return What changed; the view may have been closed if a replaced file could not be opened
+         */
+        FollowUpdate follow();
+
+    private:
+        [[nodiscard]] bool map(const std::filesystem::path &path);
+        FollowUpdate reload(FollowUpdate update);
+        void rememberWindows();
+        [[nodiscard]] bool windowsMatch(const MappedFile &file) const;
+
+        MappedFile file_;
+        std::filesystem::path path_;
+        LineIndex index_;
+        TextSearch search_;
+        FileStamp stamp_{};
+        FileFollower follower_;
+        bool followPending_ = false; // growth seen while the index was still being built
+        std::string headWindow_;     // copies of the first and last bytes mapped, see windowsMatch()
+        std::string tailWindow_;
+        std::size_t tailOffset_ = 0;
+    };
+}
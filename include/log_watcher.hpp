@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "steam-utils.hpp"
+
+namespace SteamUtils
+{
+    /**
+     * @brief One incremental change applied to a log list by LogWatcher::poll
+     */
+    struct LogChange
+    {
+        enum class Kind
+        {
+            Added,    // appended at index
+            Modified, // size/lastModifiedNs refreshed in place at index
+            Removed   // erased from index (indices after it shift down by one)
+        };
+
+        Kind kind;
+        std::size_t index;
+        fs::path path;
+    };
+
+    /**
+     * @brief Keeps a findGameLogs result current by watching the scanned directories
+     *
+     * Uses inotify on Linux; elsewhere isSupported() is false and start() fails,
+     * so callers simply keep the snapshot they already have.
+     */
+    class LogWatcher
+    {
+    public:
+        LogWatcher() = default;
+        ~LogWatcher();
+
+        LogWatcher(const LogWatcher &) = delete;
+        LogWatcher &operator=(const LogWatcher &) = delete;
+
+        [[nodiscard]] static bool isSupported() noexcept;
+
+        /**
+         * @brief Registers watches on the directories a scan visited, replacing any previous ones
+         * @param directories Directories reported through ScanOptions::visitedDirectories
+         * @param maxDepth Depth limit of that scan; new subdirectories below it are watched too
+         * @return True if at least one directory is being watched
+         */
+        bool start(const std::vector<VisitedDirectory> &directories, int maxDepth);
+
+        void stop() noexcept;
+
+        [[nodiscard]] bool isRunning() const noexcept { return fd_ >= 0; }
+        [[nodiscard]] std::size_t watchCount() const noexcept { return watches_.size(); }
+
+        /**
+         * @brief Waits for filesystem events and applies them to the log list
+         * @param logFiles Log list to update (adds, in-place size/time updates, removals)
+         * @param timeoutMs Milliseconds to wait for the first event; 0 returns immediately, -1 blocks
+         * @return Changes in the order they were applied
+         */
+        std::vector<LogChange> poll(std::vector<LogFile> &logFiles, int timeoutMs);
+
+    private:
+        struct WatchedDirectory
+        {
+            fs::path path;
+            int depth;
+        };
+
+        void addWatch(const fs::path &directory, int depth);
+        void forgetWatch(std::unordered_map<int, WatchedDirectory>::iterator it);
+        [[nodiscard]] bool isWatched(const fs::path &directory) const;
+
+        int fd_ = -1;
+        int maxDepth_ = 0;
+        std::unordered_map<int, WatchedDirectory> watches_;
+        std::unordered_set<fs::path::string_type> watchedPaths_; // the paths in watches_, for O(1) isWatched()
+    };
+}
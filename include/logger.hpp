@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <ostream>
 #include <string>
 #include <string_view>
 
@@ -12,9 +15,106 @@ enum class SeverityLevel
     Debug
 };
 
+// Compile-time floor for SLC_LOG: calls below it generate no code at all.
+// 0 = Debug, 1 = Info,
+// 2 = Warning, 3 = Err, 4 = Fatal (see Logger::severityRank).
+#ifndef SLC_LOG_MIN_LEVEL
+#define SLC_LOG_MIN_LEVEL 0
+#endif
+
+// Records are queued in a bounded lock-free ring and written by a background
+// thread, so logging never waits for the console. When the ring is full,
+// Info/Warning/Debug records are dropped (and counted); Err and Fatal wait
+// for room. Fatal records are flushed before log() returns.
 namespace Logger
 {
+    /**
+     * @brief Orders severities from least (Debug) to most (Fatal) important
+     */
+    [[nodiscard]] constexpr int severityRank(SeverityLevel level) noexcept
+    {
+        switch (level)
+        {
+        case SeverityLevel::Debug:
+            return 0;
+        case SeverityLevel::Info:
+            return 1;
+        case SeverityLevel::Warning:
+            return 2;
+        case SeverityLevel::Err:
+            return 3;
+        case SeverityLevel::Fatal:
+            return 4;
+        }
+        return 1;
+    }
+
+    namespace detail
+    {
+        inline std::atomic<int> minimumRank{severityRank(SeverityLevel::Info)};
+    }
+
+    /**
+     * @brief Whether a record of this level would be written (one relaxed load)
+     */
+    [[nodiscard]] inline bool isEnabled(SeverityLevel level) noexcept
+    {
+        int rank = severityRank(level);
+        return rank >= SLC_LOG_MIN_LEVEL && rank >= detail::minimumRank.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets the runtime threshold; records below it are discarded (Info by default)
+     */
+    void setMinimumLevel(SeverityLevel level);
+    [[nodiscard]] SeverityLevel minimumLevel();
+
+    /**
+     * @brief Parses "debug", "info", "warning", "error" or "fatal" (case-insensitive)
+     * @return False if the name is not a level
+     */
+    [[nodiscard]] bool parseLevel(std::string_view name, SeverityLevel &level);
+
+    /**
+     * @brief Upper-case display name of a level ("INFO", "ERROR", ...)
+     */
+    [[nodiscard]] const char *levelName(SeverityLevel level) noexcept;
+
     void log(std::string_view message);
     void log(std::string_view message, SeverityLevel level);
 
+    /**
+     * @brief Blocks until every record logged before the call has been written
+     */
+    void flush();
+
+    /**
+     * @brief Redirects the output (std::cout by default) after flushing pending records
+     * @param out New destination; nullptr discards records
+     */
+    void setOutput(std::ostream *out);
+
+    /**
+     * @brief Number of records dropped so far because the ring was full
+     */
+    [[nodiscard]] std::uint64_t droppedCount();
 }
+
+// Level-checked logging: the message expression is only evaluated when the
+// level is enabled, and generates no code below SLC_LOG_MIN_LEVEL.
+#define SLC_LOG(level, message)                                                \
+    do                                                                         \
+    {                                                                          \
+        if constexpr (::Logger::severityRank(level) >= SLC_LOG_MIN_LEVEL)      \
+        {                                                                      \
+            if (::Logger::isEnabled(level))                                    \
+            {                                                                  \
+                ::Logger::log((message), (level));                             \
+            }                                                                  \
+        }                                                                      \
+    } while (false)
+
+#define SLC_LOG_DEBUG(message) SLC_LOG(SeverityLevel::Debug, message)
+#define SLC_LOG_INFO(message) SLC_LOG(SeverityLevel::Info, message)
+#define SLC_LOG_WARNING(message) SLC_LOG(SeverityLevel::Warning, message)
+#define SLC_LOG_ERROR(message) SLC_LOG(SeverityLevel::Err, message)
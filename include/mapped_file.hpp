@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace SteamUtils
+{
+    /**
+     * @brief Read-only memory mapping of a whole file
+     *
+     * If the file is truncated while mapped, the pages past its new end read
+     * as zeros instead of raising SIGBUS; reopen it to see the new contents.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        /**
+         * @brief Maps the file, replacing any previous mapping
+         * @param path File to map
+         * @return True on success; an empty file maps successfully with size() == 0
+         */
+        [[nodiscard]] bool open(const std::filesystem::path &path);
+
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept { return open_; }
+        [[nodiscard]] const char *data() const noexcept { return data_; }
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    private:
+        const char *data_ = nullptr;
+        std::size_t size_ = 0;
+        bool open_ = false;
+#ifdef _WIN32
+        void *fileHandle_ = nullptr;
+        void *mappingHandle_ = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace SteamUtils
+{
+    /**
+     * @brief Append-only list of file offsets written by one worker thread and read concurrently
+     *
+     * Values live in fixed-size blocks that never move, and the published
+     * count is stored with release semantics after the values, so a reader that
+     * loads size() can read every entry below it without locking.
+     */
+    class PublishedOffsets
+    {
+    public:
+        static constexpr std::size_t kBlockShift = 16;
+        static constexpr std::size_t kBlockSize = std::size_t{1} << kBlockShift; // offsets per block
+        static constexpr std::size_t kMaxBlocks = std::size_t{1} << 16;
+        static constexpr std::size_t kCapacity = kBlockSize * kMaxBlocks; // 2^32 entries
+
+        [[nodiscard]] std::size_t size() const noexcept { return published_.load(std::memory_order_acquire); }
+
+        [[nodiscard]] std::uint64_t operator[](std::size_t index) const noexcept
+        {
+            return blocks_[index >> kBlockShift][index & (kBlockSize - 1)];
+        }
+
+        /**
+         * @brief Adds values and publishes them (writer thread); values past kCapacity are dropped
+         */
+        void append(const std::vector<std::uint64_t> &values)
+        {
+            if (!blocks_)
+            {
+                blocks_.reset(new std::unique_ptr<std::uint64_t[]>[kMaxBlocks]);
+            }
+            std::size_t next = 0;
+            while (next < values.size() && count_ < kCapacity)
+            {
+                const std::size_t block = count_ >> kBlockShift;
+                const std::size_t slot = count_ & (kBlockSize - 1);
+                if (!blocks_[block])
+                {
+                    blocks_[block].reset(new std::uint64_t[kBlockSize]);
+                }
+                const std::size_t n = std::min(values.size() - next, kBlockSize - slot);
+                std::memcpy(blocks_[block].get() + slot, values.data() + next, n * sizeof(std::uint64_t));
+                next += n;
+                count_ += n;
+            }
+            published_.store(count_, std::memory_order_release);
+        }
+
+        /**
+         * @brief Drops entries from `count` on; only while no writer is running and on the reading thread
+         */
+        void truncate(std::size_t count) noexcept
+        {
+            count_ = std::min(count, count_);
+            published_.store(count_, std::memory_order_release);
+        }
+
+        /**
+         * @brief Drops every entry and frees the blocks; only while no writer is running
+         */
+        void clear() noexcept
+        {
+            blocks_.reset();
+            count_ = 0;
+            published_.store(0, std::memory_order_release);
+        }
+
+    private:
+        std::unique_ptr<std::unique_ptr<std::uint64_t[]>[]> blocks_; // allocated on first append
+        std::size_t count_ = 0;                                      // writer side; readers use published_
+        std::atomic<std::size_t> published_{0};
+    };
+}
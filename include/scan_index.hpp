@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace SteamUtils
+{
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief Identity of a directory's contents: changes whenever entries are added, removed or renamed
+     */
+    struct DirectoryStamp
+    {
+        std::int64_t mtimeNs = 0;
+        std::uint64_t inode = 0;
+        std::uint64_t device = 0;
+
+        [[nodiscard]] bool operator==(const DirectoryStamp &other) const noexcept
+        {
+            return mtimeNs == other.mtimeNs && inode == other.inode && device == other.device;
+        }
+    };
+
+    /**
+     * @brief Reads the stamp of a directory with a single stat
+     * @param directory Directory to stat
+     * @param stamp Receives the stamp
+     * @return False if the path does not exist or is not a directory
+     */
+    [[nodiscard]] bool readDirectoryStamp(const fs::path &directory, DirectoryStamp &stamp);
+
+    // On-disk layout. Everything is fixed-size and 8-byte aligned so a mapped
+    // index can be read in place; strings live in one trailing blob.
+
+    struct IndexString
+    {
+        std::uint64_t offset;
+        std::uint32_t length;
+        std::uint32_t reserved;
+    };
+
+    struct IndexDirectory
+    {
+        IndexString path;
+        DirectoryStamp stamp;
+        std::uint32_t firstFile;
+        std::uint32_t fileCount;
+        std::uint32_t firstChild;
+        std::uint32_t childCount;
+    };
+
+    struct IndexHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t directoryCount;
+        std::uint64_t directoriesOffset;
+        std::uint64_t nameCount;
+        std::uint64_t namesOffset;
+        std::uint64_t stringsOffset;
+        std::uint64_t stringsSize;
+    };
+
+    static_assert(std::is_trivially_copyable_v<IndexDirectory> && sizeof(IndexDirectory) % 8 == 0);
+    static_assert(std::is_trivially_copyable_v<IndexHeader> && sizeof(IndexHeader) % 8 == 0);
+
+    /**
+     * @brief Read-only view of a scan index mapped straight from disk
+     *
+     * Directory records are sorted by path; each one lists the names of the
+     * log files and subdirectories that were found in it at the recorded stamp.
+     */
+    class ScanIndex
+    {
+    public:
+        static constexpr char kMagic[8] = {'S', 'L', 'C', 'I', 'D', 'X', '\0', '\0'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        /**
+         * @brief Maps and validates an index file
+         * @param indexPath Path of the index
+         * @return False if the file is missing, truncated or from another version
+         */
+        [[nodiscard]] bool open(const fs::path &indexPath);
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept { return header_ != nullptr; }
+        [[nodiscard]] std::size_t directoryCount() const noexcept { return header_ ? header_->directoryCount : 0; }
+
+        /**
+         * @brief Binary-searches the directory records
+         * @param path Directory path as produced by fs::path::string()
+         * @return Record pointer into the mapping, nullptr if not indexed
+         */
+        [[nodiscard]] const IndexDirectory *findDirectory(std::string_view path) const;
+
+        [[nodiscard]] std::string_view string(const IndexString &s) const noexcept;
+        [[nodiscard]] const IndexString *files(const IndexDirectory &directory) const noexcept;
+        [[nodiscard]] const IndexString *children(const IndexDirectory &directory) const noexcept;
+
+    private:
+        MappedFile file_;
+        const IndexHeader *header_ = nullptr;
+        const IndexDirectory *directories_ = nullptr;
+        const IndexString *names_ = nullptr;
+        const char *strings_ = nullptr;
+    };
+
+    /**
+     * @brief Accumulates directory records during a scan and serializes them to the index layout
+     */
+    class ScanIndexBuilder
+    {
+    public:
+        void addDirectory(std::string path, const DirectoryStamp &stamp, std::vector<std::string> files,
+                          std::vector<std::string> children, bool reused);
+
+        /**
+         * @brief Moves every record of another builder into this one
+         */
+        void merge(ScanIndexBuilder &&other);
+
+        /**
+         * @brief Writes the index atomically (temporary file + rename)
+         * @param indexPath Destination path; parent directories are created
+         * @return True on success
+         */
+        [[nodiscard]] bool write(const fs::path &indexPath);
+
+        [[nodiscard]] std::size_t directoryCount() const noexcept { return entries_.size(); }
+        [[nodiscard]] std::size_t reusedCount() const noexcept { return reused_; }
+
+    private:
+        struct Entry
+        {
+            std::string path;
+            DirectoryStamp stamp;
+            std::vector<std::string> files;
+            std::vector<std::string> children;
+        };
+
+        std::vector<Entry> entries_;
+        std::size_t reused_ = 0;
+    };
+}
@@ -1,12 +1,20 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <filesystem>
+#include <functional>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "content_store.hpp"
+#include "copy_engine.hpp"
+
 namespace SteamUtils
 {
     namespace fs = std::filesystem;
@@ -17,6 +25,23 @@ namespace SteamUtils
      */
     [[nodiscard]] fs::path findSteamDirectory();
 
+    /**
+     * @brief Options for following and stopping findSteamDirectory
+     */
+    struct SteamSearchOptions
+    {
+        // Called before each candidate is checked, with its position among all candidates
+        std::function<void(const fs::path &, std::size_t index, std::size_t count)> onProbe;
+        const std::atomic<bool> *cancel = nullptr; // set it to give up; the result is then empty
+    };
+
+    /**
+     * @brief Finds the Steam installation directory, reporting each location it checks
+     * @param options Progress callback and cancellation flag
+     * @return Path to Steam directory if found, empty path otherwise (or when cancelled)
+     */
+    [[nodiscard]] fs::path findSteamDirectory(const SteamSearchOptions &options);
+
     /**
      * @brief Gets all possible Steam directories locations for the current OS
      * @return Vector of paths where Steam might be installed
@@ -43,6 +68,12 @@ namespace SteamUtils
      */
     [[nodiscard]] fs::path getHomeDirectory();
 
+    /**
+     * @brief Gets the per-user cache directory of the collector
+     * @return Path such as ~/.cache/steam-log-collector, empty if it cannot be determined
+     */
+    [[nodiscard]] fs::path getCacheDirectory();
+
     /**
      * @brief Detects the operating system type
      * @return A string_view representing the OS type (e.g., "Windows", "Linux", "macOS")
@@ -69,14 +100,82 @@ namespace SteamUtils
         std::string name;
         std::string appId;
         std::string installDir;
+        fs::path libraryPath; // library root holding this game's steamapps folder
     };
+
     /**
-     * @brief Gets list of all installed Steam games
+     * @brief Lists every Steam library: the main installation plus the folders in libraryfolders.vdf
+     * @param steamDir Path to the Steam installation directory
+     * @return Existing library roots (each containing a steamapps folder), main installation first
+     */
+    [[nodiscard]] std::vector<fs::path> getLibraryFolders(const fs::path &steamDir);
+
+    /**
+     * @brief Parses steamapps/libraryfolders.vdf
+     * @param vdfPath Path to libraryfolders.vdf
+     * @return Library paths listed in the file, in file order
+     */
+    [[nodiscard]] std::vector<fs::path> parseLibraryFoldersFile(const fs::path &vdfPath);
+
+    /**
+     * @brief Counts and per-phase timings of one getInstalledGames call
+     */
+    struct GameScanStats
+    {
+        std::size_t libraryCount = 0;
+        std::size_t manifestCount = 0;
+        std::size_t gameCount = 0;
+        unsigned threads = 0;   // threads that parsed manifests
+        double libraryMs = 0;   // reading libraryfolders.vdf
+        double enumerateMs = 0; // listing appmanifest_*.acf paths
+        double parseMs = 0;     // parsing manifests into GameInfo slots
+    };
+
+    /**
+     * @brief Running totals passed along with each batch of games getInstalledGames parses
+     */
+    struct GameScanProgress
+    {
+        std::size_t manifestCount = 0; // known once the libraries have been listed
+        std::size_t manifestsParsed = 0;
+        std::size_t gamesFound = 0;
+    };
+
+    /**
+     * @brief Receives the games of one parsed batch of manifests (possibly none), libraryPath included
+     */
+    using GameBatchCallback = std::function<void(const std::vector<GameInfo> &, const GameScanProgress &)>;
+
+    /**
+     * @brief Options controlling how getInstalledGames ingests app manifests
+     */
+    struct GameScanOptions
+    {
+        unsigned threads = 0;           // 0 = hardware concurrency, 1 = parse serially on the calling thread
+        GameScanStats *stats = nullptr; // optional, receives counts and timings
+        GameBatchCallback onGames;      // optional; runs on the parsing threads, one call at a time
+        const std::atomic<bool> *cancel = nullptr; // set it to stop early; the result holds the batches parsed so far
+    };
+
+    /**
+     * @brief Gets list of all installed Steam games across every library folder
      * @param steamDir Path to the Steam installation directory
      * @return Vector of GameInfo structures containing game details
      */
     [[nodiscard]] std::vector<GameInfo> getInstalledGames(const fs::path &steamDir);
 
+    /**
+     * @brief Gets list of all installed Steam games across every library folder
+     *
+     * Manifest paths are collected first, then parsed in batches on a thread
+     * pool into preallocated slots, so the result order matches a serial scan.
+     *
+     * @param steamDir Path to the Steam installation directory
+     * @param options Ingestion options (thread count, optional statistics, progress and cancellation)
+     * @return Vector of GameInfo structures, in library order and by manifest name within a library
+     */
+    [[nodiscard]] std::vector<GameInfo> getInstalledGames(const fs::path &steamDir, const GameScanOptions &options);
+
     /**
      * @brief Parses an ACF file to extract game information
      * @param acfFilePath Path to the .acf file
@@ -97,10 +196,57 @@ namespace SteamUtils
         fs::path path;
         std::string filename;
         std::uintmax_t size;
-        std::string lastModified;
+        std::int64_t lastModifiedNs = 0; // nanoseconds since the Unix epoch; format with formatTimestamp
         std::string type;
     };
 
+    /**
+     * @brief Directory enumeration strategy used by the log walkers
+     */
+    enum class WalkerBackend
+    {
+        Auto,     // Getdents on Linux, Portable elsewhere
+        Portable, // std::filesystem::directory_iterator
+        Getdents  // openat + getdents64, stats only files that pass isLogFile (Linux only)
+    };
+
+    /**
+     * @brief A directory that a scan listed (or replayed from the scan index)
+     */
+    struct VisitedDirectory
+    {
+        fs::path path;
+        int depth; // 0 for a search root
+    };
+
+    /**
+     * @brief Running totals passed along with each batch of a scan in progress
+     */
+    struct ScanProgress
+    {
+        std::size_t directoriesScanned = 0;
+        std::size_t filesFound = 0;
+    };
+
+    /**
+     * @brief Receives the log files of one directory (possibly none) as soon as it has been listed, unsorted
+     */
+    using ScanBatchCallback = std::function<void(const std::vector<LogFile> &, const ScanProgress &)>;
+
+    /**
+     * @brief Options controlling how findGameLogs walks the search roots
+     */
+    struct ScanOptions
+    {
+        unsigned threads = 0; // 0 = hardware concurrency, 1 = serial walk on the calling thread
+        int maxDepth = 3;
+        WalkerBackend backend = WalkerBackend::Auto;
+        bool useIndex = true; // replay unchanged directories from the on-disk scan index
+        std::vector<VisitedDirectory> *visitedDirectories = nullptr; // optional, receives every directory visited
+        ScanBatchCallback onFiles; // optional; runs on the scanning threads, one call at a time
+        const std::atomic<bool> *cancel = nullptr; // set it to stop early; the partial result skips the index update
+    };
+
     /**
      * @brief Finds all log files for a specific game
      * @param steamDir Path to Steam installation directory
@@ -109,6 +255,16 @@ namespace SteamUtils
      */
     [[nodiscard]] std::vector<LogFile> findGameLogs(const fs::path &steamDir, const GameInfo &game);
 
+    /**
+     * @brief Finds all log files for a specific game
+     * @param steamDir Path to Steam installation directory
+     * @param game GameInfo structure for the target game
+     * @param options Scan options (thread count, recursion depth, progress and cancellation)
+     * @return Vector of LogFile structures, sorted newest first and by path on ties
+     */
+    [[nodiscard]] std::vector<LogFile> findGameLogs(const fs::path &steamDir, const GameInfo &game,
+                                                    const ScanOptions &options);
+
     /**
      * @brief Common log file extensions
      */
@@ -116,6 +272,13 @@ namespace SteamUtils
         ".log", ".txt", ".out", ".err", ".crash", ".dmp", ".mdmp", ".rpt",
         ".debug", ".trace", ".console", ".output", ".error"};
 
+    /**
+     * @brief Name fragments that mark a file as a log wherever they appear
+     */
+    inline constexpr std::array<std::string_view, 11> logFilePatterns = {
+        "log", "crash", "error", "debug", "console", "output",
+        "stderr", "stdout", "trace", "dump", "report"};
+
     /**
      * @brief Checks if a file is likely a log file based on name and extension
      * @param filename Name of the file to check
@@ -123,6 +286,13 @@ namespace SteamUtils
      */
     [[nodiscard]] bool isLogFile(std::string_view filename);
 
+    /**
+     * @brief Determines the log category of a file from its name
+     * @param filename Name of the file
+     * @return One of "crash_log", "error_log", "debug_log", "console_log" or "game_log"
+     */
+    [[nodiscard]] std::string getLogFileType(std::string_view filename);
+
     /**
      * @brief Recursively searches for log files in a directory
      * @param directory Directory to search
@@ -148,6 +318,31 @@ namespace SteamUtils
      */
     [[nodiscard]] std::string formatFileTime(const fs::path &filePath);
 
+    /**
+     * @brief Formats a time as local "YYYY-MM-DD HH:MM:SS"
+     * @param time Seconds since the Unix epoch
+     * @return Formatted date/time string
+     */
+    [[nodiscard]] std::string formatLocalTime(std::time_t time);
+
+    /**
+     * @brief Formats a timestamp as local "YYYY-MM-DD HH:MM:SS"
+     *
+     * The local-time conversion is cached per minute (per thread), so formatting
+     * many timestamps from the same minutes rarely calls localtime.
+     *
+     * @param epochNs Nanoseconds since the Unix epoch
+     * @return Formatted date/time string
+     */
+    [[nodiscard]] std::string formatTimestamp(std::int64_t epochNs);
+
+    /**
+     * @brief Converts a filesystem timestamp to nanoseconds since the Unix epoch
+     * @param time Value from fs::last_write_time or a directory entry
+     * @return Nanoseconds since the Unix epoch
+     */
+    [[nodiscard]] std::int64_t toEpochNs(fs::file_time_type time);
+
     /**
      * @brief Creates the output directory for copied logs
      * @param gameName Name of the game
@@ -155,6 +350,22 @@ namespace SteamUtils
      */
     [[nodiscard]] fs::path createOutputDirectory(std::string_view gameName);
 
+    /**
+     * @brief Picks the path of a new single-file bundle for a game's logs
+     * @param gameName Name of the game
+     * @return ~/steam-logs/<game>_<timestamp>.slcb, empty path if the steam-logs folder cannot be created
+     */
+    [[nodiscard]] fs::path createOutputBundlePath(std::string_view gameName);
+
+    /**
+     * @brief Streams log files into one indexed bundle file (see BundleReader to read it back)
+     * @param logFiles Vector of log files to store
+     * @param bundlePath Bundle to create
+     * @param gameName Name of the game
+     * @return Number of files stored; 0 if the bundle could not be written
+     */
+    [[nodiscard]] int writeLogBundle(const std::vector<LogFile> &logFiles, const fs::path &bundlePath, std::string_view gameName);
+
     /**
      * @brief Copies log files to the output directory
      * @param logFiles Vector of log files to copy
@@ -165,7 +376,84 @@ namespace SteamUtils
     [[nodiscard]] int copyLogsToDirectory(const std::vector<LogFile> &logFiles, const fs::path &outputDir, std::string_view gameName);
 
     /**
-     * @brief Safely copies a single file
+     * @brief Copies log files to the output directory with the parallel copy engine
+     * @param logFiles Vector of log files to copy
+     * @param outputDir Directory to copy files to
+     * @param gameName Name of the game
+     * @param onProgress Called from the copy threads with per-file and overall progress
+     * @return Number of files successfully copied
+     */
+    [[nodiscard]] int copyLogsToDirectory(const std::vector<LogFile> &logFiles, const fs::path &outputDir, std::string_view gameName,
+                                          const CopyProgressCallback &onProgress);
+
+    struct CollectOptions
+    {
+        // Store each distinct file once in the .store folder next to the output
+        // directory and hardlink it into the collection
+        bool deduplicate = true;
+        CopyProgressCallback onProgress;
+    };
+
+    /**
+     * @brief Copies log files to the output directory, deduplicating them against earlier collections
+     * @param logFiles Vector of log files to copy
+     * @param outputDir Directory to copy files to
+     * @param gameName Name of the game
+     * @param options Deduplication and progress reporting
+     * @return Number of files successfully copied
+     */
+    [[nodiscard]] int copyLogsToDirectory(const std::vector<LogFile> &logFiles, const fs::path &outputDir, std::string_view gameName,
+                                          const CollectOptions &options);
+
+    /**
+     * @brief Removes files from ~/steam-logs/.store that no collection links to any more
+     *
+     * Deleting a collection folder leaves its deduplicated files in the store;
+     * this frees them once nothing else links to them.
+     *
+     * @return What was removed; nothing when there is no store
+     */
+    PruneResult pruneContentStore();
+
+    /**
+     * @brief Outcome counts of one incremental collection
+     */
+    struct IncrementalStats
+    {
+        int newFiles = 0;
+        int appendedFiles = 0;
+        int rewrittenFiles = 0;
+        int unchangedFiles = 0;
+        int failedFiles = 0;
+        std::uintmax_t bytesCopied = 0;
+    };
+
+    /**
+     * @brief Creates (or reuses) the per-game mirror updated by incremental collections
+     * @param gameName Name of the game
+     * @return ~/steam-logs/<game>_incremental, empty path if it cannot be created
+     */
+    [[nodiscard]] fs::path createIncrementalDirectory(std::string_view gameName);
+
+    /**
+     * @brief Brings a mirror directory up to date with the log files, copying only what changed
+     *
+     * Unchanged files are skipped, files that only grew get their new bytes
+     * appended, and new, rotated or rewritten files are copied in full. The
+     * state is kept in a manifest inside the mirror directory.
+     *
+     * @param logFiles Vector of log files to collect
+     * @param mirrorDir Directory from createIncrementalDirectory
+     * @param gameName Name of the game
+     * @param onProgress Called from the copy threads with per-file and overall progress
+     * @param stats Optional, receives what happened to the files
+     * @return Number of files that are up to date in the mirror
+     */
+    [[nodiscard]] int collectLogsIncrementally(const std::vector<LogFile> &logFiles, const fs::path &mirrorDir, std::string_view gameName,
+                                               const CopyProgressCallback &onProgress = {}, IncrementalStats *stats = nullptr);
+
+    /**
+     * @brief Safely copies a single file (reflink, copy_file_range or buffered, whichever works first)
      * @param sourcePath source file path
      * @param destPath destination file path
      * @return True if copy was successful, false otherwise
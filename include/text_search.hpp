@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "published_offsets.hpp"
+
+namespace SteamUtils
+{
+    struct SearchOptions
+    {
+        bool ignoreCase = true; // ASCII case folding for plain text; std::regex::icase for regexes
+        bool regex = false;     // ECMAScript syntax, matched one line at a time
+    };
+
+    /**
+     * @brief A compiled search pattern; const member functions may be used from several threads at once
+     *
+     * Plain text is found with a vectorized first/last-byte filter (AVX2 or
+     * SSE2, scalar elsewhere) followed by a full compare of each candidate.
+     */
+    class TextMatcher
+    {
+    public:
+        /**
+         * @brief Regexes only see this many bytes of each line
+         *
+         * std::regex backtracks recursively, one stack frame per character, so
+         * a single long line (crash dumps, binary junk) would overflow the
+         * stack and take far too long; the rest of such a line is not searched.
+         */
+        static constexpr std::size_t kMaxRegexLineBytes = 2 * 1024;
+
+        /**
+         * @brief Prepares a pattern
+         * @return False for an empty pattern or an invalid regex (see error())
+         */
+        [[nodiscard]] bool compile(std::string pattern, SearchOptions options);
+
+        [[nodiscard]] const std::string &pattern() const noexcept { return pattern_; }
+        [[nodiscard]] const SearchOptions &options() const noexcept { return options_; }
+        [[nodiscard]] const std::string &error() const noexcept { return error_; }
+
+        /**
+         * @brief Appends base + offset of each match starting in data, without overlaps, until out holds `limit` entries
+         *
+         * Plain text matches must lie wholly inside data. Regexes are tried
+         * against each line, so data should end at a line boundary.
+         * @param cancel Checked between lines of a regex search, which can be slow; the result is partial once it is set
+         * @param clippedLines Optional, incremented for every line a regex only saw the first kMaxRegexLineBytes of
+         * @return Offset just past the last match found (0 if none), to continue without overlapping it
+         */
+        std::size_t findAll(const char *data, std::size_t size, std::uint64_t base, std::vector<std::uint64_t> &out,
+                            std::size_t limit, const std::atomic<bool> *cancel = nullptr,
+                            std::size_t *clippedLines = nullptr) const;
+
+        /**
+         * @brief Length of the match starting at data (for highlighting); 0 if there is none
+         *
+         * A regex is given at most kMaxRegexLineBytes from data.
+         */
+        [[nodiscard]] std::size_t matchLength(const char *data, std::size_t size) const;
+
+    private:
+        std::string pattern_;
+        std::string folded_; // pattern_ lower-cased when ignoring case
+        SearchOptions options_;
+        std::string error_;
+        std::unique_ptr<std::regex> regex_;
+    };
+
+    /**
+     * @brief Searches a buffer on a worker thread, publishing match offsets as they are found
+     *
+     * Starting a new search cancels the running one; the worker checks for
+     * that between 1 MB slices, so each keystroke of an incremental search
+     * only waits a moment. Matches are readable while the search runs.
+     */
+    class TextSearch
+    {
+    public:
+        static constexpr std::size_t kMaxMatches = 1000000;
+
+        TextSearch() = default;
+        ~TextSearch();
+
+        TextSearch(const TextSearch &) = delete;
+        TextSearch &operator=(const TextSearch &) = delete;
+
+        /**
+         * @brief Starts searching, replacing any previous search
+         * @param data Must stay valid until cancel(), resume() or the destructor returns
+         * @return False if the pattern does not compile (see matcher().error())
+         */
+        [[nodiscard]] bool start(const char *data, std::size_t size, std::string pattern, SearchOptions options);
+
+        /**
+         * @brief Continues the current search over bytes appended to the buffer (which may have been remapped)
+         *
+         * Matches that could change with the new bytes (a partial last line, a
+         * pattern cut off at the old end) are withdrawn and searched again.
+         * Call pause() before the old buffer goes away, and call both from the
+         * thread that reads the results.
+         */
+        void resume(const char *data, std::size_t size);
+
+        /**
+         * @brief Stops the worker but keeps the pattern and the matches so far; resume() carries on
+         */
+        void pause() noexcept;
+
+        /**
+         * @brief Stops the worker and forgets the pattern and its matches
+         */
+        void cancel() noexcept;
+
+        [[nodiscard]] bool isActive() const noexcept { return active_; }
+        [[nodiscard]] const TextMatcher &matcher() const noexcept { return matcher_; }
+
+        [[nodiscard]] std::size_t matchCount() const noexcept { return matches_.size(); }
+        [[nodiscard]] std::uint64_t match(std::size_t index) const noexcept { return matches_[index]; }
+
+        /**
+         * @brief Index of the first match at or after a byte offset; matchCount() if there is none yet
+         */
+        [[nodiscard]] std::size_t firstMatchFrom(std::uint64_t offset) const noexcept;
+
+        [[nodiscard]] std::size_t searchedBytes() const noexcept { return searched_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Lines so far that were too long for a regex to search all of (see TextMatcher::kMaxRegexLineBytes)
+         */
+        [[nodiscard]] std::size_t clippedLines() const noexcept { return clippedLines_.load(std::memory_order_relaxed); }
+        [[nodiscard]] bool isComplete() const noexcept { return complete_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Whether the search stopped at kMaxMatches
+         */
+        [[nodiscard]] bool isTruncated() const noexcept { return matchCount() >= kMaxMatches; }
+
+    private:
+        void launch(const char *data, std::size_t begin, std::size_t size);
+        void run(const char *data, std::size_t begin, std::size_t size);
+
+        TextMatcher matcher_;
+        PublishedOffsets matches_;
+        std::size_t resumeFrom_ = 0; // every match starting before this is final; written by the worker
+        bool active_ = false;
+        std::atomic<std::size_t> searched_{0};
+        std::atomic<std::size_t> clippedLines_{0};
+        std::atomic<bool> complete_{false};
+        std::atomic<bool> cancel_{false};
+        std::thread worker_;
+    };
+}
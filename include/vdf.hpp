@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace SteamUtils
+{
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief One node of a text KeyValues (VDF/ACF) document
+     *
+     * A node is either a leaf ("key" "value") or a block ("key" { ... }).
+     * Keys and values point into the source buffer, or into the document's
+     * arena when escape sequences had to be decoded.
+     */
+    struct KeyValue
+    {
+        std::string_view key;
+        std::string_view value;
+        const KeyValue *firstChild = nullptr;
+        const KeyValue *nextSibling = nullptr;
+        bool isBlock = false;
+
+        class ChildIterator
+        {
+        public:
+            explicit ChildIterator(const KeyValue *node) noexcept : node_(node) {}
+            const KeyValue &operator*() const noexcept { return *node_; }
+            const KeyValue *operator->() const noexcept { return node_; }
+            ChildIterator &operator++() noexcept
+            {
+                node_ = node_->nextSibling;
+                return *this;
+            }
+            bool operator!=(const ChildIterator &other) const noexcept { return node_ != other.node_; }
+
+        private:
+            const KeyValue *node_;
+        };
+
+        struct ChildRange
+        {
+            const KeyValue *first;
+            ChildIterator begin() const noexcept { return ChildIterator(first); }
+            ChildIterator end() const noexcept { return ChildIterator(nullptr); }
+        };
+
+        [[nodiscard]] ChildRange children() const noexcept { return ChildRange{firstChild}; }
+
+        /**
+         * @brief Finds a direct child by key, case-insensitively as Steam does
+         * @return The first matching child, nullptr if there is none
+         */
+        [[nodiscard]] const KeyValue *find(std::string_view childKey) const noexcept;
+
+        /**
+         * @brief Gets the value of a direct leaf child
+         * @return The value, or an empty view if the child is missing or a block
+         */
+        [[nodiscard]] std::string_view get(std::string_view childKey) const noexcept;
+    };
+
+    /**
+     * @brief Parsed text KeyValues document
+     *
+     * Nodes are bump-allocated from an arena owned by the document, so a parse
+     * performs a handful of block allocations regardless of the number of keys.
+     * Views stay valid for the lifetime of the document (and of the buffer
+     * passed to parse()).
+     */
+    class KeyValuesDocument
+    {
+    public:
+        KeyValuesDocument() = default;
+
+        KeyValuesDocument(const KeyValuesDocument &) = delete;
+        KeyValuesDocument &operator=(const KeyValuesDocument &) = delete;
+        KeyValuesDocument(KeyValuesDocument &&) noexcept = default;
+        KeyValuesDocument &operator=(KeyValuesDocument &&) noexcept = default;
+
+        /**
+         * @brief Parses a buffer in place; the buffer must outlive the document
+         * @param text Document text
+         * @return False on a syntax error (see error()); nodes parsed so far stay readable
+         */
+        bool parse(std::string_view text);
+
+        /**
+         * @brief Loads a file (read for small files, mapped for large ones) and parses it
+         * @param path File to parse
+         * @return False if the file cannot be mapped or has a syntax error
+         */
+        bool parseFile(const fs::path &path);
+
+        /**
+         * @brief Synthetic root block whose children are the top-level keys
+         */
+        [[nodiscard]] const KeyValue &root() const noexcept { return root_; }
+
+        [[nodiscard]] const std::string &error() const noexcept { return error_; }
+
+    private:
+        void reset();
+        [[nodiscard]] void *allocate(std::size_t size, std::size_t alignment);
+        [[nodiscard]] KeyValue *newNode();
+        [[nodiscard]] std::string_view decodeEscapes(std::string_view raw);
+
+        static constexpr std::size_t kArenaBlockSize = 4096;
+        static constexpr std::uintmax_t kMapThreshold = 256 * 1024;
+
+        MappedFile file_;
+        std::string buffer_;
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char *cursor_ = nullptr;
+        std::size_t remaining_ = 0;
+        KeyValue root_;
+        std::string error_;
+    };
+}
@@ -3,3 +3,19 @@
 #include "app_state.hpp"
 
 void RenderWelcomeScreen(AppState &state);
+
+/**
+ * @brief Follows the background Steam detection: switches to the game list once Steam is found,
+ *        moves newly parsed games into state.games and wraps up finished runs; call every frame
+ */
+void UpdateSteamDiscovery(AppState &state);
+
+/**
+ * @brief Stops parsing manifests but keeps the games found so far
+ */
+void StopLoadingGames(AppState &state);
+
+/**
+ * @brief Drops the current detection run without waiting for it; whatever it still finds is ignored
+ */
+void AbandonSteamDiscovery(AppState &state);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SteamUtils
+{
+    /**
+     * @brief Fixed-size thread pool where every worker owns a task deque
+     *
+     * Workers pop their own tasks LIFO and steal from the front of other
+     * workers' deques when idle. Tasks submitted from inside a worker land in
+     * that worker's deque, so recursive work (e.g. directory trees) stays local
+     * until someone else runs dry.
+     */
+    class WorkStealingPool
+    {
+    public:
+        using Task = std::function<void(std::size_t workerIndex)>;
+
+        /**
+         * @brief Starts the worker threads
+         * @param threadCount Number of workers, 0 uses the hardware concurrency
+         */
+        explicit WorkStealingPool(std::size_t threadCount = 0);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        /**
+         * @brief Queues a task; the task receives the index of the worker running it
+         * @param task Task to run
+         */
+        void submit(Task task);
+
+        /**
+         * @brief Blocks until every submitted task, including tasks they spawned, has finished
+         */
+        void wait();
+
+        [[nodiscard]] std::size_t size() const noexcept { return workers_.size(); }
+
+    private:
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        [[nodiscard]] bool popLocal(std::size_t index, Task &task);
+        [[nodiscard]] bool steal(std::size_t thief, Task &task);
+        void run(std::size_t index);
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> threads_;
+
+        std::atomic<std::size_t> queued_{0};
+        std::atomic<std::size_t> pending_{0};
+        std::atomic<std::size_t> nextWorker_{0};
+
+        std::mutex sleepMutex_;
+        std::condition_variable workAvailable_;
+        std::condition_variable allDone_;
+        bool stopping_ = false;
+    };
+}
@@ -0,0 +1,424 @@
+#include "binary_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace BinaryLog
+{
+    namespace
+    {
+        constexpr std::size_t kCapacity = 8192; // records; must be a power of two
+        constexpr std::size_t kBatchSize = 1024;
+        constexpr std::size_t kInlineTextBytes = 400; // per slot, shared by both string fields
+        constexpr std::size_t kMaxInternedStrings = 16384;
+        constexpr std::size_t kMaxInternedBytes = 4 * 1024 * 1024;
+        // Marks a string field whose text sits in the slot; the writer gives it a real id
+        constexpr std::uint32_t kInlineStringId = 0xFFFFFFFFu;
+        constexpr auto kIdleWait = std::chrono::milliseconds(50);
+
+        static_assert((kCapacity & (kCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+        std::atomic<std::uint32_t> nextThreadNumber{1};
+
+        std::uint32_t threadNumber() noexcept
+        {
+            thread_local const std::uint32_t number = nextThreadNumber.fetch_add(1, std::memory_order_relaxed);
+            return number;
+        }
+
+        std::int64_t nowNs() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        struct Slot
+        {
+            std::atomic<std::uint64_t> sequence{0};
+            BinaryLogRecord record;
+            std::uint16_t textLengths[2];
+            char text[kInlineTextBytes];
+        };
+
+        /**
+         * Same bounded multi-producer ring as the text logger, holding fixed-size
+         * records and their inline text, plus a capped table of interned strings
+         * guarded by a mutex. Only intern() takes that lock, and each thread
+         * remembers the last string it interned, so a run of files from one
+         * directory does not touch it at all.
+         */
+        class Sink
+        {
+        public:
+            ~Sink() { close(); }
+
+            bool open(const fs::path &path)
+            {
+                std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+                if (file_ != nullptr)
+                {
+                    return false;
+                }
+
+#ifdef _WIN32
+                std::FILE *file = _wfopen(path.c_str(), L"wb");
+#else
+                std::FILE *file = std::fopen(path.c_str(), "wb");
+#endif
+                if (file == nullptr)
+                {
+                    return false;
+                }
+
+                BinaryLogHeader header{};
+                std::memcpy(header.magic, kMagic, sizeof(header.magic));
+                header.version = kVersion;
+                header.recordSize = sizeof(BinaryLogRecord);
+                header.startNs = nowNs();
+                if (std::fwrite(&header, sizeof(header), 1, file) != 1)
+                {
+                    std::fclose(file);
+                    return false;
+                }
+
+                // Allocated on first use so a process that never records events does not pay for it
+                if (ring_ == nullptr)
+                {
+                    ring_.reset(new Slot[kCapacity]);
+                    for (std::size_t i = 0; i < kCapacity; ++i)
+                    {
+                        ring_[i].sequence.store(i, std::memory_order_relaxed);
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(stringMutex_);
+                    stringIds_.clear();
+                    stringStorage_.clear();
+                    internedBytes_ = 0;
+                    pendingStrings_.clear();
+                    pendingStringCount_ = 0;
+                    nextStringId_.store(1, std::memory_order_relaxed);
+                    generation_.fetch_add(1, std::memory_order_relaxed);
+                }
+                file_ = file;
+                stopping_ = false;
+                writer_ = std::thread([this]
+                                      { run(); });
+                detail::enabled.store(true, std::memory_order_release);
+                return true;
+            }
+
+            void close()
+            {
+                std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+                if (file_ == nullptr)
+                {
+                    return;
+                }
+
+                detail::enabled.store(false, std::memory_order_release);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                wakeCv_.notify_one();
+                writer_.join();
+                std::fclose(file_);
+                file_ = nullptr;
+            }
+
+            void push(Event event, SeverityLevel level, std::uint64_t v0, std::uint64_t v1, std::uint64_t v2,
+                      const StringArg &s0, const StringArg &s1) noexcept
+            {
+                std::uint64_t position = enqueuePos_.load(std::memory_order_relaxed);
+                Slot *slot = nullptr;
+                while (true)
+                {
+                    slot = &ring_[position & (kCapacity - 1)];
+                    std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::int64_t>(sequence - position);
+                    if (diff == 0)
+                    {
+                        if (enqueuePos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    else
+                    {
+                        position = enqueuePos_.load(std::memory_order_relaxed);
+                    }
+                }
+
+                BinaryLogRecord &record = slot->record;
+                record.timeNs = nowNs();
+                record.event = static_cast<std::uint16_t>(event);
+                record.level = static_cast<std::uint8_t>(level);
+                record.reserved = 0;
+                record.thread = threadNumber();
+                record.values[0] = v0;
+                record.values[1] = v1;
+                record.values[2] = v2;
+
+                // The first field gets what it needs, as long as at least half the slot is left for the second
+                const std::size_t secondWanted = s1.isText ? std::min(s1.text.size(), kInlineTextBytes / 2) : 0;
+                const std::size_t firstLength = s0.isText ? std::min(s0.text.size(), kInlineTextBytes - secondWanted) : 0;
+                const std::size_t secondLength = s1.isText ? std::min(s1.text.size(), kInlineTextBytes - firstLength) : 0;
+                record.strings[0] = s0.isText ? kInlineStringId : s0.id;
+                record.strings[1] = s1.isText ? kInlineStringId : s1.id;
+                slot->textLengths[0] = static_cast<std::uint16_t>(firstLength);
+                slot->textLengths[1] = static_cast<std::uint16_t>(secondLength);
+                std::memcpy(slot->text, s0.text.data(), firstLength);
+                std::memcpy(slot->text + firstLength, s1.text.data(), secondLength);
+                slot->sequence.store(position + 1, std::memory_order_release);
+            }
+
+            StringArg intern(std::string_view text)
+            {
+                struct LastInterned
+                {
+                    std::uint64_t generation = 0;
+                    std::string text;
+                    std::uint32_t id = 0;
+                };
+                thread_local LastInterned last;
+
+                const std::uint64_t generation = generation_.load(std::memory_order_relaxed);
+                if (last.generation == generation && last.text == text)
+                {
+                    return interned(last.id);
+                }
+
+                std::lock_guard<std::mutex> lock(stringMutex_);
+                std::uint32_t id = 0;
+                auto it = stringIds_.find(text);
+                if (it != stringIds_.end())
+                {
+                    id = it->second;
+                }
+                else if (stringIds_.size() >= kMaxInternedStrings || internedBytes_ + text.size() > kMaxInternedBytes)
+                {
+                    return StringArg(text);
+                }
+                else
+                {
+                    id = addString(text);
+                }
+
+                last.generation = generation;
+                last.text.assign(text);
+                last.id = id;
+                return interned(id);
+            }
+
+        private:
+            [[nodiscard]] static StringArg interned(std::uint32_t id) noexcept
+            {
+                StringArg arg;
+                arg.id = id;
+                return arg;
+            }
+
+            std::uint32_t addString(std::string_view text)
+            {
+                std::uint32_t id = nextStringId_.fetch_add(1, std::memory_order_relaxed);
+                stringIds_.emplace(stringStorage_.emplace_back(text), id);
+                internedBytes_ += text.size();
+
+                auto length = static_cast<std::uint32_t>(text.size());
+                pendingStrings_.append(reinterpret_cast<const char *>(&id), sizeof(id));
+                pendingStrings_.append(reinterpret_cast<const char *>(&length), sizeof(length));
+                pendingStrings_.append(text);
+                pendingStringCount_++;
+                return id;
+            }
+
+            // Gives the inline text of a slot its id (one string-block entry per use, never kept in memory)
+            void takeInlineText(const Slot &slot, BinaryLogRecord &record, std::string &strings, std::uint32_t &count)
+            {
+                const char *text = slot.text;
+                for (int i = 0; i < 2; ++i)
+                {
+                    if (record.strings[i] != kInlineStringId)
+                    {
+                        continue;
+                    }
+                    std::uint32_t id = nextStringId_.fetch_add(1, std::memory_order_relaxed);
+                    std::uint32_t length = slot.textLengths[i];
+                    strings.append(reinterpret_cast<const char *>(&id), sizeof(id));
+                    strings.append(reinterpret_cast<const char *>(&length), sizeof(length));
+                    strings.append(text, length);
+                    text += length;
+                    record.strings[i] = id;
+                    count++;
+                }
+            }
+
+            [[nodiscard]] bool hasPending() const noexcept
+            {
+                const Slot &slot = ring_[dequeuePos_ & (kCapacity - 1)];
+                return slot.sequence.load(std::memory_order_acquire) == dequeuePos_ + 1;
+            }
+
+            void writeBlock(std::uint32_t kind, std::uint32_t count, const void *data, std::size_t bytes)
+            {
+                if (count == 0)
+                {
+                    return;
+                }
+                BinaryLogBlockHeader header{kind, count, bytes};
+                std::fwrite(&header, sizeof(header), 1, file_);
+                std::fwrite(data, 1, bytes, file_);
+            }
+
+            void run()
+            {
+                std::vector<BinaryLogRecord> batch;
+                batch.reserve(kBatchSize + 1);
+                std::string strings;
+                std::string inlineStrings;
+                std::uint64_t reportedDrops = 0;
+
+                while (true)
+                {
+                    batch.clear();
+                    inlineStrings.clear();
+                    std::uint32_t inlineCount = 0;
+                    while (batch.size() < kBatchSize && hasPending())
+                    {
+                        Slot &slot = ring_[dequeuePos_ & (kCapacity - 1)];
+                        batch.push_back(slot.record);
+                        takeInlineText(slot, batch.back(), inlineStrings, inlineCount);
+                        slot.sequence.store(dequeuePos_ + kCapacity, std::memory_order_release);
+                        ++dequeuePos_;
+                    }
+
+                    std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+                    if (dropped != reportedDrops)
+                    {
+                        BinaryLogRecord notice{};
+                        notice.timeNs = nowNs();
+                        notice.event = static_cast<std::uint16_t>(Event::Dropped);
+                        notice.level = static_cast<std::uint8_t>(SeverityLevel::Warning);
+                        notice.values[0] = dropped - reportedDrops;
+                        batch.push_back(notice);
+                        reportedDrops = dropped;
+                    }
+
+                    // Strings go out before the records that may reference them
+                    std::uint32_t stringCount = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(stringMutex_);
+                        strings.swap(pendingStrings_);
+                        stringCount = pendingStringCount_;
+                        pendingStringCount_ = 0;
+                    }
+                    writeBlock(kStringBlock, stringCount, strings.data(), strings.size());
+                    strings.clear();
+                    writeBlock(kStringBlock, inlineCount, inlineStrings.data(), inlineStrings.size());
+                    writeBlock(kRecordBlock, static_cast<std::uint32_t>(batch.size()), batch.data(),
+                               batch.size() * sizeof(BinaryLogRecord));
+
+                    if (!batch.empty() || stringCount > 0)
+                    {
+                        std::fflush(file_);
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (stopping_)
+                    {
+                        break;
+                    }
+                    wakeCv_.wait_for(lock, kIdleWait, [this]
+                                     { return stopping_; });
+                }
+            }
+
+            std::unique_ptr<Slot[]> ring_;
+            alignas(64) std::atomic<std::uint64_t> enqueuePos_{0};
+            alignas(64) std::uint64_t dequeuePos_ = 0; // writer thread only
+            std::atomic<std::uint64_t> dropped_{0};
+
+            std::mutex lifecycleMutex_;
+            std::FILE *file_ = nullptr;
+            std::thread writer_;
+
+            std::mutex mutex_;
+            std::condition_variable wakeCv_;
+            bool stopping_ = false;
+
+            std::mutex stringMutex_;
+            std::deque<std::string> stringStorage_; // stable addresses for the string_view keys
+            std::unordered_map<std::string_view, std::uint32_t> stringIds_;
+            std::size_t internedBytes_ = 0;
+            std::string pendingStrings_;
+            std::uint32_t pendingStringCount_ = 0;
+            std::atomic<std::uint32_t> nextStringId_{1}; // shared by interned and inline strings
+            std::atomic<std::uint64_t> generation_{0};   // bumped by open(), invalidates per-thread caches
+        };
+
+        Sink &sink()
+        {
+            static Sink instance;
+            return instance;
+        }
+    } // anonymous namespace
+
+    namespace detail
+    {
+        void push(Event event, SeverityLevel level, std::uint64_t v0, std::uint64_t v1, std::uint64_t v2,
+                  const StringArg &s0, const StringArg &s1) noexcept
+        {
+            sink().push(event, level, v0, v1, v2, s0, s1);
+        }
+    }
+
+    bool open(const fs::path &path)
+    {
+        if (!sink().open(path))
+        {
+            Logger::log("Failed to open binary log: " + path.string(), SeverityLevel::Err);
+            return false;
+        }
+        Logger::log("Writing binary diagnostics to: " + path.string(), SeverityLevel::Info);
+        return true;
+    }
+
+    void openFromEnvironment()
+    {
+        const char *path = std::getenv("SLC_BINARY_LOG");
+        if (path != nullptr && *path != '\0')
+        {
+            (void)open(path);
+        }
+    }
+
+    void close()
+    {
+        sink().close();
+    }
+
+    StringArg intern(std::string_view text)
+    {
+        return enabled() ? sink().intern(text) : StringArg{};
+    }
+}
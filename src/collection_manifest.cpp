@@ -0,0 +1,213 @@
+#include "collection_manifest.hpp"
+#include "content_hash.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace SteamUtils
+{
+    namespace
+    {
+        constexpr std::string_view kManifestHeader = "# steam-log-collector manifest v1";
+
+        template <typename T>
+        [[nodiscard]] bool parseField(std::string_view &line, T &value, int base = 10)
+        {
+            auto [end, ec] = std::from_chars(line.data(), line.data() + line.size(), value, base);
+            if (ec != std::errc() || end == line.data() + line.size() || *end != ' ')
+            {
+                return false;
+            }
+            line.remove_prefix(static_cast<std::size_t>(end - line.data()) + 1);
+            return true;
+        }
+
+        [[nodiscard]] bool hashRange(std::ifstream &in, std::uint64_t offset, std::uint64_t length, std::uint64_t &hash)
+        {
+            std::vector<char> buffer(static_cast<std::size_t>(length));
+            in.seekg(static_cast<std::streamoff>(offset));
+            in.read(buffer.data(), static_cast<std::streamsize>(length));
+            if (static_cast<std::uint64_t>(in.gcount()) != length)
+            {
+                return false;
+            }
+            hash = Xxh64::hash(buffer.data(), buffer.size());
+            return true;
+        }
+    } // anonymous namespace
+
+    const char *fileChangeName(FileChange change) noexcept
+    {
+        switch (change)
+        {
+        case FileChange::New:
+            return "new";
+        case FileChange::Unchanged:
+            return "unchanged";
+        case FileChange::Appended:
+            return "appended";
+        case FileChange::Rewritten:
+            return "rewritten";
+        }
+        return "unknown";
+    }
+
+    void CollectionManifest::load(const fs::path &manifestPath)
+    {
+        entries_.clear();
+        names_.clear();
+
+        std::ifstream in(manifestPath);
+        std::string line;
+        if (!in.is_open() || !std::getline(in, line) || line != kManifestHeader)
+        {
+            return;
+        }
+
+        // "<prefixHash> <tailHash> <size> <mtimeNs> <inode> <device> <mirrorName>\t<source>"
+        while (std::getline(in, line))
+        {
+            std::string_view rest = line;
+            ManifestEntry entry;
+            std::size_t tab = std::string_view::npos;
+            if (parseField(rest, entry.prefixHash, 16) && parseField(rest, entry.tailHash, 16) &&
+                parseField(rest, entry.stamp.size) && parseField(rest, entry.stamp.mtimeNs) &&
+                parseField(rest, entry.stamp.inode) && parseField(rest, entry.stamp.device) &&
+                (tab = rest.find('\t')) != std::string_view::npos && tab > 0 && tab + 1 < rest.size())
+            {
+                entry.mirrorName.assign(rest.substr(0, tab));
+                set(std::string(rest.substr(tab + 1)), std::move(entry));
+            }
+        }
+    }
+
+    bool CollectionManifest::save(const fs::path &manifestPath) const
+    {
+        fs::path tempPath = uniqueTempPath(manifestPath);
+        {
+            std::ofstream out(tempPath, std::ios::trunc);
+            if (!out.is_open())
+            {
+                Logger::log("Failed to write collection manifest: " + tempPath.string(), SeverityLevel::Err);
+                return false;
+            }
+            out << kManifestHeader << '\n';
+            for (const auto &[source, entry] : entries_)
+            {
+                out << toHex(entry.prefixHash) << ' ' << toHex(entry.tailHash) << ' ' << entry.stamp.size << ' '
+                    << entry.stamp.mtimeNs << ' ' << entry.stamp.inode << ' ' << entry.stamp.device << ' '
+                    << entry.mirrorName << '\t' << source << '\n';
+            }
+            if (!out.flush())
+            {
+                Logger::log("Failed to write collection manifest: " + tempPath.string(), SeverityLevel::Err);
+                out.close();
+                std::error_code ec;
+                fs::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        fs::rename(tempPath, manifestPath, ec);
+        if (ec)
+        {
+            Logger::log("Failed to move collection manifest into place: " + ec.message(), SeverityLevel::Err);
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    const ManifestEntry *CollectionManifest::find(const std::string &source) const
+    {
+        auto it = entries_.find(source);
+        return it != entries_.end() ? &it->second : nullptr;
+    }
+
+    void CollectionManifest::set(const std::string &source, ManifestEntry entry)
+    {
+        if (source.find_first_of("\t\n") != std::string::npos)
+        {
+            return; // cannot be represented in the line-based manifest
+        }
+        names_.insert(entry.mirrorName);
+        entries_[source] = std::move(entry);
+    }
+
+    std::string CollectionManifest::reserveName(std::string_view sanitizedName)
+    {
+        std::string name(sanitizedName);
+        if (names_.insert(name).second)
+        {
+            return name;
+        }
+
+        fs::path path(name);
+        std::string stem = path.stem().string();
+        std::string extension = path.extension().string();
+        for (int n = 2;; ++n)
+        {
+            name = stem + "_" + std::to_string(n) + extension;
+            if (names_.insert(name).second)
+            {
+                return name;
+            }
+        }
+    }
+
+    FileChange CollectionManifest::classify(const std::string &source, const FileStamp &stamp, const fs::path &mirrorFile) const
+    {
+        const ManifestEntry *entry = find(source);
+        if (entry == nullptr)
+        {
+            return FileChange::New;
+        }
+
+        // The mirror copy must still be exactly what the manifest describes
+        std::error_code ec;
+        std::uintmax_t mirrorSize = fs::file_size(mirrorFile, ec);
+        if (ec || mirrorSize != entry->stamp.size)
+        {
+            return FileChange::Rewritten;
+        }
+
+        if (stamp == entry->stamp)
+        {
+            return FileChange::Unchanged;
+        }
+
+        // A new inode means the log was rotated or replaced; a smaller size means it was truncated
+        if (stamp.inode != entry->stamp.inode || stamp.device != entry->stamp.device || stamp.size < entry->stamp.size)
+        {
+            return FileChange::Rewritten;
+        }
+
+        // Same size with a new mtime is usually a log that was still being written when the stamp was
+        // taken, so the windows decide, just as they do for a log that grew
+        std::uint64_t prefixHash = 0;
+        std::uint64_t tailHash = 0;
+        if (!hashWindows(source, entry->stamp.size, prefixHash, tailHash) || prefixHash != entry->prefixHash ||
+            tailHash != entry->tailHash)
+        {
+            return FileChange::Rewritten;
+        }
+        return stamp.size == entry->stamp.size ? FileChange::Unchanged : FileChange::Appended;
+    }
+
+    bool CollectionManifest::hashWindows(const fs::path &file, std::uint64_t length, std::uint64_t &prefixHash,
+                                         std::uint64_t &tailHash)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open())
+        {
+            return false;
+        }
+        std::uint64_t window = std::min(length, kWindowBytes);
+        return hashRange(in, 0, window, prefixHash) && hashRange(in, length - window, window, tailHash);
+    }
+}
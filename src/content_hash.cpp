@@ -0,0 +1,176 @@
+#include "content_hash.hpp"
+
+#include <cstring>
+
+namespace SteamUtils
+{
+    namespace
+    {
+        constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+        constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+        constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+        [[nodiscard]] inline std::uint64_t rotl(std::uint64_t value, int bits) noexcept
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        // XXH64 is defined on little-endian input words
+        [[nodiscard]] inline std::uint64_t read64(const unsigned char *p) noexcept
+        {
+            std::uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            value = __builtin_bswap64(value);
+#endif
+            return value;
+        }
+
+        [[nodiscard]] inline std::uint32_t read32(const unsigned char *p) noexcept
+        {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            value = __builtin_bswap32(value);
+#endif
+            return value;
+        }
+
+        [[nodiscard]] inline std::uint64_t round(std::uint64_t accumulator, std::uint64_t input) noexcept
+        {
+            accumulator += input * kPrime2;
+            accumulator = rotl(accumulator, 31);
+            return accumulator * kPrime1;
+        }
+
+        [[nodiscard]] inline std::uint64_t mergeRound(std::uint64_t hash, std::uint64_t accumulator) noexcept
+        {
+            hash ^= round(0, accumulator);
+            return hash * kPrime1 + kPrime4;
+        }
+    } // anonymous namespace
+
+    void Xxh64::reset(std::uint64_t seed) noexcept
+    {
+        seed_ = seed;
+        totalLength_ = 0;
+        buffered_ = 0;
+        accumulators_[0] = seed + kPrime1 + kPrime2;
+        accumulators_[1] = seed + kPrime2;
+        accumulators_[2] = seed;
+        accumulators_[3] = seed - kPrime1;
+    }
+
+    void Xxh64::update(const void *data, std::size_t length) noexcept
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        const unsigned char *end = p + length;
+        totalLength_ += length;
+
+        if (buffered_ + length < sizeof(buffer_))
+        {
+            std::memcpy(buffer_ + buffered_, p, length);
+            buffered_ += length;
+            return;
+        }
+
+        if (buffered_ > 0)
+        {
+            std::size_t fill = sizeof(buffer_) - buffered_;
+            std::memcpy(buffer_ + buffered_, p, fill);
+            p += fill;
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                accumulators_[lane] = round(accumulators_[lane], read64(buffer_ + lane * 8));
+            }
+            buffered_ = 0;
+        }
+
+        // Four independent lanes keep the multiplier pipelines busy
+        std::uint64_t v1 = accumulators_[0];
+        std::uint64_t v2 = accumulators_[1];
+        std::uint64_t v3 = accumulators_[2];
+        std::uint64_t v4 = accumulators_[3];
+        while (end - p >= 32)
+        {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+            p += 32;
+        }
+        accumulators_[0] = v1;
+        accumulators_[1] = v2;
+        accumulators_[2] = v3;
+        accumulators_[3] = v4;
+
+        buffered_ = static_cast<std::size_t>(end - p);
+        std::memcpy(buffer_, p, buffered_);
+    }
+
+    std::uint64_t Xxh64::digest() const noexcept
+    {
+        std::uint64_t hash;
+        if (totalLength_ >= 32)
+        {
+            hash = rotl(accumulators_[0], 1) + rotl(accumulators_[1], 7) +
+                   rotl(accumulators_[2], 12) + rotl(accumulators_[3], 18);
+            for (std::uint64_t accumulator : accumulators_)
+            {
+                hash = mergeRound(hash, accumulator);
+            }
+        }
+        else
+        {
+            hash = seed_ + kPrime5;
+        }
+        hash += totalLength_;
+
+        const unsigned char *p = buffer_;
+        const unsigned char *end = buffer_ + buffered_;
+        for (; end - p >= 8; p += 8)
+        {
+            hash ^= round(0, read64(p));
+            hash = rotl(hash, 27) * kPrime1 + kPrime4;
+        }
+        if (end - p >= 4)
+        {
+            hash ^= static_cast<std::uint64_t>(read32(p)) * kPrime1;
+            hash = rotl(hash, 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+        {
+            hash ^= *p * kPrime5;
+            hash = rotl(hash, 11) * kPrime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= kPrime2;
+        hash ^= hash >> 29;
+        hash *= kPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    std::uint64_t Xxh64::hash(const void *data, std::size_t length, std::uint64_t seed) noexcept
+    {
+        Xxh64 state(seed);
+        state.update(data, length);
+        return state.digest();
+    }
+
+    std::string toHex(std::uint64_t hash)
+    {
+        static constexpr char kDigits[] = "0123456789abcdef";
+        std::string text(16, '0');
+        for (int i = 15; i >= 0; --i)
+        {
+            text[static_cast<std::size_t>(i)] = kDigits[hash & 0xF];
+            hash >>= 4;
+        }
+        return text;
+    }
+}
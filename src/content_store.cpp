@@ -0,0 +1,448 @@
+#include "content_store.hpp"
+#include "content_hash.hpp"
+#include "logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <system_error>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        constexpr std::size_t kHashBufferSize = 1024 * 1024;
+        constexpr std::string_view kCacheHeader = "# steam-log-collector stat cache v1";
+        constexpr const char *kCacheFileName = "stat-cache.txt";
+        constexpr std::int64_t kPruneGraceSeconds = 60;
+
+        std::atomic<std::uint64_t> tempCounter{0};
+
+        template <typename T>
+        [[nodiscard]] bool parseField(std::string_view &line, T &value, int base = 10)
+        {
+            auto [end, ec] = std::from_chars(line.data(), line.data() + line.size(), value, base);
+            if (ec != std::errc() || end == line.data() + line.size() || *end != ' ')
+            {
+                return false;
+            }
+            line.remove_prefix(static_cast<std::size_t>(end - line.data()) + 1);
+            return true;
+        }
+
+        /**
+         * Parses one "<hash> <size> <mtimeNs> <inode> <device> <path>" cache line;
+         * false unless every field is complete (a torn or hand-edited line).
+         */
+        [[nodiscard]] bool parseCacheLine(std::string_view line, std::uint64_t &hash, FileStamp &stamp,
+                                          std::string_view &path)
+        {
+            // Hashes are always written as 16 hex digits: a shorter one is a damaged line
+            if (line.size() <= 16 || line[16] != ' ' || !parseField(line, hash, 16) || !parseField(line, stamp.size) ||
+                !parseField(line, stamp.mtimeNs) || !parseField(line, stamp.inode) || !parseField(line, stamp.device))
+            {
+                return false;
+            }
+            if (line.empty() || line.find_first_of(std::string_view("\r\0", 2)) != std::string_view::npos)
+            {
+                return false;
+            }
+            path = line;
+            return true;
+        }
+
+    } // anonymous namespace
+
+    fs::path uniqueTempPath(const fs::path &target)
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+#ifdef _WIN32
+        auto process = ::_getpid();
+#else
+        auto process = ::getpid();
+#endif
+        fs::path path = target;
+        path += "." + std::to_string(process) + "-" + std::to_string(now) + "-" + std::to_string(tempCounter++) + ".tmp";
+        return path;
+    }
+
+    bool readFileStamp(const fs::path &file, FileStamp &stamp)
+    {
+#ifdef _WIN32
+        std::error_code ec;
+        if (!fs::is_regular_file(file, ec))
+        {
+            return false;
+        }
+        stamp.size = fs::file_size(file, ec);
+        auto mtime = fs::last_write_time(file, ec);
+        if (ec)
+        {
+            return false;
+        }
+        stamp.mtimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count();
+        stamp.inode = 0;
+        stamp.device = 0;
+        return true;
+#else
+        struct stat st{};
+        if (::stat(file.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            return false;
+        }
+#ifdef __APPLE__
+        const struct timespec &mtime = st.st_mtimespec;
+#else
+        const struct timespec &mtime = st.st_mtim;
+#endif
+        stamp.size = static_cast<std::uint64_t>(st.st_size);
+        stamp.mtimeNs = static_cast<std::int64_t>(mtime.tv_sec) * 1000000000LL + mtime.tv_nsec;
+        stamp.inode = static_cast<std::uint64_t>(st.st_ino);
+        stamp.device = static_cast<std::uint64_t>(st.st_dev);
+        return true;
+#endif
+    }
+
+    fs::path ContentStore::blobPath(std::uint64_t hash, std::uint64_t size) const
+    {
+        std::string name = toHex(hash);
+        fs::path shard = root_ / name.substr(0, 2);
+        return shard / (name + "-" + std::to_string(size));
+    }
+
+    bool ContentStore::open()
+    {
+        std::error_code ec;
+        fs::create_directories(root_, ec);
+        if (ec || !fs::is_directory(root_, ec))
+        {
+            Logger::log("Failed to create content store: " + root_.string(), SeverityLevel::Err);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache_.clear();
+        dirty_ = false;
+
+        std::ifstream in(root_ / kCacheFileName);
+        std::string line;
+        if (!in.is_open() || !std::getline(in, line) || line != kCacheHeader)
+        {
+            return true; // no cache yet, or an old format: everything gets hashed once
+        }
+
+        std::size_t dropped = 0;
+        while (std::getline(in, line))
+        {
+            CachedHash entry;
+            std::string_view path;
+            if (parseCacheLine(line, entry.hash, entry.stamp, path))
+            {
+                cache_[std::string(path)] = entry;
+            }
+            else
+            {
+                ++dropped;
+            }
+        }
+        if (dropped > 0)
+        {
+            // Rewrite the cache on the next save so the damaged lines are gone for good
+            dirty_ = true;
+            Logger::log("Dropped " + std::to_string(dropped) + " damaged lines from the hash cache",
+                        SeverityLevel::Warning);
+        }
+
+        SLC_LOG_DEBUG("Loaded " + std::to_string(cache_.size()) + " cached file hashes from " + root_.string());
+        return true;
+    }
+
+    bool ContentStore::save()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_)
+        {
+            return true;
+        }
+
+        fs::path cachePath = root_ / kCacheFileName;
+        fs::path tempPath = uniqueTempPath(cachePath);
+        {
+            std::ofstream out(tempPath, std::ios::trunc);
+            if (!out.is_open())
+            {
+                Logger::log("Failed to write hash cache: " + tempPath.string(), SeverityLevel::Warning);
+                return false;
+            }
+            out << kCacheHeader << '\n';
+            for (const auto &[path, entry] : cache_)
+            {
+                out << toHex(entry.hash) << ' ' << entry.stamp.size << ' ' << entry.stamp.mtimeNs << ' '
+                    << entry.stamp.inode << ' ' << entry.stamp.device << ' ' << path << '\n';
+            }
+            if (!out.flush())
+            {
+                Logger::log("Failed to write hash cache: " + tempPath.string(), SeverityLevel::Warning);
+                out.close();
+                std::error_code ec;
+                fs::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        fs::rename(tempPath, cachePath, ec);
+        if (ec)
+        {
+            Logger::log("Failed to move hash cache into place: " + ec.message(), SeverityLevel::Warning);
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        dirty_ = false;
+        return true;
+    }
+
+    PruneResult ContentStore::prune()
+    {
+        PruneResult result;
+        std::unordered_set<std::uint64_t> removedHashes;
+#ifndef _WIN32
+        const std::int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count();
+#endif
+
+        std::error_code ec;
+        for (fs::directory_iterator shard(root_, ec), end; !ec && shard != end; shard.increment(ec))
+        {
+            std::error_code shardEc;
+            if (!shard->is_directory(shardEc))
+            {
+                continue;
+            }
+            for (fs::directory_iterator blob(shard->path(), shardEc); !shardEc && blob != end; blob.increment(shardEc))
+            {
+                // Only "<16 hex digits>-<size>"; temporary files being written are left alone
+                const std::string name = blob->path().filename().string();
+                std::uint64_t hash = 0;
+                std::uint64_t size = 0;
+                if (name.size() <= 17 || name[16] != '-' ||
+                    std::from_chars(name.data(), name.data() + 16, hash, 16).ptr != name.data() + 16 ||
+                    std::from_chars(name.data() + 17, name.data() + name.size(), size).ptr != name.data() + name.size())
+                {
+                    continue;
+                }
+
+#ifdef _WIN32
+                std::error_code linkEc;
+                if (fs::hard_link_count(blob->path(), linkEc) != 1 || linkEc)
+                {
+                    continue;
+                }
+#else
+                struct stat st{};
+                if (::lstat(blob->path().c_str(), &st) != 0 || !S_ISREG(st.st_mode) || st.st_nlink != 1 ||
+                    now - static_cast<std::int64_t>(st.st_ctime) < kPruneGraceSeconds)
+                {
+                    continue;
+                }
+#endif
+                std::error_code removeEc;
+                if (fs::remove(blob->path(), removeEc))
+                {
+                    ++result.blobsRemoved;
+                    result.bytesFreed += size;
+                    removedHashes.insert(hash);
+                }
+            }
+            fs::remove(shard->path(), shardEc); // only succeeds once the shard is empty
+        }
+
+        if (!removedHashes.empty())
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = cache_.begin(); it != cache_.end();)
+            {
+                it = removedHashes.count(it->second.hash) != 0 ? cache_.erase(it) : std::next(it);
+            }
+            dirty_ = true;
+        }
+
+        SLC_LOG_DEBUG("Pruned " + std::to_string(result.blobsRemoved) + " unused blobs from " + root_.string());
+        return result;
+    }
+
+    bool ContentStore::lookup(const std::string &source, const FileStamp &stamp, std::uint64_t &hash)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(source);
+        if (it == cache_.end() || !(it->second.stamp == stamp))
+        {
+            return false;
+        }
+        hash = it->second.hash;
+        return true;
+    }
+
+    void ContentStore::remember(const std::string &source, const FileStamp &stamp, std::uint64_t hash)
+    {
+        if (source.find('\n') != std::string::npos)
+        {
+            return; // cannot be represented in the line-based cache file
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache_[source] = CachedHash{stamp, hash};
+        dirty_ = true;
+    }
+
+    bool ContentStore::hashIntoStore(const fs::path &source, const std::function<void(std::uintmax_t)> &onBytes,
+                                     CopyResult &result, std::uint64_t &size)
+    {
+        // Written next to the blobs so the final rename never crosses filesystems. The copy goes through
+        // copyFileFast (reflink or copy_file_range where available), and the hash is taken from the copy,
+        // so the blob is named after exactly the bytes it holds even if the source was still being written
+        fs::path tempPath = uniqueTempPath(root_ / "incoming");
+        CopyResult copy = copyFileFast(source, tempPath, onBytes);
+        std::error_code ec;
+        if (!copy.success)
+        {
+            result.error = copy.error;
+            fs::remove(tempPath, ec);
+            return false;
+        }
+
+        std::ifstream in(tempPath, std::ios::binary);
+        if (!in.is_open())
+        {
+            result.error = "cannot open " + tempPath.string();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+
+        std::unique_ptr<char[]> buffer(new char[kHashBufferSize]);
+        Xxh64 hasher;
+        size = 0;
+        while (in)
+        {
+            in.read(buffer.get(), static_cast<std::streamsize>(kHashBufferSize));
+            std::streamsize bytesRead = in.gcount();
+            if (bytesRead <= 0)
+            {
+                break;
+            }
+            hasher.update(buffer.get(), static_cast<std::size_t>(bytesRead));
+            size += static_cast<std::uint64_t>(bytesRead);
+        }
+        if (in.bad())
+        {
+            result.error = "read failed";
+            in.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        in.close();
+
+        result.contentHash = hasher.digest();
+        result.bytesCopied = size;
+        result.method = copy.method;
+
+        fs::path blob = blobPath(result.contentHash, size);
+        fs::create_directories(blob.parent_path(), ec);
+        if (fs::exists(blob, ec))
+        {
+            // Another collection (or another file in this one) already stored these bytes
+            result.deduplicated = true;
+            fs::remove(tempPath, ec);
+            return true;
+        }
+
+        fs::rename(tempPath, blob, ec);
+        if (ec)
+        {
+            result.error = "cannot store blob: " + ec.message();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+
+        // Blobs are shared by every collection linking them; keep them from being edited in place
+        fs::permissions(blob, fs::perms::owner_read | fs::perms::group_read | fs::perms::others_read, ec);
+        return true;
+    }
+
+    bool ContentStore::linkBlob(const fs::path &blob, const fs::path &destination, CopyResult &result)
+    {
+        std::error_code ec;
+        fs::remove(destination, ec);
+        fs::create_hard_link(blob, destination, ec);
+        if (!ec)
+        {
+            result.success = true;
+            result.method = CopyMethod::Hardlink;
+            return true;
+        }
+
+        // No hardlinks here (FAT, link count limit, ...): fall back to a real copy of the blob
+        CopyResult copy = copyFileFast(blob, destination);
+        result.success = copy.success;
+        result.method = copy.method;
+        result.error = copy.error;
+        return copy.success;
+    }
+
+    CopyResult ContentStore::store(const CopyJob &job, const std::function<void(std::uintmax_t)> &onBytes)
+    {
+        CopyResult result;
+        FileStamp stamp;
+        if (!readFileStamp(job.source, stamp))
+        {
+            result.error = "cannot stat source";
+            return result;
+        }
+
+        const std::string key = job.source.string();
+        std::uint64_t hash = 0;
+        if (lookup(key, stamp, hash))
+        {
+            fs::path blob = blobPath(hash, stamp.size);
+            std::error_code ec;
+            if (fs::exists(blob, ec))
+            {
+                result.contentHash = hash;
+                result.deduplicated = true;
+                result.bytesCopied = stamp.size;
+                if (onBytes)
+                {
+                    onBytes(stamp.size);
+                }
+                linkBlob(blob, job.destination, result);
+                return result;
+            }
+        }
+
+        std::uint64_t size = 0;
+        if (!hashIntoStore(job.source, onBytes, result, size) ||
+            !linkBlob(blobPath(result.contentHash, size), job.destination, result))
+        {
+            return result;
+        }
+
+        // A file that grew while it was read is hashed again next time
+        FileStamp after;
+        if (size == stamp.size && readFileStamp(job.source, after) && after == stamp)
+        {
+            remember(key, stamp, result.contentHash);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,500 @@
+#include "copy_engine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        constexpr std::size_t kBufferSize = 1024 * 1024;
+        constexpr std::uintmax_t kReportInterval = 8 * 1024 * 1024; // buffered copies report every 8 MB
+#ifdef __linux__
+        constexpr std::size_t kCopyRangeChunk = 64 * 1024 * 1024;
+#endif
+
+        void reportBytes(const std::function<void(std::uintmax_t)> &onBytes, std::uintmax_t copied)
+        {
+            if (onBytes)
+            {
+                onBytes(copied);
+            }
+        }
+
+#ifndef _WIN32
+        class FileDescriptor
+        {
+        public:
+            explicit FileDescriptor(int fd) noexcept : fd_(fd) {}
+            ~FileDescriptor()
+            {
+                if (fd_ >= 0)
+                {
+                    ::close(fd_);
+                }
+            }
+            FileDescriptor(const FileDescriptor &) = delete;
+            FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+            [[nodiscard]] int get() const noexcept { return fd_; }
+
+        private:
+            int fd_;
+        };
+
+        [[nodiscard]] std::string errnoMessage(const char *what)
+        {
+            return std::string(what) + ": " + std::strerror(errno);
+        }
+
+#ifdef __linux__
+        /**
+         * copy_file_range from both files' current positions to the end of the source.
+         * Returns true once the result is final; false means "use the buffered loop".
+         */
+        bool kernelCopy(int in, int out, bool emptySource, CopyResult &result,
+                        const std::function<void(std::uintmax_t)> &onBytes)
+        {
+            const std::uintmax_t start = result.bytesCopied;
+            bool rangeSupported = true;
+            while (true)
+            {
+                ssize_t n = static_cast<ssize_t>(::syscall(SYS_copy_file_range, in, nullptr, out, nullptr,
+                                                           kCopyRangeChunk, 0u));
+                if (n > 0)
+                {
+                    result.bytesCopied += static_cast<std::uintmax_t>(n);
+                    reportBytes(onBytes, result.bytesCopied);
+                    continue;
+                }
+                if (n == 0)
+                {
+                    // Pseudo-filesystems report EOF immediately; let the buffered loop read them
+                    rangeSupported = result.bytesCopied > start || emptySource;
+                    break;
+                }
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (result.bytesCopied == start &&
+                    (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP || errno == EPERM))
+                {
+                    rangeSupported = false;
+                    break;
+                }
+                result.error = errnoMessage("copy_file_range");
+                return true;
+            }
+
+            if (rangeSupported)
+            {
+                result.success = true;
+                result.method = CopyMethod::CopyFileRange;
+            }
+            return rangeSupported;
+        }
+#endif
+
+        bool bufferedCopy(int in, int out, std::uintmax_t &copied, const std::function<void(std::uintmax_t)> &onBytes,
+                          std::string &error)
+        {
+#ifdef POSIX_FADV_SEQUENTIAL
+            ::posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+            std::uintmax_t lastReport = copied;
+
+            while (true)
+            {
+                ssize_t bytesRead = ::read(in, buffer.get(), kBufferSize);
+                if (bytesRead < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    error = errnoMessage("read");
+                    return false;
+                }
+                if (bytesRead == 0)
+                {
+                    break;
+                }
+
+                for (ssize_t offset = 0; offset < bytesRead;)
+                {
+                    ssize_t written = ::write(out, buffer.get() + offset, static_cast<std::size_t>(bytesRead - offset));
+                    if (written < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        error = errnoMessage("write");
+                        return false;
+                    }
+                    offset += written;
+                }
+
+                copied += static_cast<std::uintmax_t>(bytesRead);
+                if (copied - lastReport >= kReportInterval)
+                {
+                    reportBytes(onBytes, copied);
+                    lastReport = copied;
+                }
+            }
+
+            reportBytes(onBytes, copied);
+            return true;
+        }
+#endif
+    } // anonymous namespace
+
+    const char *copyMethodName(CopyMethod method) noexcept
+    {
+        switch (method)
+        {
+        case CopyMethod::Reflink:
+            return "reflink";
+        case CopyMethod::CopyFileRange:
+            return "copy_file_range";
+        case CopyMethod::Buffered:
+            return "buffered";
+        case CopyMethod::Hardlink:
+            return "hardlink";
+        case CopyMethod::None:
+            break;
+        }
+        return "none";
+    }
+
+    CopyResult copyFileFast(const fs::path &source, const fs::path &destination,
+                            const std::function<void(std::uintmax_t)> &onBytes)
+    {
+        CopyResult result;
+
+#ifndef _WIN32
+        FileDescriptor in(::open(source.c_str(), O_RDONLY | O_CLOEXEC));
+        if (in.get() < 0)
+        {
+            result.error = errnoMessage("open source");
+            return result;
+        }
+
+        struct stat st{};
+        if (::fstat(in.get(), &st) != 0)
+        {
+            result.error = errnoMessage("stat source");
+            return result;
+        }
+
+        FileDescriptor out(::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777));
+        if (out.get() < 0)
+        {
+            result.error = errnoMessage("open destination");
+            return result;
+        }
+
+#ifdef __linux__
+        // Same filesystem with extent sharing: the copy is a metadata operation
+        if (::ioctl(out.get(), FICLONE, in.get()) == 0)
+        {
+            result.success = true;
+            result.method = CopyMethod::Reflink;
+            result.bytesCopied = static_cast<std::uintmax_t>(st.st_size);
+            reportBytes(onBytes, result.bytesCopied);
+            return result;
+        }
+
+        if (kernelCopy(in.get(), out.get(), st.st_size == 0, result, onBytes) && result.success)
+        {
+            return result;
+        }
+#endif
+
+        if (result.error.empty() && bufferedCopy(in.get(), out.get(), result.bytesCopied, onBytes, result.error))
+        {
+            result.success = true;
+            result.method = CopyMethod::Buffered;
+            return result;
+        }
+#else
+        std::ifstream in(source, std::ios::binary);
+        if (!in.is_open())
+        {
+            result.error = "cannot open source";
+            return result;
+        }
+        std::ofstream out(destination, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+        {
+            result.error = "cannot open destination";
+            return result;
+        }
+
+        std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+        std::uintmax_t lastReport = 0;
+        while (in)
+        {
+            in.read(buffer.get(), static_cast<std::streamsize>(kBufferSize));
+            std::streamsize bytesRead = in.gcount();
+            if (bytesRead <= 0)
+            {
+                break;
+            }
+            if (!out.write(buffer.get(), bytesRead))
+            {
+                result.error = "write failed";
+                break;
+            }
+            result.bytesCopied += static_cast<std::uintmax_t>(bytesRead);
+            if (result.bytesCopied - lastReport >= kReportInterval)
+            {
+                reportBytes(onBytes, result.bytesCopied);
+                lastReport = result.bytesCopied;
+            }
+        }
+
+        if (result.error.empty() && !in.bad())
+        {
+            reportBytes(onBytes, result.bytesCopied);
+            result.success = true;
+            result.method = CopyMethod::Buffered;
+            return result;
+        }
+        if (result.error.empty())
+        {
+            result.error = "read failed";
+        }
+        out.close();
+#endif
+
+        // Do not leave a truncated copy behind
+        std::error_code ec;
+        fs::remove(destination, ec);
+        return result;
+    }
+
+    CopyResult appendFileTail(const fs::path &source, const fs::path &destination, std::uintmax_t offset,
+                              const std::function<void(std::uintmax_t)> &onBytes)
+    {
+        CopyResult result;
+
+#ifndef _WIN32
+        FileDescriptor in(::open(source.c_str(), O_RDONLY | O_CLOEXEC));
+        if (in.get() < 0)
+        {
+            result.error = errnoMessage("open source");
+            return result;
+        }
+        FileDescriptor out(::open(destination.c_str(), O_WRONLY | O_CLOEXEC));
+        if (out.get() < 0)
+        {
+            result.error = errnoMessage("open destination");
+            return result;
+        }
+
+        struct stat st{};
+        if (::fstat(out.get(), &st) != 0 || static_cast<std::uintmax_t>(st.st_size) < offset)
+        {
+            result.error = "destination is shorter than the append offset";
+            return result;
+        }
+
+        // Drop anything an interrupted earlier append left past the offset
+        const auto start = static_cast<off_t>(offset);
+        if (::ftruncate(out.get(), start) != 0 || ::lseek(out.get(), start, SEEK_SET) != start ||
+            ::lseek(in.get(), start, SEEK_SET) != start)
+        {
+            result.error = errnoMessage("seek");
+            return result;
+        }
+
+#ifdef __linux__
+        if (::fstat(in.get(), &st) == 0 &&
+            kernelCopy(in.get(), out.get(), static_cast<std::uintmax_t>(st.st_size) <= offset, result, onBytes) &&
+            result.success)
+        {
+            return result;
+        }
+#endif
+
+        if (result.error.empty() && bufferedCopy(in.get(), out.get(), result.bytesCopied, onBytes, result.error))
+        {
+            result.success = true;
+            result.method = CopyMethod::Buffered;
+            return result;
+        }
+
+        if (::ftruncate(out.get(), start) != 0)
+        {
+            result.error += "; could not restore the destination size";
+        }
+#else
+        std::ifstream in(source, std::ios::binary);
+        std::fstream out(destination, std::ios::binary | std::ios::in | std::ios::out);
+        if (!in.is_open() || !out.is_open())
+        {
+            result.error = "cannot open files";
+            return result;
+        }
+        std::error_code ec;
+        if (fs::file_size(destination, ec) < offset || ec)
+        {
+            result.error = "destination is shorter than the append offset";
+            return result;
+        }
+        fs::resize_file(destination, offset, ec);
+        in.seekg(static_cast<std::streamoff>(offset));
+        out.seekp(static_cast<std::streamoff>(offset));
+
+        std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+        while (in)
+        {
+            in.read(buffer.get(), static_cast<std::streamsize>(kBufferSize));
+            std::streamsize bytesRead = in.gcount();
+            if (bytesRead <= 0)
+            {
+                break;
+            }
+            if (!out.write(buffer.get(), bytesRead))
+            {
+                result.error = "write failed";
+                break;
+            }
+            result.bytesCopied += static_cast<std::uintmax_t>(bytesRead);
+            reportBytes(onBytes, result.bytesCopied);
+        }
+        if (result.error.empty() && !in.bad())
+        {
+            result.success = true;
+            result.method = CopyMethod::Buffered;
+            return result;
+        }
+        if (result.error.empty())
+        {
+            result.error = "read failed";
+        }
+        out.close();
+        fs::resize_file(destination, offset, ec);
+#endif
+        return result;
+    }
+
+    std::vector<CopyResult> copyFiles(const std::vector<CopyJob> &jobs, const CopyOptions &options)
+    {
+        std::vector<CopyResult> results(jobs.size());
+        if (jobs.empty())
+        {
+            return results;
+        }
+
+        std::vector<std::size_t> order(jobs.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(),
+                         [&jobs](std::size_t a, std::size_t b)
+                         { return jobs[a].size > jobs[b].size; });
+
+        CopyProgress progress;
+        progress.jobCount = jobs.size();
+        for (const auto &job : jobs)
+        {
+            progress.totalBytes += job.size;
+        }
+
+        std::mutex progressMutex;
+        const auto start = std::chrono::steady_clock::now();
+
+        auto report = [&](std::size_t jobIndex, std::uintmax_t jobBytes, std::uintmax_t delta, bool finished)
+        {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            progress.jobIndex = jobIndex;
+            progress.jobFinished = finished;
+            progress.jobBytesCopied = jobBytes;
+            progress.totalBytesCopied += delta;
+            if (finished)
+            {
+                progress.jobsDone++;
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            progress.bytesPerSecond = seconds > 0 ? static_cast<double>(progress.totalBytesCopied) / seconds : 0;
+
+            if (options.onProgress)
+            {
+                options.onProgress(progress);
+            }
+        };
+
+        std::atomic<std::size_t> next{0};
+        auto work = [&]
+        {
+            for (std::size_t slot = next++; slot < order.size(); slot = next++)
+            {
+                std::size_t jobIndex = order[slot];
+                const CopyJob &job = jobs[jobIndex];
+                std::uintmax_t reported = 0;
+
+                auto onBytes = [&](std::uintmax_t copied)
+                {
+                    report(jobIndex, copied, copied - reported, false);
+                    reported = copied;
+                };
+                if (options.copy)
+                {
+                    results[jobIndex] = options.copy(job, onBytes);
+                }
+                else if (job.appendOffset > 0)
+                {
+                    results[jobIndex] = appendFileTail(job.source, job.destination, job.appendOffset, onBytes);
+                }
+                else
+                {
+                    results[jobIndex] = copyFileFast(job.source, job.destination, onBytes);
+                }
+
+                std::uintmax_t copied = std::max(results[jobIndex].bytesCopied, reported);
+                report(jobIndex, copied, copied - reported, true);
+            }
+        };
+
+        unsigned concurrency = options.concurrency != 0 ? options.concurrency
+                                                        : std::max(1u, std::thread::hardware_concurrency());
+        std::size_t workerCount = std::min<std::size_t>(concurrency, jobs.size());
+
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < workerCount; ++i)
+        {
+            workers.emplace_back(work);
+        }
+        work(); // the calling thread is one of the workers
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        return results;
+    }
+}
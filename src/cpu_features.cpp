@@ -0,0 +1,38 @@
+#include "cpu_features.hpp"
+
+#if defined(SLC_HAVE_X86_SIMD) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        [[nodiscard]] bool detectAvx2() noexcept
+        {
+#if !defined(SLC_HAVE_X86_SIMD)
+            return false;
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+            __cpuid(info, 1);
+            const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+    }
+
+    bool cpuHasAvx2() noexcept
+    {
+        static const bool hasAvx2 = detectAvx2();
+        return hasAvx2;
+    }
+}
@@ -0,0 +1,262 @@
+#include "dir_walker.hpp"
+#include "binary_log.hpp"
+#include "log_classifier.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        void addLogFile(std::vector<LogFile> &logFiles, fs::path path, std::string filename, LogCategory category,
+                        std::uintmax_t size, std::int64_t lastModifiedNs)
+        {
+            LogFile logFile;
+            logFile.path = std::move(path);
+            logFile.type = logCategoryName(category);
+            logFile.filename = std::move(filename);
+            logFile.size = size;
+            logFile.lastModifiedNs = lastModifiedNs;
+
+            SLC_LOG_DEBUG("Found log file: " + logFile.path.string() + " (" + formatFileSize(logFile.size) + ")");
+            if (BinaryLog::enabled())
+            {
+                // Directories repeat across files and are interned; the file name is copied into the record
+#ifdef _WIN32
+                std::string directory = logFile.path.parent_path().string();
+#else
+                std::string_view directory = logFile.path.native();
+                directory.remove_suffix(std::min(directory.size(), logFile.filename.size() + 1));
+#endif
+                BinaryLog::emit(BinaryLog::Event::LogFileFound, SeverityLevel::Debug, size,
+                                static_cast<std::uint64_t>(lastModifiedNs), static_cast<std::uint64_t>(category),
+                                BinaryLog::intern(directory), logFile.filename);
+            }
+            logFiles.push_back(std::move(logFile));
+        }
+
+        bool scanPortable(const fs::path &directory, std::vector<LogFile> &logFiles,
+                          const std::function<void(const fs::path &)> &onSubdirectory)
+        {
+            if (!directoryExists(directory))
+            {
+                return false;
+            }
+
+            try
+            {
+                for (const auto &entry : fs::directory_iterator(directory))
+                {
+                    try
+                    {
+                        if (entry.is_regular_file())
+                        {
+                            std::string filename = entry.path().filename().string();
+
+                            LogClassification classification = classifyLogFile(filename);
+                            if (classification.isLog)
+                            {
+                                addLogFile(logFiles, entry.path(), std::move(filename), classification.category,
+                                           entry.file_size(), toEpochNs(entry.last_write_time()));
+                            }
+                        }
+                        else if (entry.is_directory())
+                        {
+                            onSubdirectory(entry.path());
+                        }
+                    }
+                    catch (const std::exception &e)
+                    {
+                        continue;
+                    }
+                }
+            }
+            catch (const fs::filesystem_error &e)
+            {
+                Logger::log("Error scanning directory " + directory.string() + ": " + e.what(), SeverityLevel::Err);
+            }
+            return true;
+        }
+
+#ifdef __linux__
+        [[nodiscard]] std::int64_t statModifiedNs(const struct stat &st)
+        {
+            return static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+        }
+
+        // Kernel record layout for getdents64; glibc only exposes it behind _GNU_SOURCE on newer versions
+        struct LinuxDirent64
+        {
+            std::uint64_t d_ino;
+            std::int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+
+        constexpr std::size_t kDirentBufferSize = 32 * 1024;
+
+        // Closes the directory on every way out of scanGetdents, including exceptions from the callbacks
+        class DirectoryFd
+        {
+        public:
+            explicit DirectoryFd(int fd) noexcept : fd_(fd) {}
+            ~DirectoryFd()
+            {
+                if (fd_ >= 0)
+                {
+                    ::close(fd_);
+                }
+            }
+            DirectoryFd(const DirectoryFd &) = delete;
+            DirectoryFd &operator=(const DirectoryFd &) = delete;
+
+            [[nodiscard]] int get() const noexcept { return fd_; }
+
+        private:
+            int fd_;
+        };
+
+        /**
+         * Enumerates with raw getdents64 and classifies entries from d_type, so the
+         * only stat calls are for files that already passed the name filter (plus
+         * symlinks and filesystems that report DT_UNKNOWN).
+         */
+        bool scanGetdents(const fs::path &directory, std::vector<LogFile> &logFiles,
+                          const std::function<void(const fs::path &)> &onSubdirectory)
+        {
+            const DirectoryFd directoryFd(::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+            const int dirFd = directoryFd.get();
+            if (dirFd < 0)
+            {
+                if (errno != ENOENT && errno != ENOTDIR)
+                {
+                    Logger::log("Error scanning directory " + directory.string() + ": " + std::strerror(errno), SeverityLevel::Err);
+                }
+                return false;
+            }
+
+            alignas(LinuxDirent64) char buffer[kDirentBufferSize];
+
+            while (true)
+            {
+                long bytesRead = ::syscall(SYS_getdents64, dirFd, buffer, sizeof(buffer));
+                if (bytesRead <= 0)
+                {
+                    if (bytesRead < 0)
+                    {
+                        Logger::log("Error scanning directory " + directory.string() + ": " + std::strerror(errno), SeverityLevel::Err);
+                    }
+                    break;
+                }
+
+                for (long offset = 0; offset < bytesRead;)
+                {
+                    const auto *entry = reinterpret_cast<const LinuxDirent64 *>(buffer + offset);
+                    offset += entry->d_reclen;
+
+                    const char *name = entry->d_name;
+                    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    {
+                        continue;
+                    }
+
+                    unsigned char type = entry->d_type;
+                    struct stat st{};
+                    bool haveStat = false;
+
+                    if (type == DT_LNK || type == DT_UNKNOWN)
+                    {
+                        // Follow the link like directory_entry::is_regular_file/is_directory do
+                        if (::fstatat(dirFd, name, &st, 0) != 0)
+                        {
+                            continue;
+                        }
+                        haveStat = true;
+                        type = S_ISREG(st.st_mode) ? DT_REG : (S_ISDIR(st.st_mode) ? DT_DIR : DT_UNKNOWN);
+                    }
+
+                    if (type == DT_REG)
+                    {
+                        std::string_view filename{name};
+                        LogClassification classification = classifyLogFile(filename);
+                        if (!classification.isLog)
+                        {
+                            continue;
+                        }
+                        if (!haveStat && ::fstatat(dirFd, name, &st, 0) != 0)
+                        {
+                            continue;
+                        }
+                        addLogFile(logFiles, directory / filename, std::string(filename), classification.category,
+                                   static_cast<std::uintmax_t>(st.st_size), statModifiedNs(st));
+                    }
+                    else if (type == DT_DIR)
+                    {
+                        onSubdirectory(directory / name);
+                    }
+                }
+            }
+            return true;
+        }
+#endif
+    } // anonymous namespace
+
+    bool scanDirectoryLevel(const fs::path &directory, WalkerBackend backend, std::vector<LogFile> &logFiles,
+                            const std::function<void(const fs::path &)> &onSubdirectory)
+    {
+#ifdef __linux__
+        if (backend != WalkerBackend::Portable)
+        {
+            return scanGetdents(directory, logFiles, onSubdirectory);
+        }
+#else
+        (void)backend;
+#endif
+        return scanPortable(directory, logFiles, onSubdirectory);
+    }
+
+    bool restatLogFile(const fs::path &directory, std::string_view filename, std::vector<LogFile> &logFiles)
+    {
+        fs::path path = directory / filename;
+#ifdef __linux__
+        struct stat st{};
+        if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            return false;
+        }
+        addLogFile(logFiles, std::move(path), std::string(filename), classifyLogFile(filename).category,
+                   static_cast<std::uintmax_t>(st.st_size), statModifiedNs(st));
+        return true;
+#else
+        std::error_code ec;
+        fs::directory_entry entry(path, ec);
+        if (ec || !entry.is_regular_file(ec))
+        {
+            return false;
+        }
+        std::uintmax_t size = entry.file_size(ec);
+        fs::file_time_type modified = entry.last_write_time(ec);
+        if (ec)
+        {
+            return false;
+        }
+        addLogFile(logFiles, std::move(path), std::string(filename), classifyLogFile(filename).category,
+                   size, toEpochNs(modified));
+        return true;
+#endif
+    }
+}
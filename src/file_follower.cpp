@@ -0,0 +1,106 @@
+#include "file_follower.hpp"
+#include "logger.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        // Even with inotify, re-stat now and then: network and FUSE mounts may not report remote writes
+        constexpr std::chrono::seconds kSafetyInterval{2};
+    }
+
+    FileFollower::~FileFollower()
+    {
+        stop();
+    }
+
+    void FileFollower::start(const std::filesystem::path &path)
+    {
+        stop();
+        filename_ = path.filename().string();
+        lastCheck_ = std::chrono::steady_clock::now();
+        running_ = true;
+
+#ifdef __linux__
+        // Watching the directory rather than the file also sees a new file created under the same name
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0)
+        {
+            Logger::log(std::string("inotify_init1 failed, polling instead: ") + std::strerror(errno), SeverityLevel::Warning);
+            return;
+        }
+        const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+        constexpr std::uint32_t kMask = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                        IN_MOVED_TO | IN_ONLYDIR;
+        if (inotify_add_watch(fd_, directory.c_str(), kMask) < 0)
+        {
+            Logger::log("Cannot watch " + directory.string() + ", polling instead: " + std::strerror(errno), SeverityLevel::Warning);
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+    }
+
+    void FileFollower::stop() noexcept
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+#endif
+        fd_ = -1;
+        running_ = false;
+    }
+
+    bool FileFollower::changed()
+    {
+        if (!running_)
+        {
+            return false;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            bool touched = false;
+            alignas(inotify_event) char buffer[4096];
+            ssize_t length;
+            while ((length = ::read(fd_, buffer, sizeof(buffer))) > 0)
+            {
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                    if ((event->mask & IN_Q_OVERFLOW) != 0 || (event->len > 0 && filename_ == event->name))
+                    {
+                        touched = true;
+                    }
+                }
+            }
+            if (!touched && now - lastCheck_ < kSafetyInterval)
+            {
+                return false;
+            }
+            lastCheck_ = now;
+            return true;
+        }
+#endif
+        if (now - lastCheck_ < kPollInterval)
+        {
+            return false;
+        }
+        lastCheck_ = now;
+        return true;
+    }
+}
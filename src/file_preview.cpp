@@ -1,53 +1,253 @@
 #include "file_preview.hpp"
 
 #include <imgui.h>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <string_view>
 
 #include "colors.hpp"
 #include "fonts.hpp"
 #include "ui_widgets.hpp"
 #include "steam-utils.hpp"
+#include "toast.hpp"
 
-std::string ReadFileContent(const std::filesystem::path &filePath,
-                            size_t maxBytes)
+namespace
 {
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file.is_open())
+    // Longer lines (minified JSON, binary junk) are cut so one row cannot stall a frame
+    constexpr size_t kMaxRenderedLineBytes = 8 * 1024;
+    // Beyond this many matches in one row (a one-letter query on a long line) the rest are not highlighted
+    constexpr size_t kMaxHighlightsPerLine = 256;
+
+    void RestartSearch(AppState &state)
     {
-        return "Error: Could not open file for reading.";
+        state.previewMatch = 0;
+        state.previewScrollToMatch = true;
+        state.previewJumpOffset.reset();
+        if (state.previewQuery[0] == '\0')
+        {
+            state.preview.clearSearch();
+            return;
+        }
+        // Every keystroke lands here; the previous search is cancelled within one slice
+        (void)state.preview.startSearch(state.previewQuery, state.previewSearchOptions);
     }
 
-    std::ostringstream content;
-    char buffer[kReadBufferSize];
-    size_t bytesRead = 0;
+    void StepMatch(AppState &state, bool forward)
+    {
+        const size_t count = state.preview.search().matchCount();
+        if (count == 0)
+        {
+            return;
+        }
+        state.previewMatch = forward ? (state.previewMatch + 1) % count : (state.previewMatch + count - 1) % count;
+        state.previewScrollToMatch = true;
+    }
 
-    while (bytesRead < maxBytes && file.read(buffer, sizeof(buffer)))
+    void RenderSearchBar(AppState &state)
     {
-        size_t count = file.gcount();
-        content.write(buffer, count);
-        bytesRead += count;
+        ImGui::SetNextItemWidth(300.0f);
+        const bool enter = ImGui::InputTextWithHint("##PreviewSearch", "Search this log...", state.previewQuery,
+                                                    sizeof(state.previewQuery), ImGuiInputTextFlags_EnterReturnsTrue);
+        bool changed = ImGui::IsItemEdited();
+        if (enter)
+        {
+            StepMatch(state, !ImGui::GetIO().KeyShift);
+            ImGui::SetKeyboardFocusHere(-1); // keep typing or pressing Enter without clicking back in
+        }
+        ImGui::SameLine();
+        changed |= ImGui::Checkbox("Ignore case", &state.previewSearchOptions.ignoreCase);
+        ImGui::SameLine();
+        changed |= ImGui::Checkbox("Regex", &state.previewSearchOptions.regex);
+        if (changed)
+        {
+            RestartSearch(state);
+        }
+
+        ImGui::SameLine();
+        if (ImGui::Button("Previous"))
+        {
+            StepMatch(state, false);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Next"))
+        {
+            StepMatch(state, true);
+        }
+        if (ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows) && ImGui::IsKeyPressed(ImGuiKey_F3))
+        {
+            StepMatch(state, !ImGui::GetIO().KeyShift);
+        }
+
+        const auto &search = state.preview.search();
+        if (state.previewQuery[0] == '\0')
+        {
+            return;
+        }
+        ImGui::SameLine();
+        if (!search.isActive())
+        {
+            ImGui::TextColored(UIColors::Error, "%s", search.matcher().error().c_str());
+            return;
+        }
+
+        const size_t count = search.matchCount();
+        std::string status = count == 0 ? std::string("No matches")
+                                        : std::to_string(state.previewMatch + 1) + " of " + std::to_string(count);
+        if (search.isTruncated())
+        {
+            status += " (stopped at the first " + std::to_string(count) + ")";
+        }
+        else if (!search.isComplete() && state.preview.size() > 0)
+        {
+            const auto percent = static_cast<int>(100.0 * static_cast<double>(search.searchedBytes()) /
+                                                  static_cast<double>(state.preview.size()));
+            status += " (searching, " + std::to_string(percent) + "%)";
+        }
+        if (const size_t clipped = search.clippedLines(); clipped > 0)
+        {
+            status += ", " + std::to_string(clipped) + " long lines only searched in their first " +
+                      std::to_string(SteamUtils::TextMatcher::kMaxRegexLineBytes / 1024) + " KB";
+        }
+        ImGui::TextDisabled("%s", status.c_str());
     }
 
-    if (bytesRead < maxBytes && file.gcount() > 0)
+    /**
+     * @brief Highlights the search matches that start in a line, behind text about to be drawn at the cursor
+     */
+    void HighlightMatches(const SteamUtils::LogView &view, size_t lineIndex, std::string_view line, size_t currentMatch)
     {
-        content.write(buffer, file.gcount());
-        bytesRead += file.gcount();
+        const auto &search = view.search();
+        const size_t count = search.matchCount();
+        const std::uint64_t lineStart = view.lineOffset(lineIndex);
+        const size_t visible = std::min(line.size(), kMaxRenderedLineBytes);
+
+        ImDrawList *drawList = ImGui::GetWindowDrawList();
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float height = ImGui::GetTextLineHeight();
+        const ImU32 otherColor = ImGui::ColorConvertFloat4ToU32(
+            ImVec4(UIColors::LavenderBlue.x, UIColors::LavenderBlue.y, UIColors::LavenderBlue.z, 0.3f));
+        const ImU32 currentColor = ImGui::ColorConvertFloat4ToU32(
+            ImVec4(UIColors::Warning.x, UIColors::Warning.y, UIColors::Warning.z, 0.6f));
+
+        // Widths are measured incrementally, so a row costs one pass over its text
+        size_t measured = 0;
+        float x = origin.x;
+        size_t drawn = 0;
+        for (size_t m = search.firstMatchFrom(lineStart); m < count && drawn < kMaxHighlightsPerLine; ++m, ++drawn)
+        {
+            const size_t column = static_cast<size_t>(search.match(m) - lineStart);
+            if (column >= visible)
+            {
+                break;
+            }
+            size_t length = search.matcher().matchLength(line.data() + column, line.size() - column);
+            if (length == 0)
+            {
+                length = line.size() - column; // a match running past the end of the line
+            }
+            const size_t end = std::min(column + length, visible);
+
+            x += ImGui::CalcTextSize(line.data() + measured, line.data() + column).x;
+            const float width = ImGui::CalcTextSize(line.data() + column, line.data() + end).x;
+            measured = column;
+            drawList->AddRectFilled(ImVec2(x, origin.y), ImVec2(x + width, origin.y + height),
+                                    m == currentMatch ? currentColor : otherColor);
+        }
     }
 
-    std::string result = content.str();
-    if (bytesRead >= maxBytes)
+    void RenderLines(AppState &state, bool scrollToEnd)
     {
-        result += "\n\n[Preview truncated - file is larger than 1MB]";
+        const SteamUtils::LogView &view = state.preview;
+        if (!view.isOpen())
+        {
+            ImGui::TextDisabled("(the file is no longer available)");
+            return;
+        }
+        if (view.lineCount() == 0 && view.isIndexed())
+        {
+            ImGui::TextDisabled("(empty file)");
+            return;
+        }
+
+        const float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+        const auto &search = view.search();
+        const size_t matchCount = search.matchCount();
+        size_t currentMatch = SIZE_MAX;
+        bool jumped = false;
+        if (state.previewMatch < matchCount)
+        {
+            currentMatch = state.previewMatch;
+            const size_t matchLine = view.lineAt(search.match(currentMatch));
+            if (state.previewScrollToMatch && matchLine < view.lineCount())
+            {
+                ImGui::SetScrollY(std::max(0.0f, static_cast<float>(matchLine) * lineHeight - ImGui::GetWindowHeight() * 0.5f));
+                state.previewScrollToMatch = false;
+                jumped = true;
+            }
+        }
+
+        // Stay pinned to the end while following, unless the user scrolled up to read
+        const bool atEnd = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+        const int digits = static_cast<int>(std::to_string(view.lineCount()).size());
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(std::min<size_t>(view.lineCount(), INT_MAX)), lineHeight);
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                ImGui::TextDisabled("%*d", digits, i + 1);
+                ImGui::SameLine();
+                std::string_view line = view.line(static_cast<size_t>(i));
+                if (matchCount > 0)
+                {
+                    HighlightMatches(view, static_cast<size_t>(i), line, currentMatch);
+                }
+                if (line.size() > kMaxRenderedLineBytes)
+                {
+                    ImGui::TextUnformatted(line.data(), line.data() + kMaxRenderedLineBytes);
+                    ImGui::SameLine(0.0f, 0.0f);
+                    ImGui::TextDisabled(" ... (%s more)", SteamUtils::formatFileSize(line.size() - kMaxRenderedLineBytes).c_str());
+                }
+                else
+                {
+                    ImGui::TextUnformatted(line.data(), line.data() + line.size());
+                }
+            }
+        }
+        clipper.End();
+
+        if (!jumped && (scrollToEnd || (view.isFollowing() && atEnd)))
+        {
+            ImGui::SetScrollHereY(1.0f);
+        }
     }
+}
 
-    return result;
+bool OpenPreview(AppState &state, int logIndex)
+{
+    if (logIndex < 0 || logIndex >= static_cast<int>(state.logFiles.size()) ||
+        !state.preview.open(state.logFiles[logIndex].path))
+    {
+        state.preview.close();
+        return false;
+    }
+    state.previewLogIndex = logIndex;
+    state.showPreviewWindow = true;
+    RestartSearch(state); // the query carries over to the next file
+    return true;
 }
 
 void RenderPreviewWindow(AppState &state)
 {
     if (!state.showPreviewWindow)
+    {
+        // Unmap as soon as the window goes away; multi-GB logs should not stay mapped
+        if (state.preview.isOpen())
+            state.preview.close();
         return;
+    }
 
     ImVec2 displaySize = ImGui::GetIO().DisplaySize;
     ImGui::SetNextWindowSize(
@@ -64,6 +264,20 @@ void RenderPreviewWindow(AppState &state)
         {
             const auto &log = state.logFiles[state.previewLogIndex];
 
+            // Before anything is drawn, so a truncated log is reloaded rather than shown with zeroed pages
+            switch (state.preview.follow())
+            {
+            case SteamUtils::FollowUpdate::Truncated:
+                UIToast::Info("The log was truncated and has been reloaded.");
+                break;
+            case SteamUtils::FollowUpdate::Replaced:
+                UIToast::Info("The log was rotated; showing the new file.");
+                break;
+            case SteamUtils::FollowUpdate::None:
+            case SteamUtils::FollowUpdate::Appended:
+                break;
+            }
+
             ImGui::PushFont(UIFonts::GetLarge());
             ImGui::TextColored(UIColors::LavenderBlue, "%s",
                                log.filename.c_str());
@@ -75,9 +289,45 @@ void RenderPreviewWindow(AppState &state)
 
             UIWidgets::InfoText("Path:", log.path.string());
             UIWidgets::InfoText("Size:",
-                                SteamUtils::formatFileSize(log.size));
+                                SteamUtils::formatFileSize(state.preview.isOpen() ? state.preview.size() : log.size));
             UIWidgets::InfoText("Type:", log.type);
-            UIWidgets::InfoText("Modified:", log.lastModified);
+            UIWidgets::InfoText("Modified:", SteamUtils::formatTimestamp(log.lastModifiedNs));
+            std::string lines = std::to_string(state.preview.lineCount());
+            if (!state.preview.isIndexed() && state.preview.size() > 0)
+            {
+                // Lines appear as the background indexer reaches them
+                const auto percent = static_cast<int>(100.0 * static_cast<double>(state.preview.indexedBytes()) /
+                                                      static_cast<double>(state.preview.size()));
+                lines += " (indexing, " + std::to_string(percent) + "%)";
+            }
+            UIWidgets::InfoText("Lines:", lines);
+
+            const size_t matchCount = state.preview.search().matchCount();
+            if (matchCount > 0 && state.previewMatch >= matchCount)
+            {
+                state.previewMatch = matchCount - 1; // a reload or an append re-found fewer matches
+            }
+            if (state.previewJumpOffset)
+            {
+                // Wait until the search has passed the offset, so the match there is already published
+                const auto &search = state.preview.search();
+                if (!search.isActive() || search.isComplete() || search.searchedBytes() > *state.previewJumpOffset)
+                {
+                    state.previewMatch = std::min(search.firstMatchFrom(*state.previewJumpOffset),
+                                                  std::max<size_t>(search.matchCount(), 1) - 1);
+                    state.previewScrollToMatch = true;
+                    state.previewJumpOffset.reset();
+                }
+            }
+            RenderSearchBar(state);
+
+            bool following = state.preview.isFollowing();
+            bool scrollToEnd = false;
+            if (ImGui::Checkbox("Follow (show new lines as they are written)", &following))
+            {
+                state.preview.setFollowing(following);
+                scrollToEnd = following;
+            }
 
             ImGui::Spacing();
             ImGui::Separator();
@@ -86,7 +336,7 @@ void RenderPreviewWindow(AppState &state)
             ImGui::BeginChild("PreviewContent", ImVec2(0, -50), true,
                               ImGuiWindowFlags_HorizontalScrollbar);
             ImGui::PushFont(UIFonts::GetMedium());
-            ImGui::TextUnformatted(state.previewContent.c_str());
+            RenderLines(state, scrollToEnd);
             ImGui::PopFont();
             ImGui::EndChild();
 
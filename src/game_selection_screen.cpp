@@ -2,11 +2,15 @@
 
 #include <imgui.h>
 #include <algorithm>
+#include <cstdio>
 
 #include "colors.hpp"
 #include "fonts.hpp"
 #include "ui_widgets.hpp"
 #include "steam-utils.hpp"
+#include "toast.hpp"
+#include "log_files_screen.hpp"
+#include "welcome_screen.hpp"
 
 void RenderGameSelectionScreen(AppState &state)
 {
@@ -26,6 +30,7 @@ void RenderGameSelectionScreen(AppState &state)
     ImGui::SameLine(contentWidth - 80);
     if (UIWidgets::SecondaryButton("Back", ImVec2(100, 35)))
     {
+        AbandonSteamDiscovery(state);
         state.currentScreen = Screen::Welcome;
         state.steamDir.clear();
         state.steamDirFound = false;
@@ -55,6 +60,22 @@ void RenderGameSelectionScreen(AppState &state)
     ImGui::TextColored(UIColors::CoolGray, "Games Found:");
     ImGui::SameLine();
     ImGui::TextColored(UIColors::OffWhite, "%zu", state.games.size());
+    if (state.scanningGames)
+    {
+        const SteamDiscoveryJob &job = *state.steamDiscovery.job;
+        ImGui::SameLine();
+        ImGui::TextColored(UIColors::CoolGray, "(loading: %zu of %zu manifests parsed)",
+                           job.manifestsParsed.load(), job.manifestCount.load());
+        ImGui::SameLine();
+        if (job.cancel)
+        {
+            ImGui::TextDisabled("Stopping...");
+        }
+        else if (UIWidgets::SecondaryButton("Stop", ImVec2(80, 0)))
+        {
+            StopLoadingGames(state);
+        }
+    }
     ImGui::PopFont();
     ImGui::EndGroup();
 
@@ -75,7 +96,7 @@ void RenderGameSelectionScreen(AppState &state)
         ImGui::SetCursorPosY(centerY);
 
         ImGui::PushFont(UIFonts::GetLarge());
-        const char *noGamesText = "No Games Found";
+        const char *noGamesText = state.scanningGames ? "Loading Games..." : "No Games Found";
         float textWidth = ImGui::CalcTextSize(noGamesText).x;
         ImGui::SetCursorPosX((contentWidth - textWidth) / 2.0f);
         ImGui::TextColored(UIColors::CoolGray, "%s", noGamesText);
@@ -85,7 +106,8 @@ void RenderGameSelectionScreen(AppState &state)
         ImGui::Spacing();
 
         const char *helpText =
-            "No Steam games were detected in this directory.";
+            state.scanningGames ? "Games will appear here as their manifests are read."
+                                : "No Steam games were detected in this directory.";
         float helpWidth = ImGui::CalcTextSize(helpText).x;
         ImGui::SetCursorPosX((contentWidth - helpWidth) / 2.0f);
         ImGui::TextColored(UIColors::CoolGray, "%s", helpText);
@@ -99,6 +121,7 @@ void RenderGameSelectionScreen(AppState &state)
         if (UIWidgets::PrimaryButton("Try Different Directory",
                                      ImVec2(buttonWidth, 50)))
         {
+            AbandonSteamDiscovery(state);
             state.currentScreen = Screen::Welcome;
             state.steamDir.clear();
             state.steamDirFound = false;
@@ -125,69 +148,71 @@ void RenderGameSelectionScreen(AppState &state)
         float itemWidth = contentWidth - innerPadding * 2 - 15;
         float itemHeight = std::max(windowSize.y * 0.08f, 70.0f);
 
-        for (size_t i = 0; i < state.games.size(); i++)
+        // Cards are plain draw-list rectangles rather than child windows, all the same
+        // height, so the clipper can skip straight to the visible ones
+        const ImGuiStyle &style = ImGui::GetStyle();
+        const float rowHeight = itemHeight + style.ItemSpacing.y * 2;
+        const ImU32 borderColor = ImGui::GetColorU32(ImGuiCol_Border);
+        const ImU32 cardColor = ImGui::GetColorU32(ImGuiCol_ChildBg);
+        const ImU32 hoveredCardColor = ImGui::GetColorU32(
+            ImVec4(UIColors::LavenderBlue.x, UIColors::LavenderBlue.y,
+                   UIColors::LavenderBlue.z, 0.15f));
+        ImDrawList *drawList = ImGui::GetWindowDrawList();
+        char details[512];
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(state.games.size()), rowHeight);
+        while (clipper.Step())
         {
-            const auto &game = state.games[i];
-
-            ImGui::PushID(static_cast<int>(i));
-
-            ImVec2 cursorPos = ImGui::GetCursorScreenPos();
-            ImVec2 itemMax = ImVec2(cursorPos.x + itemWidth,
-                                    cursorPos.y + itemHeight);
-
-            bool hovered = ImGui::IsMouseHoveringRect(cursorPos, itemMax);
-
-            if (hovered)
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
             {
-                ImGui::PushStyleColor(
-                    ImGuiCol_ChildBg,
-                    ImVec4(UIColors::LavenderBlue.x, UIColors::LavenderBlue.y,
-                           UIColors::LavenderBlue.z, 0.15f));
-            }
-
-            ImGui::BeginChild("GameItem", ImVec2(itemWidth, itemHeight), true,
-                              ImGuiWindowFlags_NoScrollbar);
-
-            ImGui::SetCursorPos(ImVec2(15, 12));
-
-            ImGui::PushFont(UIFonts::GetLarge());
-            ImGui::TextColored(
-                hovered ? UIColors::LavenderBlue : UIColors::OffWhite, "%s",
-                game.name.c_str());
-            ImGui::PopFont();
-
-            ImGui::SetCursorPosX(15);
-            ImGui::PushFont(UIFonts::GetSmall());
-            ImGui::TextColored(UIColors::CoolGray, "App ID: %s  |  %s",
-                               game.appId.c_str(), game.installDir.c_str());
-            ImGui::PopFont();
-
-            ImGui::EndChild();
-
-            if (hovered)
-            {
-                ImGui::PopStyleColor();
-
-                if (ImGui::IsMouseClicked(0))
+                const auto &game = state.games[i];
+
+                ImGui::PushID(i);
+
+                ImVec2 cardMin = ImGui::GetCursorScreenPos();
+                ImVec2 cardMax = ImVec2(cardMin.x + itemWidth,
+                                        cardMin.y + itemHeight);
+                ImGui::InvisibleButton("GameItem", ImVec2(itemWidth, itemHeight));
+                bool hovered = ImGui::IsItemHovered();
+
+                drawList->AddRectFilled(cardMin, cardMax,
+                                        hovered ? hoveredCardColor : cardColor,
+                                        style.ChildRounding);
+                drawList->AddRect(cardMin, cardMax, borderColor,
+                                  style.ChildRounding, 0, style.ChildBorderSize);
+
+                drawList->PushClipRect(cardMin, cardMax, true);
+
+                ImVec2 textPos = ImVec2(cardMin.x + 15, cardMin.y + 12);
+                ImGui::PushFont(UIFonts::GetLarge());
+                drawList->AddText(
+                    textPos,
+                    ImGui::GetColorU32(hovered ? UIColors::LavenderBlue : UIColors::OffWhite),
+                    game.name.c_str());
+                textPos.y += ImGui::GetTextLineHeightWithSpacing();
+                ImGui::PopFont();
+
+                ImGui::PushFont(UIFonts::GetSmall());
+                std::snprintf(details, sizeof(details), "App ID: %s  |  %s",
+                              game.appId.c_str(), game.installDir.c_str());
+                drawList->AddText(textPos, ImGui::GetColorU32(UIColors::CoolGray),
+                                  details);
+                ImGui::PopFont();
+
+                drawList->PopClipRect();
+
+                if (ImGui::IsItemClicked(0) &&
+                    !StartLogScan(state, i))
                 {
-                    state.selectedGameIndex = static_cast<int>(i);
-                    state.logFiles.clear();
-                    state.selectedLogs.clear();
-                    state.previewLogIndex = -1;
-                    state.statusMessage.clear();
-                    state.errorMessage.clear();
-
-                    state.logFiles =
-                        SteamUtils::findGameLogs(state.steamDir, game);
-                    state.selectedLogs.resize(state.logFiles.size(), false);
-
-                    state.currentScreen = Screen::LogFiles;
+                    UIToast::Info("Still stopping the previous scan, try again in a moment.");
                 }
-            }
 
-            ImGui::PopID();
-            ImGui::Spacing();
+                ImGui::PopID();
+                ImGui::Spacing();
+            }
         }
+        clipper.End();
 
         ImGui::EndChild();
     }
@@ -0,0 +1,296 @@
+#include "line_index.hpp"
+#include "cpu_features.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef SLC_HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        // Indexed and published in slices this size, so the first screen of a huge file appears at once
+        constexpr std::size_t kChunkBytes = 4 * 1024 * 1024;
+
+        [[nodiscard]] inline unsigned countTrailingZeros(std::uint64_t value) noexcept
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+        }
+
+        inline void appendMatches(std::uint64_t mask, std::uint64_t position, std::vector<std::uint64_t> &out)
+        {
+            while (mask != 0)
+            {
+                out.push_back(position + countTrailingZeros(mask) + 1);
+                mask &= mask - 1;
+            }
+        }
+
+        void findScalar(const char *data, std::size_t size, std::uint64_t base, std::vector<std::uint64_t> &out)
+        {
+            constexpr std::uint64_t kOnes = 0x0101010101010101ULL;
+            constexpr std::uint64_t kHighs = 0x8080808080808080ULL;
+            constexpr std::uint64_t kNewlines = kOnes * '\n';
+
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, data + i, sizeof(word));
+                std::uint64_t x = word ^ kNewlines;
+                // Exact per-byte zero test: high bit set only where the byte was '\n'
+                std::uint64_t zeros = ~(((x & ~kHighs) + ~kHighs) | x) & kHighs;
+                while (zeros != 0)
+                {
+                    out.push_back(base + i + countTrailingZeros(zeros) / 8 + 1);
+                    zeros &= zeros - 1;
+                }
+            }
+            for (; i < size; ++i)
+            {
+                if (data[i] == '\n')
+                {
+                    out.push_back(base + i + 1);
+                }
+            }
+        }
+
+#ifdef SLC_HAVE_X86_SIMD
+        void findSse2(const char *data, std::size_t size, std::uint64_t base, std::vector<std::uint64_t> &out)
+        {
+            const __m128i newline = _mm_set1_epi8('\n');
+            std::size_t i = 0;
+            for (; i + 64 <= size; i += 64)
+            {
+                const auto *p = reinterpret_cast<const __m128i *>(data + i);
+                auto m0 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(p), newline)));
+                auto m1 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(p + 1), newline)));
+                auto m2 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(p + 2), newline)));
+                auto m3 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(p + 3), newline)));
+                std::uint64_t mask = m0 | (std::uint64_t{m1} << 16) | (std::uint64_t{m2} << 32) | (std::uint64_t{m3} << 48);
+                appendMatches(mask, base + i, out);
+            }
+            findScalar(data + i, size - i, base + i, out);
+        }
+
+        SLC_TARGET_AVX2 void findAvx2(const char *data, std::size_t size, std::uint64_t base, std::vector<std::uint64_t> &out)
+        {
+            const __m256i newline = _mm256_set1_epi8('\n');
+            std::size_t i = 0;
+            for (; i + 64 <= size; i += 64)
+            {
+                const auto *p = reinterpret_cast<const __m256i *>(data + i);
+                auto lo = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(p), newline)));
+                auto hi = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(p + 1), newline)));
+                appendMatches(lo | (std::uint64_t{hi} << 32), base + i, out);
+            }
+            findScalar(data + i, size - i, base + i, out);
+        }
+
+        // Counting needs no positions: each compare adds 1 per '\n' to a byte counter, and the counters
+        // are summed before any of them can wrap
+        std::size_t countSse2(const char *data, std::size_t size) noexcept
+        {
+            const __m128i newline = _mm_set1_epi8('\n');
+            std::size_t count = 0;
+            std::size_t i = 0;
+            while (i + 16 <= size)
+            {
+                __m128i counters = _mm_setzero_si128();
+                for (int n = 0; n < 255 && i + 16 <= size; ++n, i += 16)
+                {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                    counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(bytes, newline));
+                }
+                const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+                count += static_cast<std::size_t>(_mm_cvtsi128_si64(sums)) +
+                         static_cast<std::size_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+            }
+            return count + static_cast<std::size_t>(std::count(data + i, data + size, '\n'));
+        }
+
+        SLC_TARGET_AVX2 std::size_t countAvx2(const char *data, std::size_t size) noexcept
+        {
+            const __m256i newline = _mm256_set1_epi8('\n');
+            std::size_t count = 0;
+            std::size_t i = 0;
+            while (i + 32 <= size)
+            {
+                __m256i counters = _mm256_setzero_si256();
+                for (int n = 0; n < 255 && i + 32 <= size; ++n, i += 32)
+                {
+                    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                    counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(bytes, newline));
+                }
+                const __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+                count += static_cast<std::size_t>(_mm256_extract_epi64(sums, 0)) +
+                         static_cast<std::size_t>(_mm256_extract_epi64(sums, 1)) +
+                         static_cast<std::size_t>(_mm256_extract_epi64(sums, 2)) +
+                         static_cast<std::size_t>(_mm256_extract_epi64(sums, 3));
+            }
+            return count + static_cast<std::size_t>(std::count(data + i, data + size, '\n'));
+        }
+#endif
+    } // anonymous namespace
+
+    const char *newlineScannerName(NewlineScanner scanner) noexcept
+    {
+        switch (scanner)
+        {
+        case NewlineScanner::Scalar:
+            return "scalar";
+        case NewlineScanner::Sse2:
+            return "sse2";
+        case NewlineScanner::Avx2:
+            return "avx2";
+        }
+        return "";
+    }
+
+    NewlineScanner bestNewlineScanner() noexcept
+    {
+#ifdef SLC_HAVE_X86_SIMD
+        return cpuHasAvx2() ? NewlineScanner::Avx2 : NewlineScanner::Sse2;
+#else
+        return NewlineScanner::Scalar;
+#endif
+    }
+
+    void findLineStarts(const char *data, std::size_t size, std::uint64_t base, std::vector<std::uint64_t> &out,
+                        NewlineScanner scanner)
+    {
+#ifdef SLC_HAVE_X86_SIMD
+        switch (scanner)
+        {
+        case NewlineScanner::Avx2:
+            findAvx2(data, size, base, out);
+            return;
+        case NewlineScanner::Sse2:
+            findSse2(data, size, base, out);
+            return;
+        case NewlineScanner::Scalar:
+            break;
+        }
+#else
+        (void)scanner;
+#endif
+        findScalar(data, size, base, out);
+    }
+
+    std::size_t countNewlines(const char *data, std::size_t size, NewlineScanner scanner) noexcept
+    {
+#ifdef SLC_HAVE_X86_SIMD
+        switch (scanner)
+        {
+        case NewlineScanner::Avx2:
+            return countAvx2(data, size);
+        case NewlineScanner::Sse2:
+            return countSse2(data, size);
+        case NewlineScanner::Scalar:
+            break;
+        }
+#else
+        (void)scanner;
+#endif
+        return static_cast<std::size_t>(std::count(data, data + size, '\n'));
+    }
+
+    LineIndex::~LineIndex()
+    {
+        cancel();
+    }
+
+    void LineIndex::start(const char *data, std::size_t size, NewlineScanner scanner)
+    {
+        cancel();
+        cancel_.store(false, std::memory_order_relaxed);
+        if (size > 0)
+        {
+            starts_.append({0});
+        }
+        worker_ = std::thread([this, data, size, scanner]
+                              { run(data, 0, size, scanner); });
+    }
+
+    void LineIndex::resume(const char *data, std::size_t size, NewlineScanner scanner)
+    {
+        wait();
+        const std::size_t begin = indexedBytes();
+        if (size <= begin)
+        {
+            return;
+        }
+
+        // A trailing '\n' ended the last line without starting one; now there is a line after it.
+        // Publishing that start before clearing complete_ keeps every finished line visible meanwhile.
+        if (begin == 0 || data[begin - 1] == '\n')
+        {
+            starts_.append({static_cast<std::uint64_t>(begin)});
+        }
+        cancel_.store(false, std::memory_order_relaxed);
+        complete_.store(false, std::memory_order_release);
+        worker_ = std::thread([this, data, begin, size, scanner]
+                              { run(data, begin, size, scanner); });
+    }
+
+    void LineIndex::cancel() noexcept
+    {
+        cancel_.store(true, std::memory_order_relaxed);
+        if (worker_.joinable())
+        {
+            worker_.join();
+        }
+        starts_.clear();
+        indexedBytes_.store(0, std::memory_order_relaxed);
+        complete_.store(false, std::memory_order_relaxed);
+    }
+
+    void LineIndex::wait()
+    {
+        if (worker_.joinable())
+        {
+            worker_.join();
+        }
+    }
+
+    std::size_t LineIndex::lineCount() const noexcept
+    {
+        // Read complete_ first: once it is set, every start has been published
+        const bool complete = isComplete();
+        const std::size_t starts = startCount();
+        return complete || starts == 0 ? starts : starts - 1;
+    }
+
+    void LineIndex::run(const char *data, std::size_t begin, std::size_t size, NewlineScanner scanner)
+    {
+        std::vector<std::uint64_t> starts;
+        starts.reserve(kChunkBytes / 32);
+
+        for (std::size_t offset = begin; offset < size; offset += kChunkBytes)
+        {
+            if (cancel_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            const std::size_t length = std::min(kChunkBytes, size - offset);
+            findLineStarts(data + offset, length, offset, starts, scanner);
+            if (!starts.empty() && starts.back() == size)
+            {
+                starts.pop_back(); // a final '\n' ends the last line rather than starting another
+            }
+            starts_.append(starts);
+            starts.clear();
+            indexedBytes_.store(offset + length, std::memory_order_relaxed);
+        }
+        complete_.store(true, std::memory_order_release);
+    }
+}
@@ -0,0 +1,319 @@
+#include "log_bundle.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <system_error>
+
+namespace SteamUtils
+{
+    namespace
+    {
+        constexpr std::size_t kCopyBufferSize = 1024 * 1024;
+
+        /**
+         * Copies up to length bytes (all of in when length is unbounded) and returns
+         * the number of bytes moved.
+         */
+        std::uint64_t copyStream(std::istream &in, std::ostream &out, std::uint64_t length, bool &ok)
+        {
+            std::unique_ptr<char[]> buffer(new char[kCopyBufferSize]);
+            std::uint64_t copied = 0;
+            ok = true;
+
+            while (copied < length)
+            {
+                std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(kCopyBufferSize, length - copied));
+                in.read(buffer.get(), static_cast<std::streamsize>(chunk));
+                std::streamsize bytesRead = in.gcount();
+                if (bytesRead <= 0)
+                {
+                    break;
+                }
+                if (!out.write(buffer.get(), bytesRead))
+                {
+                    ok = false;
+                    break;
+                }
+                copied += static_cast<std::uint64_t>(bytesRead);
+            }
+            if (in.bad())
+            {
+                ok = false;
+            }
+            return copied;
+        }
+
+        /**
+         * True for a bare file name: member names become output paths on extraction,
+         * so anything that could climb out of or replace the destination is refused.
+         */
+        bool isPlainMemberName(std::string_view name)
+        {
+            return !name.empty() && name != "." && name != ".." &&
+                   name.find_first_of(std::string_view("/\\\0", 3)) == std::string_view::npos &&
+                   !fs::path(name).has_root_path();
+        }
+    } // anonymous namespace
+
+    BundleWriter::~BundleWriter()
+    {
+        abandon();
+    }
+
+    void BundleWriter::abandon() noexcept
+    {
+        if (out_.is_open())
+        {
+            out_.close();
+            std::error_code ec;
+            fs::remove(tempPath_, ec);
+        }
+    }
+
+    bool BundleWriter::open(const fs::path &bundlePath, std::string_view gameName)
+    {
+        abandon();
+        entries_.clear();
+        strings_.clear();
+
+        bundlePath_ = bundlePath;
+        tempPath_ = bundlePath;
+        tempPath_ += ".tmp";
+
+        out_.open(tempPath_, std::ios::binary | std::ios::trunc);
+        if (!out_.is_open())
+        {
+            Logger::log("Failed to create bundle: " + tempPath_.string(), SeverityLevel::Err);
+            return false;
+        }
+
+        BundleHeader header{};
+        std::memcpy(header.magic, kBundleMagic, sizeof(header.magic));
+        header.version = kBundleVersion;
+        out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        offset_ = sizeof(header);
+        gameName_ = intern(gameName);
+        return static_cast<bool>(out_);
+    }
+
+    BundleString BundleWriter::intern(std::string_view text)
+    {
+        BundleString result{strings_.size(), static_cast<std::uint32_t>(text.size()), 0};
+        strings_.append(text);
+        return result;
+    }
+
+    bool BundleWriter::addFile(const fs::path &source, std::string_view name, std::string_view type,
+                               std::int64_t lastModifiedNs)
+    {
+        if (!isPlainMemberName(name))
+        {
+            Logger::log("Refusing bundle member name: " + std::string(name), SeverityLevel::Err);
+            return false;
+        }
+
+        std::ifstream in(source, std::ios::binary);
+        if (!in.is_open())
+        {
+            Logger::log("Failed to open for bundling: " + source.string(), SeverityLevel::Err);
+            return false;
+        }
+
+        // The size is whatever was read: logs may still be growing while they are bundled
+        bool ok = false;
+        std::uint64_t size = copyStream(in, out_, UINT64_MAX, ok);
+        if (!ok)
+        {
+            Logger::log("Failed to bundle " + source.string(), SeverityLevel::Err);
+            // Keep the offsets consistent with what actually reached the file
+            offset_ += size;
+            return false;
+        }
+
+        BundleEntry entry{};
+        entry.dataOffset = offset_;
+        entry.size = size;
+        entry.lastModifiedNs = lastModifiedNs;
+        entry.name = intern(name);
+        entry.originalPath = intern(source.string());
+        entry.type = intern(type);
+        entries_.push_back(entry);
+
+        offset_ += size;
+        return static_cast<bool>(out_);
+    }
+
+    bool BundleWriter::finish()
+    {
+        if (!out_.is_open())
+        {
+            return false;
+        }
+
+        BundleFooter footer{};
+        footer.entriesOffset = offset_;
+        footer.entryCount = entries_.size();
+        footer.stringsOffset = offset_ + entries_.size() * sizeof(BundleEntry);
+        footer.stringsSize = strings_.size();
+        footer.createdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+        footer.gameName = gameName_;
+        std::memcpy(footer.magic, kBundleIndexMagic, sizeof(footer.magic));
+        footer.version = kBundleVersion;
+
+        out_.write(reinterpret_cast<const char *>(entries_.data()),
+                   static_cast<std::streamsize>(entries_.size() * sizeof(BundleEntry)));
+        out_.write(strings_.data(), static_cast<std::streamsize>(strings_.size()));
+        out_.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+        out_.close();
+
+        std::error_code ec;
+        if (out_.fail())
+        {
+            Logger::log("Failed to write bundle index: " + tempPath_.string(), SeverityLevel::Err);
+            fs::remove(tempPath_, ec);
+            return false;
+        }
+
+        fs::rename(tempPath_, bundlePath_, ec);
+        if (ec)
+        {
+            Logger::log("Failed to move bundle into place " + bundlePath_.string() + ": " + ec.message(), SeverityLevel::Err);
+            fs::remove(tempPath_, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool BundleReader::open(const fs::path &bundlePath)
+    {
+        members_.clear();
+        gameName_.clear();
+        in_.close();
+        in_.clear();
+
+        in_.open(bundlePath, std::ios::binary);
+        if (!in_.is_open())
+        {
+            return false;
+        }
+
+        in_.seekg(0, std::ios::end);
+        fileSize_ = static_cast<std::uint64_t>(in_.tellg());
+        if (fileSize_ < sizeof(BundleHeader) + sizeof(BundleFooter))
+        {
+            return false;
+        }
+
+        BundleHeader header{};
+        BundleFooter footer{};
+        in_.seekg(0);
+        in_.read(reinterpret_cast<char *>(&header), sizeof(header));
+        in_.seekg(static_cast<std::streamoff>(fileSize_ - sizeof(BundleFooter)));
+        in_.read(reinterpret_cast<char *>(&footer), sizeof(footer));
+
+        const std::uint64_t indexEnd = fileSize_ - sizeof(BundleFooter);
+        bool valid = in_ &&
+                     std::memcmp(header.magic, kBundleMagic, sizeof(kBundleMagic)) == 0 &&
+                     std::memcmp(footer.magic, kBundleIndexMagic, sizeof(kBundleIndexMagic)) == 0 &&
+                     header.version == kBundleVersion && footer.version == kBundleVersion &&
+                     footer.entriesOffset <= indexEnd &&
+                     footer.entryCount <= (indexEnd - footer.entriesOffset) / sizeof(BundleEntry) &&
+                     footer.stringsOffset == footer.entriesOffset + footer.entryCount * sizeof(BundleEntry) &&
+                     footer.stringsSize == indexEnd - footer.stringsOffset;
+        if (!valid)
+        {
+            Logger::log("Not a valid log bundle: " + bundlePath.string(), SeverityLevel::Err);
+            return false;
+        }
+
+        std::vector<BundleEntry> entries(static_cast<std::size_t>(footer.entryCount));
+        std::string strings(static_cast<std::size_t>(footer.stringsSize), '\0');
+        in_.seekg(static_cast<std::streamoff>(footer.entriesOffset));
+        in_.read(reinterpret_cast<char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BundleEntry)));
+        in_.read(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!in_)
+        {
+            return false;
+        }
+
+        auto text = [&strings](const BundleString &s, std::string &out)
+        {
+            if (s.offset > strings.size() || s.length > strings.size() - s.offset)
+            {
+                return false;
+            }
+            out.assign(strings, static_cast<std::size_t>(s.offset), s.length);
+            return true;
+        };
+
+        valid = text(footer.gameName, gameName_);
+        members_.reserve(entries.size());
+        for (const auto &entry : entries)
+        {
+            BundleMember member;
+            member.dataOffset = entry.dataOffset;
+            member.size = entry.size;
+            member.lastModifiedNs = entry.lastModifiedNs;
+            valid = valid && entry.dataOffset >= sizeof(BundleHeader) && entry.dataOffset <= footer.entriesOffset &&
+                    entry.size <= footer.entriesOffset - entry.dataOffset &&
+                    text(entry.name, member.name) && isPlainMemberName(member.name) &&
+                    text(entry.originalPath, member.originalPath) && text(entry.type, member.type);
+            members_.push_back(std::move(member));
+        }
+
+        if (!valid)
+        {
+            Logger::log("Corrupt log bundle index: " + bundlePath.string(), SeverityLevel::Err);
+            members_.clear();
+            return false;
+        }
+
+        createdNs_ = footer.createdNs;
+        return true;
+    }
+
+    std::optional<std::size_t> BundleReader::find(std::string_view key) const
+    {
+        for (std::size_t i = 0; i < members_.size(); ++i)
+        {
+            if (members_[i].name == key)
+            {
+                return i;
+            }
+        }
+
+        std::size_t position = 0;
+        auto [end, ec] = std::from_chars(key.data(), key.data() + key.size(), position);
+        if (ec == std::errc() && end == key.data() + key.size() && position >= 1 && position <= members_.size())
+        {
+            return position - 1;
+        }
+        return std::nullopt;
+    }
+
+    bool BundleReader::extract(const BundleMember &member, std::ostream &out)
+    {
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(member.dataOffset));
+        bool ok = false;
+        std::uint64_t copied = copyStream(in_, out, member.size, ok);
+        return ok && copied == member.size;
+    }
+
+    bool BundleReader::extract(const BundleMember &member, const fs::path &destination)
+    {
+        std::ofstream out(destination, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+        {
+            Logger::log("Failed to create " + destination.string(), SeverityLevel::Err);
+            return false;
+        }
+        return extract(member, out) && static_cast<bool>(out.flush());
+    }
+}
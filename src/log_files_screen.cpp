@@ -2,7 +2,16 @@
 
 #include <imgui.h>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "colors.hpp"
 #include "fonts.hpp"
@@ -11,6 +20,535 @@
 #include "steam-utils.hpp"
 #include "file_preview.hpp"
 
+namespace
+{
+    // Formats the rows from index first whose strings are missing or older than their file
+    void RefreshLogRowText(AppState &state, size_t first)
+    {
+        for (size_t i = first; i < state.logFiles.size(); ++i)
+        {
+            const auto &log = state.logFiles[i];
+            LogRowText &text = state.logRowText[i];
+            if (text.size.empty() || text.sizeBytes != log.size || text.modifiedNs != log.lastModifiedNs)
+            {
+                text.size = SteamUtils::formatFileSize(log.size);
+                text.modified = SteamUtils::formatTimestamp(log.lastModifiedNs);
+                text.sizeBytes = log.size;
+                text.modifiedNs = log.lastModifiedNs;
+            }
+        }
+    }
+
+    // Gives the logs appended to state.logFiles from index first their per-row UI state
+    void AddLogRows(AppState &state, size_t first)
+    {
+        state.logRowText.resize(state.logFiles.size());
+        state.selectedLogs.resize(state.logFiles.size(), false);
+        RefreshLogRowText(state, first);
+        state.logOrderDirty = true;
+    }
+
+    void SetLogSelected(AppState &state, size_t index, bool selected)
+    {
+        if (state.selectedLogs[index] != selected)
+        {
+            state.selectedLogs[index] = selected;
+            if (selected)
+                state.selectedLogCount++;
+            else
+                state.selectedLogCount--;
+        }
+    }
+
+    void SetAllLogsSelected(AppState &state, bool selected)
+    {
+        std::fill(state.selectedLogs.begin(), state.selectedLogs.end(), selected);
+        state.selectedLogCount = selected ? state.selectedLogs.size() : 0;
+    }
+
+    [[nodiscard]] int CompareLogs(const SteamUtils::LogFile &a, const SteamUtils::LogFile &b, LogSortKey::Column column)
+    {
+        switch (column)
+        {
+        case LogSortKey::Column::Name:
+            return a.filename.compare(b.filename);
+        case LogSortKey::Column::Type:
+            return a.type.compare(b.type);
+        case LogSortKey::Column::Size:
+            return a.size < b.size ? -1 : (a.size > b.size ? 1 : 0);
+        case LogSortKey::Column::Modified:
+            return a.lastModifiedNs < b.lastModifiedNs ? -1 : (a.lastModifiedNs > b.lastModifiedNs ? 1 : 0);
+        }
+        return 0;
+    }
+
+    // Rebuilds the row permutation after the logs or the sort changed; the logs themselves never move
+    void SortLogRows(AppState &state)
+    {
+        if (!state.logOrderDirty)
+        {
+            return;
+        }
+        state.logOrderDirty = false;
+
+        const auto &logs = state.logFiles;
+        state.logOrder.resize(logs.size());
+        std::iota(state.logOrder.begin(), state.logOrder.end(), size_t{0});
+        std::sort(state.logOrder.begin(), state.logOrder.end(),
+                  [&state, &logs](size_t a, size_t b)
+                  {
+                      for (const LogSortKey &key : state.logSort)
+                      {
+                          int order = CompareLogs(logs[a], logs[b], key.column);
+                          if (order != 0)
+                          {
+                              return key.descending ? order > 0 : order < 0;
+                          }
+                      }
+                      // Rows arrive in whatever order the scan threads finish, so fall back on the path
+                      return logs[a].path < logs[b].path;
+                  });
+    }
+
+    // Mirrors watcher changes onto the per-row UI state that parallels state.logFiles
+    void ApplyLogChanges(AppState &state)
+    {
+        const auto changes = state.logWatcher.poll(state.logFiles, 0);
+        for (const auto &change : changes)
+        {
+            const int index = static_cast<int>(change.index);
+            switch (change.kind)
+            {
+            case SteamUtils::LogChange::Kind::Added:
+                state.selectedLogs.push_back(false);
+                state.logRowText.emplace_back();
+                break;
+            case SteamUtils::LogChange::Kind::Modified:
+                break;
+            case SteamUtils::LogChange::Kind::Removed:
+                SetLogSelected(state, change.index, false);
+                state.selectedLogs.erase(state.selectedLogs.begin() + index);
+                state.logRowText.erase(state.logRowText.begin() + index);
+                if (state.previewLogIndex == index)
+                {
+                    state.previewLogIndex = -1;
+                    state.showPreviewWindow = false;
+                }
+                else if (state.previewLogIndex > index)
+                {
+                    state.previewLogIndex--;
+                }
+                break;
+            }
+        }
+
+        // Indices in the list refer to the log as it was at each step, so the text is brought up to date afterwards
+        if (!changes.empty())
+        {
+            RefreshLogRowText(state, 0);
+            state.logOrderDirty = true;
+        }
+    }
+
+    void StartCopy(AppState &state, const std::string &gameName, std::filesystem::path outputDir)
+    {
+        std::vector<SteamUtils::LogFile> selectedLogFiles;
+        std::uint64_t totalBytes = 0;
+        for (size_t i = 0; i < state.logFiles.size(); ++i)
+        {
+            if (state.selectedLogs[i])
+            {
+                selectedLogFiles.push_back(state.logFiles[i]);
+                totalBytes += state.logFiles[i].size;
+            }
+        }
+
+        CopyTask &task = state.copyTask;
+        task.filesDone = 0;
+        task.fileCount = selectedLogFiles.size();
+        task.bytesCopied = 0;
+        task.totalBytes = totalBytes;
+        task.bytesPerSecond = 0;
+        task.finished = false;
+        task.running = true;
+        task.outputDir = outputDir;
+
+        task.worker = std::thread(
+            [&task, gameName, outputDir = std::move(outputDir), logFiles = std::move(selectedLogFiles)]
+            {
+                task.copiedCount = SteamUtils::copyLogsToDirectory(
+                    logFiles, outputDir, gameName,
+                    [&task](const SteamUtils::CopyProgress &progress)
+                    {
+                        task.filesDone = progress.jobsDone;
+                        task.bytesCopied = progress.totalBytesCopied;
+                        task.bytesPerSecond = static_cast<std::uint64_t>(progress.bytesPerSecond);
+                    });
+                task.finished = true;
+            });
+    }
+
+    void StartGrep(AppState &state)
+    {
+        GrepTask &task = state.grepTask;
+        if (task.running)
+        {
+            return;
+        }
+        if (!task.matcher.compile(task.query, task.options))
+        {
+            UIToast::Error("Cannot search: " + task.matcher.error());
+            return;
+        }
+
+        task.logFiles = state.logFiles;
+        task.hits.clear();
+        task.stats = {};
+        task.filesDone = 0;
+        task.cancel = false;
+        task.finished = false;
+        task.running = true;
+        task.showResults = true;
+
+        task.worker = std::thread(
+            [&task]
+            {
+                SteamUtils::GrepOptions options;
+                options.cancel = &task.cancel;
+                options.onHits = [&task](const std::vector<SteamUtils::GrepHit> &hits)
+                {
+                    std::lock_guard<std::mutex> lock(task.mutex);
+                    task.hits.insert(task.hits.end(), hits.begin(), hits.end());
+                };
+                options.onProgress = [&task](const SteamUtils::GrepProgress &progress)
+                {
+                    task.filesDone = progress.filesDone;
+                };
+                task.stats = SteamUtils::grepLogs(task.logFiles, task.matcher, options);
+                task.finished = true;
+            });
+    }
+
+    // Also used to stop a running search before the log list it was started from goes away
+    void StopGrep(AppState &state)
+    {
+        GrepTask &task = state.grepTask;
+        task.cancel = true;
+        if (task.worker.joinable())
+        {
+            task.worker.join();
+        }
+        task.running = false;
+    }
+
+    void FinishGrepIfDone(AppState &state)
+    {
+        if (state.grepTask.running && state.grepTask.finished)
+        {
+            StopGrep(state);
+        }
+    }
+
+    void OpenGrepHit(AppState &state, const SteamUtils::GrepHit &hit)
+    {
+        const GrepTask &task = state.grepTask;
+        const auto &path = task.logFiles[hit.fileIndex].path;
+        const auto it = std::find_if(state.logFiles.begin(), state.logFiles.end(),
+                                     [&path](const SteamUtils::LogFile &log)
+                                     { return log.path == path; });
+        if (it == state.logFiles.end())
+        {
+            UIToast::Error("That log is no longer in the list.");
+            return;
+        }
+
+        // The preview searches for the same thing and selects this hit once its search gets there
+        std::snprintf(state.previewQuery, sizeof(state.previewQuery), "%s", task.query);
+        state.previewSearchOptions = task.options;
+        if (!OpenPreview(state, static_cast<int>(it - state.logFiles.begin())))
+        {
+            UIToast::Error("Could not open file for preview.");
+            return;
+        }
+        state.previewJumpOffset = hit.offset;
+        state.previewScrollToMatch = false;
+    }
+
+    void RenderGrepBar(AppState &state)
+    {
+        GrepTask &task = state.grepTask;
+        const bool searching = task.running;
+
+        ImGui::SetNextItemWidth(320.0f);
+        const bool enter = ImGui::InputTextWithHint("##GrepQuery", "Search all logs...", task.query, sizeof(task.query),
+                                                    ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::SameLine();
+        ImGui::Checkbox("Ignore case##Grep", &task.options.ignoreCase);
+        ImGui::SameLine();
+        ImGui::Checkbox("Regex##Grep", &task.options.regex);
+        ImGui::SameLine();
+
+        if (searching)
+        {
+            if (UIWidgets::SecondaryButton("Cancel Search", ImVec2(140, 0)))
+            {
+                task.cancel = true;
+            }
+        }
+        else
+        {
+            // Searching a list that is still growing would quietly skip the logs found later
+            const bool unavailable = task.query[0] == '\0' || state.scanningLogs;
+            if (unavailable)
+                ImGui::BeginDisabled();
+            if (UIWidgets::PrimaryButton("Search", ImVec2(100, 0)) || (enter && !unavailable))
+            {
+                StartGrep(state);
+            }
+            if (unavailable)
+                ImGui::EndDisabled();
+        }
+
+        if (!task.showResults)
+        {
+            return;
+        }
+
+        size_t hitCount;
+        {
+            std::lock_guard<std::mutex> lock(task.mutex);
+            hitCount = task.hits.size();
+        }
+        ImGui::SameLine();
+        if (task.running)
+        {
+            ImGui::TextDisabled("Searching... %zu / %zu files, %zu matching lines", task.filesDone.load(),
+                                task.logFiles.size(), hitCount);
+            return;
+        }
+
+        std::string summary = std::to_string(task.stats.hits) + " matching lines in " +
+                              std::to_string(task.stats.filesWithHits) + " of " + std::to_string(task.logFiles.size()) +
+                              " files";
+        if (task.stats.truncated)
+            summary += " (stopped at the limit)";
+        else if (task.stats.cancelled)
+            summary += " (cancelled)";
+        if (task.stats.clippedLines > 0)
+            summary += ", " + std::to_string(task.stats.clippedLines) + " long lines only partly searched";
+        ImGui::TextDisabled("%s", summary.c_str());
+
+        ImGui::SameLine();
+        if (UIWidgets::SecondaryButton("Clear Results", ImVec2(140, 0)))
+        {
+            task.showResults = false;
+            std::lock_guard<std::mutex> lock(task.mutex);
+            task.hits.clear();
+            task.hits.shrink_to_fit();
+        }
+    }
+
+    void RenderGrepResults(AppState &state, ImVec2 size)
+    {
+        GrepTask &task = state.grepTask;
+        ImGui::BeginChild("GrepResults", size, true);
+
+        std::optional<SteamUtils::GrepHit> clicked;
+        if (ImGui::BeginTable("GrepTable", 3,
+                              ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                  ImGuiTableFlags_ScrollY |
+                                  ImGuiTableFlags_Resizable |
+                                  ImGuiTableFlags_SizingStretchProp))
+        {
+            ImGui::TableSetupColumn("File", ImGuiTableColumnFlags_WidthStretch, 1.2f);
+            ImGui::TableSetupColumn("Line", ImGuiTableColumnFlags_WidthFixed, 80);
+            ImGui::TableSetupColumn("Text (click to preview)", ImGuiTableColumnFlags_WidthStretch, 4.0f);
+            ImGui::TableHeadersRow();
+
+            // The worker appends while we draw; only the visible rows are read under the lock
+            std::unique_lock<std::mutex> lock(task.mutex);
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(task.hits.size()));
+            while (clipper.Step())
+            {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                {
+                    const auto &hit = task.hits[i];
+                    ImGui::TableNextRow();
+
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable(task.logFiles[hit.fileIndex].filename.c_str(), false,
+                                          ImGuiSelectableFlags_SpanAllColumns))
+                    {
+                        clicked = hit;
+                    }
+                    ImGui::PopID();
+
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::TextColored(UIColors::LightTeal, "%llu", static_cast<unsigned long long>(hit.lineNumber));
+
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::TextUnformatted(hit.context.data(), hit.context.data() + hit.context.size());
+                }
+            }
+            clipper.End();
+            lock.unlock();
+
+            ImGui::EndTable();
+        }
+        ImGui::EndChild();
+
+        if (clicked)
+        {
+            OpenGrepHit(state, *clicked);
+        }
+    }
+
+    void CancelLogScan(AppState &state, bool discard)
+    {
+        if (state.scanningLogs)
+        {
+            state.logScan.cancel = true;
+            state.logScan.discard = state.logScan.discard || discard;
+        }
+    }
+
+    void RenderScanStatus(AppState &state, float contentWidth)
+    {
+        LogScanTask &task = state.logScan;
+        if (task.cancel)
+        {
+            ImGui::TextDisabled("Stopping the scan...");
+            return;
+        }
+
+        ImGui::TextColored(UIColors::LavenderBlue, "Scanning: %zu directories, %zu log files found",
+                           task.directoriesScanned.load(), task.filesFound.load());
+
+        float cancelButtonWidth = 140.0f;
+        ImGui::SameLine(contentWidth - cancelButtonWidth);
+        if (UIWidgets::SecondaryButton("Cancel Scan", ImVec2(cancelButtonWidth, 0)))
+        {
+            CancelLogScan(state, false);
+        }
+    }
+
+    void FinishCopyIfDone(AppState &state)
+    {
+        CopyTask &task = state.copyTask;
+        if (!task.running || !task.finished)
+        {
+            return;
+        }
+
+        task.worker.join();
+        task.running = false;
+        UIToast::Success("Copied " + std::to_string(task.copiedCount) +
+                         " log files to: " + task.outputDir.string());
+    }
+}
+
+bool StartLogScan(AppState &state, int gameIndex)
+{
+    LogScanTask &task = state.logScan;
+    if (state.scanningLogs)
+    {
+        return false;
+    }
+
+    state.selectedGameIndex = gameIndex;
+    state.logFiles.clear();
+    state.selectedLogs.clear();
+    state.logRowText.clear();
+    state.selectedLogCount = 0;
+    state.logOrderDirty = true;
+    state.previewLogIndex = -1;
+    state.showPreviewWindow = false;
+    state.statusMessage.clear();
+    state.errorMessage.clear();
+
+    task.finished = false;
+    task.cancel = false;
+    task.discard = false;
+    task.directoriesScanned = 0;
+    task.filesFound = 0;
+    task.pending.clear();
+    task.visited.clear();
+    task.maxDepth = SteamUtils::ScanOptions{}.maxDepth;
+
+    state.scanningLogs = true;
+    task.worker = std::thread([&task, steamDir = state.steamDir, game = state.games[gameIndex]]()
+                              {
+                                  SteamUtils::ScanOptions options;
+                                  options.maxDepth = task.maxDepth;
+                                  options.visitedDirectories = &task.visited;
+                                  options.cancel = &task.cancel;
+                                  options.onFiles = [&task](const std::vector<SteamUtils::LogFile> &files,
+                                                            const SteamUtils::ScanProgress &progress)
+                                  {
+                                      task.directoriesScanned = progress.directoriesScanned;
+                                      task.filesFound = progress.filesFound;
+                                      if (!files.empty())
+                                      {
+                                          std::lock_guard<std::mutex> lock(task.mutex);
+                                          task.pending.insert(task.pending.end(), files.begin(), files.end());
+                                      }
+                                  };
+
+                                  // Every file also went through onFiles, and the table sorts on its own
+                                  (void)SteamUtils::findGameLogs(steamDir, game, options);
+                                  task.finished = true; });
+
+    state.currentScreen = Screen::LogFiles;
+    return true;
+}
+
+void UpdateLogScan(AppState &state)
+{
+    if (!state.scanningLogs)
+    {
+        return;
+    }
+
+    LogScanTask &task = state.logScan;
+    // Read before draining: once it is set, pending already holds the last batch
+    const bool finished = task.finished;
+    {
+        std::lock_guard<std::mutex> lock(task.mutex);
+        if (!task.discard && !task.pending.empty())
+        {
+            const size_t first = state.logFiles.size();
+            std::move(task.pending.begin(), task.pending.end(), std::back_inserter(state.logFiles));
+            AddLogRows(state, first);
+        }
+        task.pending.clear();
+    }
+
+    if (!finished)
+    {
+        return;
+    }
+
+    task.worker.join();
+    state.scanningLogs = false;
+    if (task.discard)
+    {
+        task.visited.clear();
+        return;
+    }
+
+    if (task.cancel)
+    {
+        UIToast::Info("Scan cancelled with " + std::to_string(state.logFiles.size()) + " log files found.");
+    }
+    else
+    {
+        state.logWatcher.start(task.visited, task.maxDepth);
+    }
+    task.visited.clear();
+}
+
 void RenderLogFilesScreen(AppState &state)
 {
     if (state.selectedGameIndex < 0 ||
@@ -20,6 +558,10 @@ void RenderLogFilesScreen(AppState &state)
         return;
     }
 
+    ApplyLogChanges(state);
+    FinishCopyIfDone(state);
+    FinishGrepIfDone(state);
+
     const auto &game = state.games[state.selectedGameIndex];
 
     ImVec2 windowSize = ImGui::GetContentRegionAvail();
@@ -28,18 +570,34 @@ void RenderLogFilesScreen(AppState &state)
 
     ImGui::SetCursorPosX(padding);
 
-    // Back button
+    // Back button (the copy thread works from the current log list, so stay until it finishes)
+    const bool copying = state.copyTask.running;
+    if (copying)
+        ImGui::BeginDisabled();
+
     if (UIWidgets::SecondaryButton("< Back to Games", ImVec2(170, 35)))
     {
         state.currentScreen = Screen::GameSelection;
+        CancelLogScan(state, true);
+        StopGrep(state);
+        state.grepTask.showResults = false;
+        state.grepTask.hits.clear();
+        state.logWatcher.stop();
         state.logFiles.clear();
         state.selectedLogs.clear();
+        state.logRowText.clear();
+        state.selectedLogCount = 0;
+        state.logOrderDirty = true;
         state.selectedGameIndex = -1;
         state.previewLogIndex = -1;
+        state.showPreviewWindow = false;
         state.statusMessage.clear();
         state.errorMessage.clear();
     }
 
+    if (copying)
+        ImGui::EndDisabled();
+
     ImGui::Spacing();
     ImGui::Spacing();
 
@@ -88,6 +646,16 @@ void RenderLogFilesScreen(AppState &state)
     ImGui::PopFont();
     ImGui::PushFont(UIFonts::GetDefault());
     ImGui::Text("%zu", state.logFiles.size());
+    if (state.scanningLogs)
+    {
+        ImGui::SameLine();
+        ImGui::TextColored(UIColors::CoolGray, "(scanning)");
+    }
+    else if (state.logWatcher.isRunning())
+    {
+        ImGui::SameLine();
+        ImGui::TextColored(UIColors::Success, "(live)");
+    }
     ImGui::PopFont();
 
     ImGui::Columns(1);
@@ -97,6 +665,13 @@ void RenderLogFilesScreen(AppState &state)
     ImGui::Spacing();
     ImGui::Spacing();
 
+    if (state.scanningLogs)
+    {
+        ImGui::SetCursorPosX(padding);
+        RenderScanStatus(state, contentWidth);
+        ImGui::Spacing();
+    }
+
     // Log files section
     ImGui::SetCursorPosX(padding);
 
@@ -109,7 +684,7 @@ void RenderLogFilesScreen(AppState &state)
         ImGui::SetCursorPosY(centerY);
 
         ImGui::PushFont(UIFonts::GetLarge());
-        const char *noLogsText = "No Log Files Found";
+        const char *noLogsText = state.scanningLogs ? "Searching for Log Files..." : "No Log Files Found";
         float textWidth = ImGui::CalcTextSize(noLogsText).x;
         ImGui::SetCursorPosX((contentWidth - textWidth) / 2.0f);
         ImGui::TextColored(UIColors::CoolGray, "%s", noLogsText);
@@ -118,7 +693,8 @@ void RenderLogFilesScreen(AppState &state)
         ImGui::Spacing();
         ImGui::Spacing();
 
-        const char *helpText = "No log files were detected for this game.";
+        const char *helpText = state.scanningLogs ? "Files will appear here as they are found."
+                                                  : "No log files were detected for this game.";
         float helpWidth = ImGui::CalcTextSize(helpText).x;
         ImGui::SetCursorPosX((contentWidth - helpWidth) / 2.0f);
         ImGui::TextColored(UIColors::CoolGray, "%s", helpText);
@@ -134,7 +710,7 @@ void RenderLogFilesScreen(AppState &state)
 
         if (UIWidgets::SecondaryButton("Select All", ImVec2(130, buttonHeight)))
         {
-            std::fill(state.selectedLogs.begin(), state.selectedLogs.end(), true);
+            SetAllLogsSelected(state, true);
         }
 
         ImGui::SameLine();
@@ -142,7 +718,7 @@ void RenderLogFilesScreen(AppState &state)
         if (UIWidgets::SecondaryButton("Deselect All",
                                        ImVec2(150, buttonHeight)))
         {
-            std::fill(state.selectedLogs.begin(), state.selectedLogs.end(), false);
+            SetAllLogsSelected(state, false);
         }
 
         ImGui::SameLine();
@@ -157,27 +733,31 @@ void RenderLogFilesScreen(AppState &state)
         if (UIWidgets::SecondaryButton("Preview Selected",
                                        ImVec2(200, buttonHeight)))
         {
-            state.previewContent =
-                ReadFileContent(state.logFiles[state.previewLogIndex].path);
-            state.showPreviewWindow = true;
+            if (!OpenPreview(state, state.previewLogIndex))
+            {
+                UIToast::Error("Could not open file for preview.");
+            }
         }
 
         if (!canPreview)
             ImGui::EndDisabled();
 
         // Copy button on the right
-        int selectedCount = static_cast<int>(
-            std::count(state.selectedLogs.begin(), state.selectedLogs.end(), true));
+        const size_t selectedCount = state.selectedLogCount;
 
         float copyButtonWidth = 220.0f;
         ImGui::SameLine(contentWidth - copyButtonWidth);
 
-        if (selectedCount == 0)
+        const bool copyDisabled = selectedCount == 0 || copying;
+        if (copyDisabled)
             ImGui::BeginDisabled();
 
-        std::string copyText =
-            "Copy Selected (" + std::to_string(selectedCount) + ")";
-        if (UIWidgets::PrimaryButton(copyText.c_str(),
+        char copyText[64];
+        if (copying)
+            std::snprintf(copyText, sizeof(copyText), "Copying...");
+        else
+            std::snprintf(copyText, sizeof(copyText), "Copy Selected (%zu)", selectedCount);
+        if (UIWidgets::PrimaryButton(copyText,
                                      ImVec2(copyButtonWidth, buttonHeight)))
         {
             std::filesystem::path outputDir =
@@ -185,20 +765,7 @@ void RenderLogFilesScreen(AppState &state)
 
             if (!outputDir.empty())
             {
-                std::vector<SteamUtils::LogFile> selectedLogFiles;
-                for (size_t i = 0; i < state.logFiles.size(); ++i)
-                {
-                    if (state.selectedLogs[i])
-                    {
-                        selectedLogFiles.push_back(state.logFiles[i]);
-                    }
-                }
-
-                int copied = SteamUtils::copyLogsToDirectory(
-                    selectedLogFiles, outputDir, game.name);
-                UIToast::Success(
-                    "Copied " + std::to_string(copied) +
-                    " log files to: " + outputDir.string());
+                StartCopy(state, game.name, std::move(outputDir));
             }
             else
             {
@@ -206,11 +773,26 @@ void RenderLogFilesScreen(AppState &state)
             }
         }
 
-        if (selectedCount == 0)
+        if (copyDisabled)
             ImGui::EndDisabled();
 
         ImGui::EndGroup();
 
+        if (copying)
+        {
+            const CopyTask &task = state.copyTask;
+            std::uint64_t total = task.totalBytes;
+            float fraction = total > 0
+                                 ? static_cast<float>(static_cast<double>(task.bytesCopied) / static_cast<double>(total))
+                                 : 0.0f;
+            std::string overlay =
+                std::to_string(task.filesDone.load()) + " / " + std::to_string(task.fileCount.load()) + " files  -  " +
+                SteamUtils::formatFileSize(task.bytesPerSecond) + "/s";
+
+            ImGui::Spacing();
+            ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(contentWidth, 0), overlay.c_str());
+        }
+
         ImGui::Spacing();
 
         // Status/error messages
@@ -243,8 +825,17 @@ void RenderLogFilesScreen(AppState &state)
             ImGui::Spacing();
         }
 
-        // Log files table
+        RenderGrepBar(state);
+        ImGui::Spacing();
+
+        // Log files table, sharing the space with the search results when there are any
         float tableHeight = windowSize.y - ImGui::GetCursorPosY() - padding;
+        float resultsHeight = 0.0f;
+        if (state.grepTask.showResults)
+        {
+            resultsHeight = tableHeight * 0.45f;
+            tableHeight -= resultsHeight + ImGui::GetStyle().ItemSpacing.y;
+        }
         ImGui::BeginChild("LogFilesTable", ImVec2(contentWidth, tableHeight),
                           true);
 
@@ -252,65 +843,102 @@ void RenderLogFilesScreen(AppState &state)
                               ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
                                   ImGuiTableFlags_ScrollY |
                                   ImGuiTableFlags_Resizable |
-                                  ImGuiTableFlags_SizingStretchProp))
+                                  ImGuiTableFlags_SizingStretchProp |
+                                  ImGuiTableFlags_Sortable |
+                                  ImGuiTableFlags_SortMulti))
         {
-            ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed, 40);
+            using Column = LogSortKey::Column;
+            ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_NoSort, 40);
             ImGui::TableSetupColumn("File Name",
-                                    ImGuiTableColumnFlags_WidthStretch, 3.0f);
+                                    ImGuiTableColumnFlags_WidthStretch, 3.0f,
+                                    static_cast<ImGuiID>(Column::Name));
             ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthStretch,
-                                    1.0f);
-            ImGui::TableSetupColumn("Size", ImGuiTableColumnFlags_WidthStretch,
-                                    0.8f);
+                                    1.0f, static_cast<ImGuiID>(Column::Type));
+            ImGui::TableSetupColumn("Size", ImGuiTableColumnFlags_WidthStretch |
+                                                ImGuiTableColumnFlags_PreferSortDescending,
+                                    0.8f, static_cast<ImGuiID>(Column::Size));
             ImGui::TableSetupColumn("Modified",
-                                    ImGuiTableColumnFlags_WidthStretch, 1.2f);
+                                    ImGuiTableColumnFlags_WidthStretch |
+                                        ImGuiTableColumnFlags_DefaultSort |
+                                        ImGuiTableColumnFlags_PreferSortDescending,
+                                    1.2f, static_cast<ImGuiID>(Column::Modified));
+            ImGui::TableSetupScrollFreeze(0, 1);
             ImGui::TableHeadersRow();
 
-            for (size_t i = 0; i < state.logFiles.size(); ++i)
+            // Shift+click adds a column to the sort
+            if (ImGuiTableSortSpecs *sortSpecs = ImGui::TableGetSortSpecs();
+                sortSpecs != nullptr && sortSpecs->SpecsDirty)
             {
-                const auto &log = state.logFiles[i];
-                ImGui::TableNextRow();
+                state.logSort.clear();
+                for (int i = 0; i < sortSpecs->SpecsCount; ++i)
+                {
+                    const ImGuiTableColumnSortSpecs &spec = sortSpecs->Specs[i];
+                    state.logSort.push_back({static_cast<Column>(spec.ColumnUserID),
+                                             spec.SortDirection == ImGuiSortDirection_Descending});
+                }
+                sortSpecs->SpecsDirty = false;
+                state.logOrderDirty = true;
+            }
+            SortLogRows(state);
 
-                ImGui::TableSetColumnIndex(0);
-                ImGui::PushID(static_cast<int>(i));
-                bool selected = state.selectedLogs[i];
-                if (ImGui::Checkbox("##select", &selected))
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(state.logOrder.size()));
+            while (clipper.Step())
+            {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
                 {
-                    state.selectedLogs[i] = selected;
-                    if (selected)
+                    const size_t i = state.logOrder[row];
+                    const auto &log = state.logFiles[i];
+                    const auto &text = state.logRowText[i];
+                    ImGui::TableNextRow();
+
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::PushID(static_cast<int>(i));
+                    bool selected = state.selectedLogs[i];
+                    if (ImGui::Checkbox("##select", &selected))
                     {
-                        state.previewLogIndex = static_cast<int>(i);
+                        SetLogSelected(state, i, selected);
+                        if (selected)
+                        {
+                            state.previewLogIndex = static_cast<int>(i);
+                        }
                     }
-                }
-                ImGui::PopID();
 
-                ImGui::TableSetColumnIndex(1);
-                bool isSelected =
-                    state.previewLogIndex == static_cast<int>(i);
+                    ImGui::TableSetColumnIndex(1);
+                    bool isSelected =
+                        state.previewLogIndex == static_cast<int>(i);
 
-                if (ImGui::Selectable(log.filename.c_str(), isSelected,
-                                      ImGuiSelectableFlags_SpanAllColumns |
-                                          ImGuiSelectableFlags_AllowOverlap))
-                {
-                    state.previewLogIndex = static_cast<int>(i);
-                }
+                    if (ImGui::Selectable(log.filename.c_str(), isSelected,
+                                          ImGuiSelectableFlags_SpanAllColumns |
+                                              ImGuiSelectableFlags_AllowOverlap))
+                    {
+                        state.previewLogIndex = static_cast<int>(i);
+                    }
+                    ImGui::PopID();
 
-                ImGui::TableSetColumnIndex(2);
-                ImGui::TextColored(UIColors::LightTeal, "%s",
-                                   log.type.c_str());
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::TextColored(UIColors::LightTeal, "%s",
+                                       log.type.c_str());
 
-                ImGui::TableSetColumnIndex(3);
-                ImGui::Text("%s",
-                            SteamUtils::formatFileSize(log.size).c_str());
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::TextUnformatted(text.size.c_str());
 
-                ImGui::TableSetColumnIndex(4);
-                ImGui::PushFont(UIFonts::GetSmall());
-                ImGui::Text("%s", log.lastModified.c_str());
-                ImGui::PopFont();
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::PushFont(UIFonts::GetSmall());
+                    ImGui::TextUnformatted(text.modified.c_str());
+                    ImGui::PopFont();
+                }
             }
+            clipper.End();
 
             ImGui::EndTable();
         }
 
         ImGui::EndChild();
+
+        if (state.grepTask.showResults)
+        {
+            RenderGrepResults(state, ImVec2(contentWidth, resultsHeight));
+        }
     }
 }
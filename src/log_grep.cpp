@@ -0,0 +1,294 @@
+#include "log_grep.hpp"
+#include "line_index.hpp"
+#include "logger.hpp"
+#include "mapped_file.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+namespace SteamUtils
+{
+    namespace
+    {
+        // Files above this are split into slices of about this size, cut at line starts
+        constexpr std::size_t kSliceBytes = 8 * 1024 * 1024;
+        // A hit's context starts at most this far before the match and is at most kMaxContextBytes long
+        constexpr std::size_t kContextLead = 96;
+        constexpr std::size_t kMaxContextBytes = 256;
+
+        struct SliceResult
+        {
+            std::vector<GrepHit> hits; // lineNumber counts the newlines before the hit within the slice
+            std::uint64_t newlines = 0;
+            std::uint64_t bytes = 0;
+            std::size_t clippedLines = 0;
+            bool done = false;
+        };
+
+        /**
+         * @brief A mapped file and the slices it was cut into; shared by the slice tasks
+         */
+        struct FileJob
+        {
+            std::size_t fileIndex = 0;
+            MappedFile file;
+            std::mutex mutex; // guards everything below
+            std::vector<SliceResult> slices;
+            std::size_t nextToDeliver = 0;
+            std::uint64_t linesBefore = 0; // newlines in the slices already delivered
+            bool hadHits = false;
+        };
+
+        class GrepRun
+        {
+        public:
+            GrepRun(const std::vector<LogFile> &logFiles, const TextMatcher &matcher, const GrepOptions &options)
+                : logFiles_(logFiles), matcher_(matcher), options_(options),
+                  pool_(options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency()))
+            {
+                progress_.fileCount = logFiles.size();
+                for (const auto &log : logFiles)
+                {
+                    progress_.totalBytes += log.size;
+                }
+            }
+
+            GrepStats run()
+            {
+                const auto start = std::chrono::steady_clock::now();
+
+                // Largest first: their slices are queued before the small files that fill the gaps at the end
+                std::vector<std::size_t> order(logFiles_.size());
+                std::iota(order.begin(), order.end(), std::size_t{0});
+                std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b)
+                                 { return logFiles_[a].size > logFiles_[b].size; });
+                for (std::size_t index : order)
+                {
+                    pool_.submit([this, index](std::size_t)
+                                 { searchFile(index); });
+                }
+                pool_.wait();
+
+                stats_.cancelled = cancelled();
+                stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                return stats_;
+            }
+
+        private:
+            [[nodiscard]] bool cancelled() const noexcept
+            {
+                return options_.cancel != nullptr && options_.cancel->load(std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] bool stopped() const noexcept
+            {
+                return cancelled() || limitReached_.load(std::memory_order_relaxed);
+            }
+
+            void searchFile(std::size_t index)
+            {
+                if (stopped())
+                {
+                    return;
+                }
+
+                auto job = std::make_shared<FileJob>();
+                job->fileIndex = index;
+                if (!job->file.open(logFiles_[index].path))
+                {
+                    Logger::log("Cannot search " + logFiles_[index].path.string(), SeverityLevel::Warning);
+                    std::lock_guard<std::mutex> lock(callbackMutex_);
+                    ++stats_.filesFailed;
+                    ++progress_.filesDone;
+                    reportProgress();
+                    return;
+                }
+
+                // Slices end just past a '\n', so no line (and no regex match) is split between two of them
+                const char *data = job->file.data();
+                const std::size_t size = job->file.size();
+                std::vector<std::pair<std::size_t, std::size_t>> bounds;
+                for (std::size_t begin = 0; begin < size || bounds.empty();)
+                {
+                    std::size_t end = std::min(size, begin + kSliceBytes);
+                    if (end < size)
+                    {
+                        const void *newline = std::memchr(data + end, '\n', size - end);
+                        end = newline ? static_cast<std::size_t>(static_cast<const char *>(newline) - data) + 1 : size;
+                    }
+                    bounds.emplace_back(begin, end);
+                    begin = end;
+                }
+                job->slices.resize(bounds.size());
+
+                for (std::size_t slice = 1; slice < bounds.size(); ++slice)
+                {
+                    pool_.submit([this, job, slice, range = bounds[slice]](std::size_t)
+                                 { searchSlice(*job, slice, range.first, range.second); });
+                }
+                searchSlice(*job, 0, bounds[0].first, bounds[0].second);
+            }
+
+            void searchSlice(FileJob &job, std::size_t slice, std::size_t begin, std::size_t end)
+            {
+                if (stopped())
+                {
+                    return;
+                }
+
+                SliceResult result;
+                result.bytes = end - begin;
+                const char *data = job.file.data();
+                const std::size_t size = job.file.size();
+                // Plain text may run past the slice end; regexes only ever see whole lines
+                const std::size_t searchEnd =
+                    matcher_.options().regex ? end : std::min(size, end + matcher_.pattern().size() - 1);
+
+                std::vector<std::uint64_t> found;
+                std::size_t counted = begin;
+                std::size_t position = begin;
+                while (position < end && !stopped())
+                {
+                    found.clear();
+                    (void)matcher_.findAll(data + position, searchEnd - position, position, found, 1, options_.cancel,
+                                           &result.clippedLines);
+                    if (found.empty() || found[0] >= end)
+                    {
+                        break;
+                    }
+                    const auto offset = static_cast<std::size_t>(found[0]);
+                    result.newlines += countNewlines(data + counted, offset - counted);
+                    counted = offset;
+
+                    const void *newline = std::memchr(data + offset, '\n', size - offset);
+                    const std::size_t lineEnd = newline ? static_cast<std::size_t>(static_cast<const char *>(newline) - data) : size;
+                    result.hits.push_back(makeHit(job.fileIndex, data, offset, lineEnd, result.newlines));
+
+                    // One hit per line, like grep; the rest of the line is skipped
+                    position = lineEnd + 1;
+                }
+                if (stopped())
+                {
+                    return;
+                }
+                result.newlines += countNewlines(data + counted, end - counted);
+                finishSlice(job, slice, std::move(result));
+            }
+
+            [[nodiscard]] static GrepHit makeHit(std::size_t fileIndex, const char *data, std::size_t offset,
+                                                 std::size_t lineEnd, std::uint64_t newlinesBefore)
+            {
+                const std::size_t earliest = offset > kContextLead ? offset - kContextLead : 0;
+                std::size_t contextStart = offset;
+                while (contextStart > earliest && data[contextStart - 1] != '\n')
+                {
+                    --contextStart;
+                }
+                std::size_t contextEnd = std::min(lineEnd, contextStart + kMaxContextBytes);
+                if (contextEnd == lineEnd && contextEnd > contextStart && data[contextEnd - 1] == '\r')
+                {
+                    --contextEnd;
+                }
+
+                GrepHit hit;
+                hit.fileIndex = fileIndex;
+                hit.lineNumber = newlinesBefore;
+                hit.offset = offset;
+                hit.context.assign(data + contextStart, contextEnd - contextStart);
+                hit.contextMatch = std::min(offset - contextStart, hit.context.size());
+                return hit;
+            }
+
+            /**
+             * @brief Stores a slice and delivers every slice whose predecessors are all in, so line numbers are known
+             */
+            void finishSlice(FileJob &job, std::size_t slice, SliceResult result)
+            {
+                std::lock_guard<std::mutex> fileLock(job.mutex);
+                job.slices[slice] = std::move(result);
+                job.slices[slice].done = true;
+
+                while (job.nextToDeliver < job.slices.size() && job.slices[job.nextToDeliver].done)
+                {
+                    SliceResult &ready = job.slices[job.nextToDeliver++];
+                    for (auto &hit : ready.hits)
+                    {
+                        hit.lineNumber += job.linesBefore + 1;
+                    }
+                    job.linesBefore += ready.newlines;
+
+                    const bool firstHits = !job.hadHits && !ready.hits.empty();
+                    job.hadHits = job.hadHits || firstHits;
+                    deliver(ready, firstHits, job.nextToDeliver == job.slices.size());
+                    ready.hits = {};
+                }
+            }
+
+            void deliver(SliceResult &slice, bool firstHitsOfFile, bool fileDone)
+            {
+                std::lock_guard<std::mutex> lock(callbackMutex_);
+                if (limitReached_.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+
+                const std::size_t room = options_.maxHits - stats_.hits;
+                if (slice.hits.size() >= room)
+                {
+                    slice.hits.resize(room);
+                    stats_.truncated = true;
+                    limitReached_.store(true, std::memory_order_relaxed);
+                }
+                stats_.hits += slice.hits.size();
+                stats_.bytesSearched += slice.bytes;
+                stats_.clippedLines += slice.clippedLines;
+                stats_.filesWithHits += firstHitsOfFile ? 1 : 0;
+                stats_.filesSearched += fileDone ? 1 : 0;
+
+                if (!slice.hits.empty() && options_.onHits)
+                {
+                    options_.onHits(slice.hits);
+                }
+                progress_.bytesSearched = stats_.bytesSearched;
+                progress_.filesDone += fileDone ? 1 : 0;
+                progress_.hits = stats_.hits;
+                reportProgress();
+            }
+
+            void reportProgress()
+            {
+                if (options_.onProgress)
+                {
+                    options_.onProgress(progress_);
+                }
+            }
+
+            const std::vector<LogFile> &logFiles_;
+            const TextMatcher &matcher_;
+            const GrepOptions &options_;
+
+            std::mutex callbackMutex_; // guards stats_ and progress_, and serializes the callbacks
+            GrepStats stats_;
+            GrepProgress progress_;
+            std::atomic<bool> limitReached_{false};
+
+            WorkStealingPool pool_; // last, so its threads stop before the rest goes away
+        };
+    } // anonymous namespace
+
+    GrepStats grepLogs(const std::vector<LogFile> &logFiles, const TextMatcher &matcher, const GrepOptions &options)
+    {
+        if (logFiles.empty() || matcher.pattern().empty() || options.maxHits == 0)
+        {
+            return {};
+        }
+        return GrepRun(logFiles, matcher, options).run();
+    }
+}
@@ -0,0 +1,216 @@
+#include "log_view.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace SteamUtils
+{
+    namespace
+    {
+        // Bytes kept from the start and from the end of what is shown, to tell growth from a rewrite
+        constexpr std::size_t kWindowBytes = 4096;
+    }
+
+    void LogView::rememberWindows()
+    {
+        const std::size_t size = file_.size();
+        const std::size_t window = std::min(size, kWindowBytes);
+        headWindow_.assign(file_.data(), window);
+        tailOffset_ = size - window;
+        tailWindow_.assign(file_.data() + tailOffset_, window);
+    }
+
+    bool LogView::windowsMatch(const MappedFile &file) const
+    {
+        if (file.size() < tailOffset_ + tailWindow_.size())
+        {
+            return false;
+        }
+        return std::string_view(file.data(), headWindow_.size()) == headWindow_ &&
+               std::string_view(file.data() + tailOffset_, tailWindow_.size()) == tailWindow_;
+    }
+
+    bool LogView::map(const std::filesystem::path &path)
+    {
+        // The workers read the mapping, so they have to stop first
+        index_.cancel();
+        search_.pause();
+        followPending_ = false;
+        if (!file_.open(path))
+        {
+            return false;
+        }
+        if (!readFileStamp(path, stamp_))
+        {
+            stamp_ = FileStamp{};
+        }
+        rememberWindows();
+        index_.start(file_.data(), file_.size());
+        if (search_.isActive())
+        {
+            // Reloaded after a truncation or rotation: the old matches are meaningless, the query is not
+            (void)search_.start(file_.data(), file_.size(), search_.matcher().pattern(), search_.matcher().options());
+        }
+        return true;
+    }
+
+    bool LogView::open(const std::filesystem::path &path)
+    {
+        close();
+        if (!map(path))
+        {
+            return false;
+        }
+        path_ = path;
+        return true;
+    }
+
+    void LogView::close() noexcept
+    {
+        follower_.stop();
+        index_.cancel();
+        search_.cancel();
+        file_.close();
+        path_.clear();
+        followPending_ = false;
+    }
+
+    void LogView::setFollowing(bool following)
+    {
+        if (!following)
+        {
+            follower_.stop();
+        }
+        else if (isOpen() && !follower_.isRunning())
+        {
+            follower_.start(path_);
+            followPending_ = true; // catch up on anything written since open()
+        }
+    }
+
+    FollowUpdate LogView::follow()
+    {
+        if (!isOpen() || !follower_.isRunning() || (!follower_.changed() && !followPending_))
+        {
+            return FollowUpdate::None;
+        }
+        followPending_ = false;
+
+        FileStamp current;
+        if (!readFileStamp(path_, current))
+        {
+            return FollowUpdate::None; // mid-rotation; the new file shows up as a later event
+        }
+
+        if (current.inode != stamp_.inode || current.device != stamp_.device)
+        {
+            return reload(FollowUpdate::Replaced);
+        }
+        if (current.size < file_.size())
+        {
+            return reload(FollowUpdate::Truncated);
+        }
+        if (current == stamp_)
+        {
+            return FollowUpdate::None;
+        }
+
+        // Truncated and written again between two polls looks like growth (or, at the same size, like nothing);
+        // the bytes already shown must still be there for it to be either
+        if (current.size == file_.size())
+        {
+            if (!windowsMatch(file_))
+            {
+                return reload(FollowUpdate::Truncated);
+            }
+            stamp_ = current;
+            return FollowUpdate::None;
+        }
+        if (!index_.isComplete())
+        {
+            followPending_ = true; // extend once the current pass is done
+            return FollowUpdate::None;
+        }
+
+        // Remapping is a page-table operation; only the appended bytes get read and indexed
+        MappedFile grown;
+        if (!grown.open(path_) || grown.size() < file_.size())
+        {
+            followPending_ = true;
+            return FollowUpdate::None;
+        }
+        if (!windowsMatch(grown))
+        {
+            return reload(FollowUpdate::Truncated);
+        }
+        search_.pause();
+        file_ = std::move(grown);
+        stamp_ = current;
+        rememberWindows();
+        index_.resume(file_.data(), file_.size());
+        search_.resume(file_.data(), file_.size());
+        return FollowUpdate::Appended;
+    }
+
+    FollowUpdate LogView::reload(FollowUpdate update)
+    {
+        if (!map(path_))
+        {
+            close();
+        }
+        return update;
+    }
+
+    std::string_view LogView::line(std::size_t index) const noexcept
+    {
+        // complete before starts, as in LineIndex::lineCount(), so the two agree
+        const bool complete = index_.isComplete();
+        const std::size_t starts = index_.startCount();
+        if (index >= starts || (!complete && index + 1 >= starts))
+        {
+            return {};
+        }
+        std::size_t begin = index_.lineStart(index);
+        std::size_t end = index + 1 < starts ? index_.lineStart(index + 1) : file_.size();
+        const char *data = file_.data();
+        if (end > begin && data[end - 1] == '\n')
+        {
+            --end;
+        }
+        if (end > begin && data[end - 1] == '\r')
+        {
+            --end;
+        }
+        return {data + begin, end - begin};
+    }
+
+    std::size_t LogView::lineAt(std::uint64_t offset) const noexcept
+    {
+        // Binary search over the published starts for the last one at or before offset
+        std::size_t low = 0;
+        std::size_t high = index_.startCount();
+        while (high - low > 1)
+        {
+            const std::size_t middle = low + (high - low) / 2;
+            if (index_.lineStart(middle) <= offset)
+            {
+                low = middle;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    bool LogView::startSearch(std::string pattern, SearchOptions options)
+    {
+        if (!isOpen())
+        {
+            search_.cancel();
+            return false;
+        }
+        return search_.start(file_.data(), file_.size(), std::move(pattern), options);
+    }
+}
@@ -0,0 +1,347 @@
+#include "log_watcher.hpp"
+#include "dir_walker.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        [[nodiscard]] std::size_t findLogFile(const std::vector<LogFile> &logFiles, const fs::path &path)
+        {
+            auto it = std::find_if(logFiles.begin(), logFiles.end(),
+                                   [&path](const LogFile &logFile)
+                                   { return logFile.path == path; });
+            return static_cast<std::size_t>(it - logFiles.begin());
+        }
+
+        void addTouched(std::vector<fs::path> &touched, fs::path path)
+        {
+            if (std::find(touched.begin(), touched.end(), path) == touched.end())
+            {
+                touched.push_back(std::move(path));
+            }
+        }
+
+        // True if path is directory itself or lies anywhere below it
+        [[nodiscard]] bool isWithin(const fs::path &path, const fs::path &directory)
+        {
+            auto [directoryEnd, pathIt] = std::mismatch(directory.begin(), directory.end(), path.begin(), path.end());
+            (void)pathIt;
+            return directoryEnd == directory.end();
+        }
+
+        /**
+         * Brings one path of the log list in line with the filesystem, whatever
+         * sequence of events touched it since the last poll.
+         */
+        void reconcile(std::vector<LogFile> &logFiles, const fs::path &path, std::vector<LogChange> &changes)
+        {
+            std::vector<LogFile> current;
+            std::string filename = path.filename().string();
+            bool exists = isLogFile(filename) && restatLogFile(path.parent_path(), filename, current);
+            std::size_t index = findLogFile(logFiles, path);
+            bool known = index < logFiles.size();
+
+            if (exists && known)
+            {
+                LogFile &logFile = logFiles[index];
+                if (logFile.size != current.front().size || logFile.lastModifiedNs != current.front().lastModifiedNs)
+                {
+                    logFile.size = current.front().size;
+                    logFile.lastModifiedNs = current.front().lastModifiedNs;
+                    changes.push_back({LogChange::Kind::Modified, index, path});
+                }
+            }
+            else if (exists)
+            {
+                logFiles.push_back(std::move(current.front()));
+                changes.push_back({LogChange::Kind::Added, logFiles.size() - 1, path});
+            }
+            else if (known)
+            {
+                logFiles.erase(logFiles.begin() + static_cast<std::ptrdiff_t>(index));
+                changes.push_back({LogChange::Kind::Removed, index, path});
+            }
+        }
+    } // anonymous namespace
+
+    LogWatcher::~LogWatcher()
+    {
+        stop();
+    }
+
+    bool LogWatcher::isSupported() noexcept
+    {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef __linux__
+    namespace
+    {
+        constexpr std::uint32_t kWatchMask = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM |
+                                             IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+    } // anonymous namespace
+
+    bool LogWatcher::start(const std::vector<VisitedDirectory> &directories, int maxDepth)
+    {
+        stop();
+
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0)
+        {
+            Logger::log(std::string("inotify_init1 failed: ") + std::strerror(errno), SeverityLevel::Err);
+            return false;
+        }
+
+        maxDepth_ = maxDepth;
+        for (const auto &directory : directories)
+        {
+            addWatch(directory.path, directory.depth);
+        }
+
+        if (watches_.empty())
+        {
+            stop();
+            return false;
+        }
+
+        Logger::log("Watching " + std::to_string(watches_.size()) + " directories for log changes", SeverityLevel::Info);
+        return true;
+    }
+
+    void LogWatcher::stop() noexcept
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+        fd_ = -1;
+        watches_.clear();
+        watchedPaths_.clear();
+    }
+
+    bool LogWatcher::isWatched(const fs::path &directory) const
+    {
+        return watchedPaths_.count(directory.native()) != 0;
+    }
+
+    void LogWatcher::forgetWatch(std::unordered_map<int, WatchedDirectory>::iterator it)
+    {
+        watchedPaths_.erase(it->second.path.native());
+        watches_.erase(it);
+    }
+
+    void LogWatcher::addWatch(const fs::path &directory, int depth)
+    {
+        int wd = inotify_add_watch(fd_, directory.c_str(), kWatchMask);
+        if (wd < 0)
+        {
+            if (errno != ENOENT)
+            {
+                Logger::log("Cannot watch " + directory.string() + ": " + std::strerror(errno), SeverityLevel::Warning);
+            }
+            return;
+        }
+        // Re-adding a path returns the existing descriptor; keep the shallowest depth
+        auto [it, inserted] = watches_.try_emplace(wd, WatchedDirectory{directory, depth});
+        if (!inserted)
+        {
+            it->second.depth = std::min(it->second.depth, depth);
+        }
+        watchedPaths_.insert(it->second.path.native());
+    }
+
+    std::vector<LogChange> LogWatcher::poll(std::vector<LogFile> &logFiles, int timeoutMs)
+    {
+        std::vector<LogChange> changes;
+        if (fd_ < 0)
+        {
+            return changes;
+        }
+
+        pollfd pfd{fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, timeoutMs) <= 0)
+        {
+            return changes;
+        }
+
+        // Collect touched paths first so a burst of IN_MODIFY on one file costs a single stat
+        std::vector<fs::path> touched;
+        std::vector<std::pair<fs::path, int>> newDirectories;
+        std::vector<fs::path> goneDirectories;
+        bool overflowed = false;
+        alignas(inotify_event) char buffer[16 * 1024];
+
+        while (true)
+        {
+            ssize_t length = ::read(fd_, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    overflowed = true;
+                    continue;
+                }
+
+                auto it = watches_.find(event->wd);
+                if (it == watches_.end())
+                {
+                    continue;
+                }
+
+                if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF))
+                {
+                    if (event->mask & IN_IGNORED)
+                    {
+                        forgetWatch(it);
+                    }
+                    continue;
+                }
+
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                fs::path path = it->second.path / event->name;
+                if (event->mask & IN_ISDIR)
+                {
+                    if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                    {
+                        goneDirectories.push_back(std::move(path));
+                    }
+                    else if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && it->second.depth + 1 < maxDepth_)
+                    {
+                        newDirectories.emplace_back(std::move(path), it->second.depth + 1);
+                    }
+                    continue;
+                }
+
+                addTouched(touched, std::move(path));
+            }
+        }
+
+        if (overflowed)
+        {
+            // The kernel dropped events; relist every watched directory and recheck every known file
+            Logger::log("inotify queue overflowed, rescanning watched directories", SeverityLevel::Warning);
+            for (const auto &[wd, watched] : watches_)
+            {
+                newDirectories.emplace_back(watched.path, watched.depth);
+            }
+            for (const auto &logFile : logFiles)
+            {
+                addTouched(touched, logFile.path);
+            }
+        }
+
+        // A directory that was moved away keeps its watches (under a path that no longer exists)
+        for (const auto &directory : goneDirectories)
+        {
+            for (auto it = watches_.begin(); it != watches_.end();)
+            {
+                if (isWithin(it->second.path, directory))
+                {
+                    inotify_rm_watch(fd_, it->first);
+                    forgetWatch(it++);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            for (const auto &logFile : logFiles)
+            {
+                if (isWithin(logFile.path, directory))
+                {
+                    addTouched(touched, logFile.path);
+                }
+            }
+        }
+
+        // Breadth-first, so a whole tree made with mkdir -p before the first watch landed is picked up
+        for (std::size_t next = 0; next < newDirectories.size(); ++next)
+        {
+            const fs::path directory = newDirectories[next].first;
+            const int depth = newDirectories[next].second;
+            addWatch(directory, depth);
+
+            // Files created before the watch was in place would otherwise be missed
+            std::vector<LogFile> existing;
+            scanDirectoryLevel(directory, WalkerBackend::Auto, existing, [&](const fs::path &subdirectory)
+                               {
+                                   if (depth + 1 < maxDepth_ && !isWatched(subdirectory))
+                                   {
+                                       newDirectories.emplace_back(subdirectory, depth + 1);
+                                   } });
+            for (auto &logFile : existing)
+            {
+                addTouched(touched, std::move(logFile.path));
+            }
+        }
+
+        for (const auto &path : touched)
+        {
+            reconcile(logFiles, path, changes);
+        }
+        return changes;
+    }
+#else
+    bool LogWatcher::start(const std::vector<VisitedDirectory> &directories, int maxDepth)
+    {
+        (void)directories;
+        (void)maxDepth;
+        return false;
+    }
+
+    void LogWatcher::stop() noexcept
+    {
+    }
+
+    bool LogWatcher::isWatched(const fs::path &directory) const
+    {
+        (void)directory;
+        return false;
+    }
+
+    void LogWatcher::addWatch(const fs::path &directory, int depth)
+    {
+        (void)directory;
+        (void)depth;
+    }
+
+    void LogWatcher::forgetWatch(std::unordered_map<int, WatchedDirectory>::iterator it)
+    {
+        (void)it;
+    }
+
+    std::vector<LogChange> LogWatcher::poll(std::vector<LogFile> &logFiles, int timeoutMs)
+    {
+        (void)logFiles;
+        (void)timeoutMs;
+        return {};
+    }
+#endif
+}
@@ -1,55 +1,383 @@
 #include "logger.hpp"
-#include <iostream>
+#include "binary_log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cctype>
 #include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
-#include <sstream>
-#include <iomanip>
+#include <thread>
+#include <utility>
 
 namespace Logger
 {
-    static std::string getTimestamp()
+    namespace
     {
-        std::time_t now = std::time(nullptr);
-        std::tm tmBuf{};
+        constexpr std::size_t kCapacity = 8192; // records; must be a power of two
+        constexpr std::size_t kBatchSize = 256;
+        constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+        static_assert((kCapacity & (kCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+        struct Record
+        {
+            std::atomic<std::uint64_t> sequence{0};
+            std::chrono::system_clock::time_point time;
+            SeverityLevel level = SeverityLevel::Info;
+            bool hasLevel = false;
+            std::string message; // keeps its capacity, so steady-state logging does not allocate
+        };
+
+        /**
+         * Bounded multi-producer ring (sequence-numbered slots, one CAS per push)
+         * drained by a single writer thread.
+         */
+        class Backend
+        {
+        public:
+            Backend() : ring_(new Record[kCapacity])
+            {
+                for (std::size_t i = 0; i < kCapacity; ++i)
+                {
+                    ring_[i].sequence.store(i, std::memory_order_relaxed);
+                }
+                writer_ = std::thread([this]
+                                      { run(); });
+            }
+
+            ~Backend()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                wakeCv_.notify_one();
+                writer_.join();
+            }
+
+            Backend(const Backend &) = delete;
+            Backend &operator=(const Backend &) = delete;
+
+            void push(std::string_view message, SeverityLevel level, bool hasLevel)
+            {
+                if (!isEnabled(level))
+                {
+                    return;
+                }
+                if (BinaryLog::enabled())
+                {
+                    BinaryLog::emit(BinaryLog::Event::Message, level, 0, 0, 0, message);
+                }
+
+                const auto now = std::chrono::system_clock::now();
+                const bool mustKeep = hasLevel && (level == SeverityLevel::Err || level == SeverityLevel::Fatal);
+
+                std::uint64_t position = enqueuePos_.load(std::memory_order_relaxed);
+                Record *record = nullptr;
+                while (true)
+                {
+                    record = &ring_[position & (kCapacity - 1)];
+                    std::uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::int64_t>(sequence - position);
+                    if (diff == 0)
+                    {
+                        if (enqueuePos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        // Full: errors are worth waiting for, chatter is not
+                        if (!mustKeep)
+                        {
+                            dropped_.fetch_add(1, std::memory_order_relaxed);
+                            return;
+                        }
+                        wake();
+                        std::this_thread::yield();
+                        position = enqueuePos_.load(std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        position = enqueuePos_.load(std::memory_order_relaxed);
+                    }
+                }
+
+                record->time = now;
+                record->level = level;
+                record->hasLevel = hasLevel;
+                record->message.assign(message);
+                record->sequence.store(position + 1, std::memory_order_release);
+
+                if (hasLevel && level == SeverityLevel::Fatal)
+                {
+                    flush();
+                }
+                else
+                {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (sleeping_.load(std::memory_order_relaxed))
+                    {
+                        wake();
+                    }
+                }
+            }
+
+            void flush()
+            {
+                const std::uint64_t target = enqueuePos_.load(std::memory_order_acquire);
+                wake();
+                std::unique_lock<std::mutex> lock(mutex_);
+                writtenCv_.wait(lock, [&]
+                                { return written_ >= target || stopping_; });
+            }
+
+            void setOutput(std::ostream *out)
+            {
+                flush();
+                std::lock_guard<std::mutex> lock(outputMutex_);
+                out_ = out;
+            }
+
+            [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+        private:
+            void wake()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                wakeCv_.notify_one();
+            }
+
+            [[nodiscard]] bool hasPending() const noexcept
+            {
+                const Record &record = ring_[dequeuePos_ & (kCapacity - 1)];
+                return record.sequence.load(std::memory_order_acquire) == dequeuePos_ + 1;
+            }
+
+            /**
+             * "%c" in the local time zone, recomputed only when the second changes.
+             */
+            const std::string &timestamp(std::chrono::system_clock::time_point time)
+            {
+                std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+                if (seconds != cachedSecond_ || cachedTimestamp_.empty())
+                {
+                    std::tm tmBuf{};
 #ifdef _WIN32
-        localtime_s(&tmBuf, &now);
+                    localtime_s(&tmBuf, &seconds);
 #else
-        localtime_r(&now, &tmBuf);
+                    localtime_r(&seconds, &tmBuf);
 #endif
-        std::ostringstream oss;
-        oss << std::put_time(&tmBuf, "%c");
-        return oss.str();
+                    char text[64];
+                    std::size_t length = std::strftime(text, sizeof(text), "%c", &tmBuf);
+                    cachedTimestamp_.assign(text, length);
+                    cachedSecond_ = seconds;
+                }
+                return cachedTimestamp_;
+            }
+
+            void format(const Record &record)
+            {
+                batch_.push_back('[');
+                batch_.append(timestamp(record.time));
+                batch_.append("] ");
+                if (record.hasLevel)
+                {
+                    batch_.push_back('[');
+                    batch_.append(levelName(record.level));
+                    batch_.append("] ");
+                }
+                batch_.append(record.message);
+                batch_.push_back('\n');
+            }
+
+            void writeBatch()
+            {
+                std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+                if (dropped != reportedDrops_)
+                {
+                    Record notice;
+                    notice.time = std::chrono::system_clock::now();
+                    notice.level = SeverityLevel::Warning;
+                    notice.hasLevel = true;
+                    notice.message = std::to_string(dropped - reportedDrops_) + " log messages dropped (logger queue full)";
+                    format(notice);
+                    reportedDrops_ = dropped;
+                }
+
+                std::lock_guard<std::mutex> lock(outputMutex_);
+                if (out_ != nullptr && !batch_.empty())
+                {
+                    out_->write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+                    out_->flush();
+                }
+            }
+
+            void run()
+            {
+                while (true)
+                {
+                    batch_.clear();
+                    std::size_t count = 0;
+                    while (count < kBatchSize && hasPending())
+                    {
+                        Record &record = ring_[dequeuePos_ & (kCapacity - 1)];
+                        format(record);
+                        record.sequence.store(dequeuePos_ + kCapacity, std::memory_order_release);
+                        ++dequeuePos_;
+                        ++count;
+                    }
+
+                    if (count > 0)
+                    {
+                        writeBatch();
+                        {
+                            std::lock_guard<std::mutex> lock(mutex_);
+                            written_ = dequeuePos_;
+                        }
+                        writtenCv_.notify_all();
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (stopping_)
+                    {
+                        break;
+                    }
+                    sleeping_.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    wakeCv_.wait_for(lock, kIdleWait, [this]
+                                     { return stopping_ || hasPending(); });
+                    sleeping_.store(false, std::memory_order_relaxed);
+                }
+
+                // Drained and stopping: release anyone still waiting in flush()
+                writtenCv_.notify_all();
+            }
+
+            std::unique_ptr<Record[]> ring_;
+            alignas(64) std::atomic<std::uint64_t> enqueuePos_{0};
+            alignas(64) std::uint64_t dequeuePos_ = 0; // writer thread only
+            std::atomic<std::uint64_t> dropped_{0};
+            std::atomic<bool> sleeping_{false};
+
+            std::mutex mutex_; // guards written_ and stopping_
+            std::condition_variable wakeCv_;
+            std::condition_variable writtenCv_;
+            std::uint64_t written_ = 0;
+            bool stopping_ = false;
+
+            std::mutex outputMutex_;
+            std::ostream *out_ = &std::cout;
+
+            // Writer thread state
+            std::string batch_;
+            std::string cachedTimestamp_;
+            std::time_t cachedSecond_ = 0;
+            std::uint64_t reportedDrops_ = 0;
+
+            std::thread writer_;
+        };
+
+        Backend &backend()
+        {
+            static Backend instance;
+            return instance;
+        }
+    } // anonymous namespace
+
+    void setMinimumLevel(SeverityLevel level)
+    {
+        detail::minimumRank.store(severityRank(level), std::memory_order_relaxed);
     }
 
-    void log(std::string_view message)
+    SeverityLevel minimumLevel()
     {
-        std::cout << "[" << getTimestamp() << "] " << message << '\n';
+        switch (detail::minimumRank.load(std::memory_order_relaxed))
+        {
+        case 0:
+            return SeverityLevel::Debug;
+        case 2:
+            return SeverityLevel::Warning;
+        case 3:
+            return SeverityLevel::Err;
+        case 4:
+            return SeverityLevel::Fatal;
+        default:
+            return SeverityLevel::Info;
+        }
     }
 
-    void log(std::string_view message, SeverityLevel level)
+    bool parseLevel(std::string_view name, SeverityLevel &level)
     {
-        std::string levelStr;
+        static constexpr std::pair<std::string_view, SeverityLevel> kNames[] = {
+            {"debug", SeverityLevel::Debug},
+            {"info", SeverityLevel::Info},
+            {"warning", SeverityLevel::Warning},
+            {"error", SeverityLevel::Err},
+            {"fatal", SeverityLevel::Fatal},
+        };
+        for (const auto &[candidate, value] : kNames)
+        {
+            bool equal = candidate.size() == name.size() &&
+                         std::equal(candidate.begin(), candidate.end(), name.begin(), [](char a, char b)
+                                    { return a == std::tolower(static_cast<unsigned char>(b)); });
+            if (equal)
+            {
+                level = value;
+                return true;
+            }
+        }
+        return false;
+    }
 
+    const char *levelName(SeverityLevel level) noexcept
+    {
         switch (level)
         {
         case SeverityLevel::Info:
-            levelStr = "INFO";
-            break;
+            return "INFO";
         case SeverityLevel::Warning:
-            levelStr = "WARNING";
-            break;
+            return "WARNING";
         case SeverityLevel::Err:
-            levelStr = "ERROR";
-            break;
+            return "ERROR";
         case SeverityLevel::Fatal:
-            levelStr = "FATAL";
-            break;
+            return "FATAL";
         case SeverityLevel::Debug:
-            levelStr = "DEBUG";
-            break;
+            return "DEBUG";
         }
+        return "";
+    }
 
-        std::cout << "[" << getTimestamp() << "] [" << levelStr << "] " << message << '\n';
+    void log(std::string_view message)
+    {
+        backend().push(message, SeverityLevel::Info, false);
+    }
+
+    void log(std::string_view message, SeverityLevel level)
+    {
+        backend().push(message, level, true);
+    }
+
+    void flush()
+    {
+        backend().flush();
+    }
+
+    void setOutput(std::ostream *out)
+    {
+        backend().setOutput(out);
+    }
+
+    std::uint64_t droppedCount()
+    {
+        return backend().dropped();
     }
 }
@@ -1,10 +1,16 @@
+#include <chrono>
 #include <iostream>
 #include <filesystem>
 #include <optional>
 #include <string>
 #include <iomanip>
+#include <vector>
 #include "logger.hpp"
+#include "binary_log.hpp"
 #include "steam-utils.hpp"
+#include "log_bundle.hpp"
+#include "log_grep.hpp"
+#include "log_watcher.hpp"
 
 namespace fs = std::filesystem;
 
@@ -12,19 +18,198 @@ int main(int argc, char *argv[])
 {
     std::cout << "=== Steam Log Collector CLI ===" << '\n';
 
-    if (argc < 2)
+    bool listMode = false;
+    bool watchMode = false;
+    bool bundleMode = false;
+    bool incrementalMode = false;
+    bool bundleListMode = false;
+    bool bundleExtractMode = false;
+    bool pruneStoreMode = false;
+    SteamUtils::ScanOptions scanOptions;
+    SteamUtils::CollectOptions collectOptions;
+    std::vector<SteamUtils::VisitedDirectory> visitedDirectories;
+    std::vector<std::string> positional;
+    fs::path binaryLogPath;
+    std::optional<std::string> grepPattern;
+    SteamUtils::SearchOptions grepOptions;
+
+    for (int i = 1; i < argc; ++i)
     {
-        std::cerr << "Usage: " << argv[0] << " <steam_game_name> [steam_directory]" << '\n';
+        std::string arg = argv[i];
+        if (arg == "--list")
+        {
+            listMode = true;
+        }
+        else if (arg == "--no-index")
+        {
+            scanOptions.useIndex = false;
+        }
+        else if (arg == "--watch")
+        {
+            watchMode = true;
+            scanOptions.visitedDirectories = &visitedDirectories;
+        }
+        else if (arg == "--log-level")
+        {
+            SeverityLevel level;
+            if (i + 1 >= argc || !Logger::parseLevel(argv[i + 1], level))
+            {
+                std::cerr << "--log-level expects one of: debug, info, warning, error, fatal" << '\n';
+                return 1;
+            }
+            Logger::setMinimumLevel(level);
+            ++i;
+        }
+        else if (arg == "--binary-log")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "--binary-log expects a file path" << '\n';
+                return 1;
+            }
+            binaryLogPath = argv[++i];
+        }
+        else if (arg == "--grep")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "--grep expects a pattern" << '\n';
+                return 1;
+            }
+            grepPattern = argv[++i];
+        }
+        else if (arg == "--regex")
+        {
+            grepOptions.regex = true;
+        }
+        else if (arg == "--case-sensitive")
+        {
+            grepOptions.ignoreCase = false;
+        }
+        else if (arg == "--incremental")
+        {
+            incrementalMode = true;
+        }
+        else if (arg == "--no-dedup")
+        {
+            collectOptions.deduplicate = false;
+        }
+        else if (arg == "--bundle")
+        {
+            bundleMode = true;
+        }
+        else if (arg == "--bundle-list")
+        {
+            bundleListMode = true;
+        }
+        else if (arg == "--bundle-extract")
+        {
+            bundleExtractMode = true;
+        }
+        else if (arg == "--prune-store")
+        {
+            pruneStoreMode = true;
+        }
+        else
+        {
+            positional.push_back(std::move(arg));
+        }
+    }
+
+    bool usageError = pruneStoreMode      ? !positional.empty()
+                      : bundleListMode    ? positional.size() != 1
+                      : bundleExtractMode ? positional.size() < 2 || positional.size() > 3
+                                          : (!listMode && positional.empty()) || positional.size() > (listMode ? 1u : 2u);
+    if (usageError)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--no-index] [--watch] [--bundle] [--no-dedup] [--log-level <level>] [--binary-log <file>] <steam_game_name> [steam_directory]" << '\n';
+        std::cerr << "   or: " << argv[0] << " --incremental [--no-index] <steam_game_name> [steam_directory]" << '\n';
+        std::cerr << "   or: " << argv[0] << " --grep <pattern> [--regex] [--case-sensitive] [--no-index] <steam_game_name> [steam_directory]" << '\n';
         std::cerr << "   or: " << argv[0] << " --list [steam_directory]" << '\n';
+        std::cerr << "   or: " << argv[0] << " --bundle-list <bundle>" << '\n';
+        std::cerr << "   or: " << argv[0] << " --bundle-extract <bundle> <member_name_or_number> [output_path]" << '\n';
+        std::cerr << "   or: " << argv[0] << " --prune-store" << '\n';
         return 1;
     }
 
+    if (binaryLogPath.empty())
+    {
+        BinaryLog::openFromEnvironment();
+    }
+    else if (!BinaryLog::open(binaryLogPath))
+    {
+        return 1;
+    }
+
+    if (pruneStoreMode)
+    {
+        SteamUtils::PruneResult result = SteamUtils::pruneContentStore();
+        Logger::flush();
+        std::cout << "Removed " << result.blobsRemoved << " stored files no collection uses ("
+                  << SteamUtils::formatFileSize(result.bytesFreed) << ")" << '\n';
+        return 0;
+    }
+
+    if (bundleListMode || bundleExtractMode)
+    {
+        SteamUtils::BundleReader reader;
+        if (!reader.open(positional[0]))
+        {
+            std::cerr << "Error: Cannot read bundle: " << positional[0] << '\n';
+            return 1;
+        }
+
+        if (bundleListMode)
+        {
+            Logger::flush();
+            std::cout << "\n=== Bundle: " << reader.gameName() << " ("
+                      << SteamUtils::formatTimestamp(reader.createdNs()) << ") ===" << '\n';
+            std::cout << std::left << std::setw(50) << "Member"
+                      << std::setw(15) << "Type"
+                      << std::setw(12) << "Size"
+                      << std::setw(20) << "Last Modified" << '\n';
+            std::cout << std::string(97, '-') << '\n';
+            for (const auto &member : reader.members())
+            {
+                std::cout << std::left << std::setw(50) << member.name
+                          << std::setw(15) << member.type
+                          << std::setw(12) << SteamUtils::formatFileSize(member.size)
+                          << std::setw(20) << SteamUtils::formatTimestamp(member.lastModifiedNs) << '\n';
+            }
+            std::cout << "\nTotal members: " << reader.members().size() << '\n';
+            return 0;
+        }
+
+        std::optional<std::size_t> index = reader.find(positional[1]);
+        if (!index)
+        {
+            std::cerr << "Error: No member named " << positional[1] << " in " << positional[0] << '\n';
+            return 1;
+        }
+
+        const SteamUtils::BundleMember &member = reader.members()[*index];
+        fs::path output = positional.size() > 2 ? fs::path(positional[2]) : fs::path(member.name).filename();
+        if (output.empty() || output == "." || output == "..")
+        {
+            std::cerr << "Error: Member " << member.name << " has no usable file name; pass an output path\n";
+            return 1;
+        }
+        if (!reader.extract(member, output))
+        {
+            std::cerr << "Error: Failed to extract " << member.name << " to " << output.string() << '\n';
+            return 1;
+        }
+        std::cout << "Extracted " << member.name << " (" << SteamUtils::formatFileSize(member.size) << ") to "
+                  << output.string() << '\n';
+        return 0;
+    }
+
     fs::path steamDir;
-    bool listMode = (std::string(argv[1]) == "--list");
+    std::size_t steamDirArg = listMode ? 0 : 1;
 
-    if (argc > 2)
+    if (positional.size() > steamDirArg)
     {
-        steamDir = argv[2];
+        steamDir = positional[steamDirArg];
         std::cout << "Using provided Steam directory: " << steamDir.string() << '\n';
 
         if (!SteamUtils::directoryExists(steamDir))
@@ -65,6 +250,8 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // The logger writes from a background thread; drain it so its lines come before the report
+    Logger::flush();
     std::cout << "\n=== Installed Steam Games ===" << '\n';
     for (const auto &game : games)
     {
@@ -77,7 +264,7 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    std::string gameName = argv[1];
+    const std::string &gameName = positional[0];
 
     std::optional<SteamUtils::GameInfo> foundGame = SteamUtils::findGameByName(games, gameName);
 
@@ -88,15 +275,17 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    Logger::flush();
     std::cout << "\n=== Selected Game ===" << '\n';
     std::cout << "Name: " << foundGame->name << '\n';
     std::cout << "App ID: " << foundGame->appId << '\n';
     std::cout << "Install Directory: " << foundGame->installDir << '\n';
+    std::cout << "Library: " << foundGame->libraryPath.string() << '\n';
 
     Logger::log("Initialized Steam Log Collector for: " + foundGame->name + " (ID: " + foundGame->appId + ")", SeverityLevel::Info);
 
     std::cout << "\nSearching for log files..." << '\n';
-    std::vector<SteamUtils::LogFile> logFiles = SteamUtils::findGameLogs(steamDir, *foundGame);
+    std::vector<SteamUtils::LogFile> logFiles = SteamUtils::findGameLogs(steamDir, *foundGame, scanOptions);
 
     if (logFiles.empty())
     {
@@ -105,6 +294,52 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (grepPattern)
+    {
+        SteamUtils::TextMatcher matcher;
+        if (!matcher.compile(*grepPattern, grepOptions))
+        {
+            std::cerr << "Error: Invalid pattern: " << matcher.error() << '\n';
+            return 1;
+        }
+
+        Logger::flush();
+        std::cout << "\n=== Lines Matching \"" << *grepPattern << "\" ===" << '\n';
+        SteamUtils::GrepOptions options;
+        options.onHits = [&logFiles](const std::vector<SteamUtils::GrepHit> &hits)
+        {
+            // Streamed as the workers find them; each file's lines come in order
+            for (const auto &hit : hits)
+            {
+                std::cout << logFiles[hit.fileIndex].path.string() << ':' << hit.lineNumber << ": " << hit.context << '\n';
+            }
+            std::cout.flush();
+        };
+        SteamUtils::GrepStats stats = SteamUtils::grepLogs(logFiles, matcher, options);
+
+        Logger::flush();
+        std::cout << "\n" << stats.hits << " matching lines in " << stats.filesWithHits << " out of " << logFiles.size()
+                  << " log files (" << SteamUtils::formatFileSize(stats.bytesSearched) << " searched in "
+                  << std::fixed << std::setprecision(2) << stats.seconds << " s)" << '\n';
+        if (stats.truncated)
+        {
+            std::cout << "Stopped after the first " << stats.hits << " matching lines." << '\n';
+        }
+        if (stats.clippedLines > 0)
+        {
+            std::cout << stats.clippedLines << " lines longer than "
+                      << SteamUtils::TextMatcher::kMaxRegexLineBytes / 1024
+                      << " KB were only searched in their first " << SteamUtils::TextMatcher::kMaxRegexLineBytes / 1024
+                      << " KB; plain text search covers them in full." << '\n';
+        }
+        if (stats.filesFailed > 0)
+        {
+            std::cerr << stats.filesFailed << " log files could not be read." << '\n';
+        }
+        return stats.hits > 0 ? 0 : 1;
+    }
+
+    Logger::flush();
     std::cout << "\n=== Found Log Files ===" << '\n';
     std::cout << std::left << std::setw(50) << "File Name"
               << std::setw(15) << "Type"
@@ -118,22 +353,103 @@ int main(int argc, char *argv[])
         std::cout << std::left << std::setw(50) << logFile.filename
                   << std::setw(15) << logFile.type
                   << std::setw(12) << SteamUtils::formatFileSize(logFile.size)
-                  << std::setw(20) << logFile.lastModified << '\n';
+                  << std::setw(20) << SteamUtils::formatTimestamp(logFile.lastModifiedNs) << '\n';
     }
 
     std::cout << "\nTotal log files found: " << logFiles.size() << '\n';
 
+    Logger::flush();
     std::cout << "\n=== Full Paths ===" << '\n';
     for (size_t i = 0; i < logFiles.size(); ++i)
     {
         std::cout << "[" << (i + 1) << "] " << logFiles[i].path.string() << '\n';
     }
 
-    std::cout << "\nDo you want to copy these log files to ~/steam-logs? (y/n): ";
+    if (watchMode)
+    {
+        SteamUtils::LogWatcher watcher;
+        if (!watcher.start(visitedDirectories, scanOptions.maxDepth))
+        {
+            std::cerr << "Watch mode is not available on this platform or no directories could be watched." << '\n';
+            return 1;
+        }
+
+        Logger::flush();
+        std::cout << "\nWatching " << watcher.watchCount() << " directories for log changes (Ctrl+C to stop)..." << '\n';
+        while (watcher.isRunning())
+        {
+            for (const auto &change : watcher.poll(logFiles, -1))
+            {
+                switch (change.kind)
+                {
+                case SteamUtils::LogChange::Kind::Added:
+                    std::cout << "[+] " << change.path.string() << " (" << SteamUtils::formatFileSize(logFiles[change.index].size) << ")" << '\n';
+                    break;
+                case SteamUtils::LogChange::Kind::Modified:
+                    std::cout << "[~] " << change.path.string() << " (" << SteamUtils::formatFileSize(logFiles[change.index].size) << ", "
+                              << SteamUtils::formatTimestamp(logFiles[change.index].lastModifiedNs) << ")" << '\n';
+                    break;
+                case SteamUtils::LogChange::Kind::Removed:
+                    std::cout << "[-] " << change.path.string() << '\n';
+                    break;
+                }
+            }
+            std::cout.flush();
+        }
+        return 0;
+    }
+
+    if (incrementalMode)
+    {
+        // Meant for unattended, repeated runs: no confirmation prompt
+        fs::path mirrorDir = SteamUtils::createIncrementalDirectory(foundGame->name);
+        if (mirrorDir.empty())
+        {
+            std::cerr << "Failed to create output directory. Cannot proceed with collecting log files." << '\n';
+            return 1;
+        }
+
+        SteamUtils::IncrementalStats stats;
+        int upToDate = SteamUtils::collectLogsIncrementally(logFiles, mirrorDir, foundGame->name, {}, &stats);
+
+        Logger::flush();
+        std::cout << "\n=== Incremental Collection Complete ===" << '\n';
+        std::cout << stats.newFiles << " new, " << stats.appendedFiles << " appended, " << stats.rewrittenFiles
+                  << " rewritten, " << stats.unchangedFiles << " unchanged, " << stats.failedFiles << " failed ("
+                  << SteamUtils::formatFileSize(stats.bytesCopied) << " copied)" << '\n';
+        std::cout << upToDate << " out of " << logFiles.size() << " log files are up to date in: " << mirrorDir.string() << '\n';
+        return stats.failedFiles == 0 ? 0 : 1;
+    }
+
+    Logger::flush();
+    std::cout << "\nDo you want to " << (bundleMode ? "bundle" : "copy") << " these log files to ~/steam-logs? (y/n): ";
     std::string response;
     std::getline(std::cin, response);
 
-    if (response == "y" || response == "Y" || response == "yes" || response == "Yes")
+    if ((response == "y" || response == "Y" || response == "yes" || response == "Yes") && bundleMode)
+    {
+        fs::path bundlePath = SteamUtils::createOutputBundlePath(foundGame->name);
+        if (bundlePath.empty())
+        {
+            std::cerr << "Failed to create output directory. Cannot proceed with bundling log files." << '\n';
+            return 1;
+        }
+
+        std::cout << "\nBundling Log Files..." << '\n';
+        int bundledFiles = SteamUtils::writeLogBundle(logFiles, bundlePath, foundGame->name);
+        if (bundledFiles == 0)
+        {
+            std::cerr << "Failed to bundle any log files" << '\n';
+            return 1;
+        }
+
+        Logger::flush();
+        std::cout << "\n=== Bundle Complete ===" << '\n';
+        std::cout << "Bundled " << bundledFiles << " out of " << logFiles.size() << " log files" << '\n';
+        std::cout << "Bundle: " << bundlePath.string() << '\n';
+        std::cout << "List it with --bundle-list, extract a file with --bundle-extract." << '\n';
+    }
+    else if (response == "y" || response == "Y" || response == "yes" || response == "Yes")
     {
         std::cout << "\nCreating output directory..." << '\n';
         fs::path outputDir = SteamUtils::createOutputDirectory(foundGame->name);
@@ -145,10 +461,28 @@ int main(int argc, char *argv[])
         }
 
         std::cout << "Copying Log Files..." << '\n';
-        int copiedFiles = SteamUtils::copyLogsToDirectory(logFiles, outputDir, foundGame->name);
+        auto lastProgress = std::chrono::steady_clock::time_point{};
+        collectOptions.onProgress = [&lastProgress](const SteamUtils::CopyProgress &progress)
+        {
+            // Redraw at most 5 times a second, plus once per finished file
+            auto now = std::chrono::steady_clock::now();
+            if (!progress.jobFinished && now - lastProgress < std::chrono::milliseconds(200))
+            {
+                return;
+            }
+            lastProgress = now;
+            std::cout << "\r[" << progress.jobsDone << "/" << progress.jobCount << "] "
+                      << SteamUtils::formatFileSize(progress.totalBytesCopied) << " / "
+                      << SteamUtils::formatFileSize(progress.totalBytes) << "  "
+                      << SteamUtils::formatFileSize(static_cast<std::uintmax_t>(progress.bytesPerSecond)) << "/s    "
+                      << std::flush;
+        };
+        int copiedFiles = SteamUtils::copyLogsToDirectory(logFiles, outputDir, foundGame->name, collectOptions);
+        std::cout << '\n';
 
         if (copiedFiles > 0)
         {
+            Logger::flush();
             std::cout << "\n=== Copy Complete ===" << '\n';
             std::cout << "Successfully copied " << copiedFiles << " out of " << logFiles.size() << " log files" << '\n';
             std::cout << "Output Directory: " << outputDir.string() << '\n';
@@ -7,6 +7,8 @@
 #include "app_state.hpp"
 #include "colors.hpp"
 #include "fonts.hpp"
+#include "logger.hpp"
+#include "binary_log.hpp"
 #include "theme.hpp"
 #include "ui_widgets.hpp"
 #include "toast.hpp"
@@ -35,6 +37,22 @@ void RenderMenuBar(AppState &state, GLFWwindow *window)
                 glfwSetWindowShouldClose(window, true);
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("Settings"))
+        {
+            if (ImGui::BeginMenu("Log Level"))
+            {
+                static constexpr SeverityLevel levels[] = {SeverityLevel::Debug, SeverityLevel::Info, SeverityLevel::Warning,
+                                                           SeverityLevel::Err, SeverityLevel::Fatal};
+                SeverityLevel current = Logger::minimumLevel();
+                for (SeverityLevel level : levels)
+                {
+                    if (ImGui::MenuItem(Logger::levelName(level), nullptr, level == current))
+                        Logger::setMinimumLevel(level);
+                }
+                ImGui::EndMenu();
+            }
+            ImGui::EndMenu();
+        }
         if (ImGui::BeginMenu("Help"))
         {
             if (ImGui::MenuItem("About"))
@@ -102,6 +120,7 @@ bool SetWindowIcon(GLFWwindow *window, const char *iconPath)
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[])
 {
+    BinaryLog::openFromEnvironment();
 
     glfwSetErrorCallback(glfw_error_callback);
     if (!glfwInit())
@@ -162,6 +181,10 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[])
 
         ImGui::Spacing();
 
+        // Also joins work abandoned with "Back", whatever screen is showing by then
+        UpdateSteamDiscovery(state);
+        UpdateLogScan(state);
+
         switch (state.currentScreen)
         {
         case Screen::Welcome:
@@ -0,0 +1,317 @@
+#include "mapped_file.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SteamUtils
+{
+#ifndef _WIN32
+    namespace
+    {
+        /*
+         * Logs are mapped while the game may still be writing them. A file cut
+         * short in place makes every page past its new end raise SIGBUS on
+         * access, from the UI thread or any worker. Each mapping is registered
+         * here, and a SIGBUS inside one replaces the rest of that mapping with
+         * zero pages, so the access reads zeros and whoever holds the file
+         * notices the truncation the next time it checks. Faults anywhere else
+         * go to the previous handler. Windows refuses to truncate a mapped file,
+         * so it needs none of this.
+         */
+        constexpr std::size_t kMaxGuardedMappings = 1024;
+
+        /*
+         * One registered mapping. begin and end are written as a pair under a
+         * per-slot sequence lock: the sequence is odd while a writer holds the
+         * slot, and the handler only trusts a pair read between two equal, even
+         * sequence values. It never waits, so a slot being written is skipped.
+         */
+        struct GuardedRange
+        {
+            std::atomic<std::uint32_t> sequence{0};
+            std::atomic<std::uintptr_t> begin{0}; // 0 = free slot
+            std::atomic<std::uintptr_t> end{0};
+        };
+
+        GuardedRange guardedRanges[kMaxGuardedMappings];
+        std::uintptr_t pageSize = 4096;
+        struct sigaction previousAction{};
+
+        /**
+         * Reads a slot's range; false if it is free or changed while being read.
+         */
+        bool readRange(const GuardedRange &range, std::uintptr_t &begin, std::uintptr_t &end) noexcept
+        {
+            const std::uint32_t before = range.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+            {
+                return false;
+            }
+            begin = range.begin.load(std::memory_order_relaxed);
+            end = range.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return begin != 0 && range.sequence.load(std::memory_order_relaxed) == before;
+        }
+
+        void onSigbus(int signal, siginfo_t *info, void *context)
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(info->si_addr);
+
+            // The tightest registered range holding the address is the mapping that faulted
+            std::uintptr_t mappingEnd = 0;
+            for (const GuardedRange &range : guardedRanges)
+            {
+                std::uintptr_t begin = 0;
+                std::uintptr_t end = 0;
+                if (readRange(range, begin, end) && address >= begin && address < end &&
+                    (mappingEnd == 0 || end < mappingEnd))
+                {
+                    mappingEnd = end;
+                }
+            }
+
+            if (mappingEnd != 0)
+            {
+                // Clamped to the last page of that mapping, so nothing mapped after it is replaced.
+                // mmap is a plain system call here, safe enough for a signal handler
+                const std::uintptr_t page = address & ~(pageSize - 1);
+                const std::uintptr_t lastPageEnd = (mappingEnd + pageSize - 1) & ~(pageSize - 1);
+                if (::mmap(reinterpret_cast<void *>(page), lastPageEnd - page, PROT_READ,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != MAP_FAILED)
+                {
+                    return; // the faulting read is retried and now sees zeros
+                }
+            }
+
+            if ((previousAction.sa_flags & SA_SIGINFO) != 0 && previousAction.sa_sigaction != nullptr)
+            {
+                previousAction.sa_sigaction(signal, info, context);
+                return;
+            }
+            // Not ours: put the old disposition back; it takes over once this handler returns
+            ::sigaction(SIGBUS, &previousAction, nullptr);
+            ::raise(signal);
+        }
+
+        void installSigbusGuard()
+        {
+            static std::once_flag once;
+            std::call_once(once, []
+                           {
+                               pageSize = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+                               struct sigaction action{};
+                               action.sa_sigaction = onSigbus;
+                               action.sa_flags = SA_SIGINFO;
+                               sigemptyset(&action.sa_mask);
+                               ::sigaction(SIGBUS, &action, &previousAction); });
+        }
+
+        /**
+         * Publishes begin/end in a slot the caller owns: the sequence goes odd, the pair is written, then even again.
+         */
+        void writeRange(GuardedRange &range, std::uint32_t sequence, std::uintptr_t begin, std::uintptr_t end) noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_release);
+            range.begin.store(begin, std::memory_order_relaxed);
+            range.end.store(end, std::memory_order_relaxed);
+            range.sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        void guardRange(const char *data, std::size_t size) noexcept
+        {
+            const auto begin = reinterpret_cast<std::uintptr_t>(data);
+            for (GuardedRange &range : guardedRanges)
+            {
+                // Claim a free slot by taking its sequence from even to odd
+                std::uint32_t sequence = range.sequence.load(std::memory_order_acquire);
+                if ((sequence & 1) != 0 || range.begin.load(std::memory_order_relaxed) != 0 ||
+                    !range.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acq_rel))
+                {
+                    continue;
+                }
+                writeRange(range, sequence, begin, begin + size);
+                return;
+            }
+            // All slots taken: this mapping simply goes unguarded
+        }
+
+        void unguardRange(const char *data) noexcept
+        {
+            const auto begin = reinterpret_cast<std::uintptr_t>(data);
+            for (GuardedRange &range : guardedRanges)
+            {
+                // Only the owner of a mapping releases its slot, and claimers skip used slots,
+                // so once begin matches no one else writes this slot
+                if (range.begin.load(std::memory_order_acquire) == begin)
+                {
+                    const std::uint32_t sequence = range.sequence.fetch_add(1, std::memory_order_acq_rel);
+                    writeRange(range, sequence, 0, 0);
+                    return;
+                }
+            }
+        }
+    } // anonymous namespace
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            open_ = std::exchange(other.open_, false);
+#ifdef _WIN32
+            fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+            mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::filesystem::path &path)
+    {
+        close();
+
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        if (fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            open_ = true;
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle_ = file;
+        mappingHandle_ = mapping;
+        data_ = static_cast<const char *>(view);
+        size_ = static_cast<std::size_t>(fileSize.QuadPart);
+        open_ = true;
+        return true;
+    }
+
+    void MappedFile::close() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            UnmapViewOfFile(data_);
+        }
+        if (mappingHandle_ != nullptr)
+        {
+            CloseHandle(mappingHandle_);
+        }
+        if (fileHandle_ != nullptr)
+        {
+            CloseHandle(fileHandle_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+        fileHandle_ = nullptr;
+        mappingHandle_ = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::filesystem::path &path)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        if (st.st_size == 0)
+        {
+            ::close(fd);
+            open_ = true;
+            return true;
+        }
+
+        installSigbusGuard();
+        void *view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED)
+        {
+            return false;
+        }
+
+        data_ = static_cast<const char *>(view);
+        size_ = static_cast<std::size_t>(st.st_size);
+        open_ = true;
+        guardRange(data_, size_);
+        return true;
+    }
+
+    void MappedFile::close() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            unguardRange(data_);
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+    }
+#endif
+}
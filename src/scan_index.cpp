@@ -0,0 +1,264 @@
+#include "scan_index.hpp"
+#include "content_store.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace SteamUtils
+{
+    bool readDirectoryStamp(const fs::path &directory, DirectoryStamp &stamp)
+    {
+#ifdef _WIN32
+        std::error_code ec;
+        if (!fs::is_directory(directory, ec))
+        {
+            return false;
+        }
+        auto mtime = fs::last_write_time(directory, ec);
+        if (ec)
+        {
+            return false;
+        }
+        stamp.mtimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count();
+        stamp.inode = 0;
+        stamp.device = 0;
+        return true;
+#else
+        struct stat st{};
+        if (::stat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+        {
+            return false;
+        }
+#ifdef __APPLE__
+        const struct timespec &mtime = st.st_mtimespec;
+#else
+        const struct timespec &mtime = st.st_mtim;
+#endif
+        stamp.mtimeNs = static_cast<std::int64_t>(mtime.tv_sec) * 1000000000LL + mtime.tv_nsec;
+        stamp.inode = static_cast<std::uint64_t>(st.st_ino);
+        stamp.device = static_cast<std::uint64_t>(st.st_dev);
+        return true;
+#endif
+    }
+
+    bool ScanIndex::open(const fs::path &indexPath)
+    {
+        close();
+
+        if (!file_.open(indexPath) || file_.size() < sizeof(IndexHeader))
+        {
+            file_.close();
+            return false;
+        }
+
+        const char *base = file_.data();
+        const std::uint64_t fileSize = file_.size();
+        const auto *header = reinterpret_cast<const IndexHeader *>(base);
+
+        bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+                     header->version == kVersion &&
+                     header->directoriesOffset <= fileSize &&
+                     header->directoryCount <= (fileSize - header->directoriesOffset) / sizeof(IndexDirectory) &&
+                     header->namesOffset <= fileSize &&
+                     header->nameCount <= (fileSize - header->namesOffset) / sizeof(IndexString) &&
+                     header->stringsOffset <= fileSize &&
+                     header->stringsSize <= fileSize - header->stringsOffset;
+
+        if (!valid)
+        {
+            Logger::log("Ignoring invalid scan index: " + indexPath.string(), SeverityLevel::Warning);
+            file_.close();
+            return false;
+        }
+
+        header_ = header;
+        directories_ = reinterpret_cast<const IndexDirectory *>(base + header->directoriesOffset);
+        names_ = reinterpret_cast<const IndexString *>(base + header->namesOffset);
+        strings_ = base + header->stringsOffset;
+
+        // Reject records pointing outside the mapping once, so lookups can trust them
+        auto inStrings = [this](const IndexString &s)
+        { return s.offset <= header_->stringsSize && s.length <= header_->stringsSize - s.offset; };
+
+        for (std::uint32_t i = 0; i < header->directoryCount && valid; ++i)
+        {
+            const IndexDirectory &dir = directories_[i];
+            valid = inStrings(dir.path) &&
+                    std::uint64_t{dir.firstFile} + dir.fileCount <= header->nameCount &&
+                    std::uint64_t{dir.firstChild} + dir.childCount <= header->nameCount;
+        }
+        for (std::uint64_t i = 0; i < header->nameCount && valid; ++i)
+        {
+            valid = inStrings(names_[i]);
+        }
+
+        if (!valid)
+        {
+            Logger::log("Ignoring corrupt scan index: " + indexPath.string(), SeverityLevel::Warning);
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void ScanIndex::close() noexcept
+    {
+        file_.close();
+        header_ = nullptr;
+        directories_ = nullptr;
+        names_ = nullptr;
+        strings_ = nullptr;
+    }
+
+    std::string_view ScanIndex::string(const IndexString &s) const noexcept
+    {
+        return {strings_ + s.offset, s.length};
+    }
+
+    const IndexString *ScanIndex::files(const IndexDirectory &directory) const noexcept
+    {
+        return names_ + directory.firstFile;
+    }
+
+    const IndexString *ScanIndex::children(const IndexDirectory &directory) const noexcept
+    {
+        return names_ + directory.firstChild;
+    }
+
+    const IndexDirectory *ScanIndex::findDirectory(std::string_view path) const
+    {
+        if (header_ == nullptr)
+        {
+            return nullptr;
+        }
+
+        const IndexDirectory *end = directories_ + header_->directoryCount;
+        const IndexDirectory *it = std::lower_bound(directories_, end, path,
+                                                    [this](const IndexDirectory &dir, std::string_view key)
+                                                    { return string(dir.path) < key; });
+        if (it != end && string(it->path) == path)
+        {
+            return it;
+        }
+        return nullptr;
+    }
+
+    void ScanIndexBuilder::addDirectory(std::string path, const DirectoryStamp &stamp, std::vector<std::string> files,
+                                        std::vector<std::string> children, bool reused)
+    {
+        entries_.push_back(Entry{std::move(path), stamp, std::move(files), std::move(children)});
+        if (reused)
+        {
+            reused_++;
+        }
+    }
+
+    void ScanIndexBuilder::merge(ScanIndexBuilder &&other)
+    {
+        entries_.reserve(entries_.size() + other.entries_.size());
+        std::move(other.entries_.begin(), other.entries_.end(), std::back_inserter(entries_));
+        reused_ += other.reused_;
+        other.entries_.clear();
+        other.reused_ = 0;
+    }
+
+    bool ScanIndexBuilder::write(const fs::path &indexPath)
+    {
+        std::sort(entries_.begin(), entries_.end(),
+                  [](const Entry &a, const Entry &b)
+                  { return a.path < b.path; });
+        // Overlapping search roots can visit a directory twice
+        entries_.erase(std::unique(entries_.begin(), entries_.end(),
+                                   [](const Entry &a, const Entry &b)
+                                   { return a.path == b.path; }),
+                       entries_.end());
+
+        std::string strings;
+        std::vector<IndexDirectory> directories;
+        std::vector<IndexString> names;
+        directories.reserve(entries_.size());
+
+        auto intern = [&strings](const std::string &s)
+        {
+            IndexString result{strings.size(), static_cast<std::uint32_t>(s.size()), 0};
+            strings += s;
+            return result;
+        };
+
+        for (const auto &entry : entries_)
+        {
+            IndexDirectory dir{};
+            dir.path = intern(entry.path);
+            dir.stamp = entry.stamp;
+            dir.firstFile = static_cast<std::uint32_t>(names.size());
+            dir.fileCount = static_cast<std::uint32_t>(entry.files.size());
+            for (const auto &file : entry.files)
+            {
+                names.push_back(intern(file));
+            }
+            dir.firstChild = static_cast<std::uint32_t>(names.size());
+            dir.childCount = static_cast<std::uint32_t>(entry.children.size());
+            for (const auto &child : entry.children)
+            {
+                names.push_back(intern(child));
+            }
+            directories.push_back(dir);
+        }
+
+        IndexHeader header{};
+        std::memcpy(header.magic, ScanIndex::kMagic, sizeof(header.magic));
+        header.version = ScanIndex::kVersion;
+        header.directoryCount = static_cast<std::uint32_t>(directories.size());
+        header.directoriesOffset = sizeof(IndexHeader);
+        header.nameCount = names.size();
+        header.namesOffset = header.directoriesOffset + directories.size() * sizeof(IndexDirectory);
+        header.stringsOffset = header.namesOffset + names.size() * sizeof(IndexString);
+        header.stringsSize = strings.size();
+
+        std::error_code ec;
+        fs::create_directories(indexPath.parent_path(), ec);
+
+        // Scripts may scan the same game from several processes at once; each writes its own file
+        fs::path tempPath = uniqueTempPath(indexPath);
+
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+            {
+                Logger::log("Failed to write scan index: " + tempPath.string(), SeverityLevel::Warning);
+                return false;
+            }
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(directories.data()),
+                      static_cast<std::streamsize>(directories.size() * sizeof(IndexDirectory)));
+            out.write(reinterpret_cast<const char *>(names.data()),
+                      static_cast<std::streamsize>(names.size() * sizeof(IndexString)));
+            out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+            if (!out)
+            {
+                Logger::log("Failed to write scan index: " + tempPath.string(), SeverityLevel::Warning);
+                out.close();
+                fs::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        fs::rename(tempPath, indexPath, ec);
+        if (ec)
+        {
+            Logger::log("Failed to replace scan index " + indexPath.string() + ": " + ec.message(), SeverityLevel::Warning);
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+}
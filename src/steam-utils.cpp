@@ -1,5 +1,16 @@
 #include "steam-utils.hpp"
 #include "logger.hpp"
+#include "binary_log.hpp"
+#include "collection_manifest.hpp"
+#include "content_hash.hpp"
+#include "content_store.hpp"
+#include "copy_engine.hpp"
+#include "dir_walker.hpp"
+#include "log_bundle.hpp"
+#include "log_classifier.hpp"
+#include "scan_index.hpp"
+#include "vdf.hpp"
+#include "work_stealing_pool.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -7,8 +18,14 @@
 #include <cctype>
 #include <iomanip>
 #include <chrono>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string_view>
+#include <system_error>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -16,9 +33,11 @@
 #elif defined(__APPLE__)
 #include <unistd.h>
 #include <pwd.h>
+#include <sys/stat.h>
 #elif defined(__linux__)
 #include <unistd.h>
 #include <pwd.h>
+#include <sys/stat.h>
 #endif
 
 namespace SteamUtils
@@ -60,6 +79,44 @@ namespace SteamUtils
 #endif
     }
 
+    fs::path getCacheDirectory()
+    {
+        fs::path base;
+#ifdef _WIN32
+        char *localAppData = nullptr;
+        size_t len = 0;
+        if (_dupenv_s(&localAppData, &len, "LOCALAPPDATA") == 0 && localAppData != nullptr)
+        {
+            auto cleanup = std::unique_ptr<char, decltype(&free)>(localAppData, &free);
+            base = fs::path(cleanup.get());
+        }
+        else if (fs::path home = getHomeDirectory(); !home.empty())
+        {
+            base = home / "AppData" / "Local";
+        }
+#elif defined(__APPLE__)
+        if (fs::path home = getHomeDirectory(); !home.empty())
+        {
+            base = home / "Library" / "Caches";
+        }
+#else
+        const char *xdgCache = getenv("XDG_CACHE_HOME");
+        if (xdgCache != nullptr && xdgCache[0] == '/')
+        {
+            base = fs::path(xdgCache);
+        }
+        else if (fs::path home = getHomeDirectory(); !home.empty())
+        {
+            base = home / ".cache";
+        }
+#endif
+        if (base.empty())
+        {
+            return {};
+        }
+        return base / "steam-log-collector";
+    }
+
     bool directoryExists(const fs::path &path)
     {
         try
@@ -150,6 +207,11 @@ namespace SteamUtils
     }
 
     fs::path findSteamDirectory()
+    {
+        return findSteamDirectory(SteamSearchOptions{});
+    }
+
+    fs::path findSteamDirectory(const SteamSearchOptions &options)
     {
         Logger::log("Searching for Steam installation directory...", SeverityLevel::Info);
 
@@ -157,8 +219,19 @@ namespace SteamUtils
 
         std::vector<fs::path> potentialPaths = getSteamDirectoryPaths();
 
-        for (const auto &path : potentialPaths)
+        for (std::size_t i = 0; i < potentialPaths.size(); ++i)
         {
+            const fs::path &path = potentialPaths[i];
+            if (options.cancel != nullptr && options.cancel->load(std::memory_order_relaxed))
+            {
+                Logger::log("Steam directory search cancelled", SeverityLevel::Info);
+                return {};
+            }
+            if (options.onProbe)
+            {
+                options.onProbe(path, i, potentialPaths.size());
+            }
+
             Logger::log("Checking path: " + path.string(), SeverityLevel::Info);
 
             if (directoryExists(path))
@@ -181,142 +254,376 @@ namespace SteamUtils
     GameInfo parseAcfFile(const fs::path &acfFilePath)
     {
         GameInfo game;
-        std::ifstream file(acfFilePath);
+        KeyValuesDocument document;
 
-        if (!file.is_open())
+        // Steam can leave a manifest cut short mid-write; whatever was read before the error is still used
+        const bool parsed = document.parseFile(acfFilePath);
+        const KeyValue *appState = document.root().find("AppState");
+        if (!parsed)
+        {
+            Logger::log("Failed to parse ACF file " + acfFilePath.string() + ": " + document.error(),
+                        appState != nullptr ? SeverityLevel::Warning : SeverityLevel::Err);
+        }
+        if (appState == nullptr)
         {
-            Logger::log("Failed to open ACF file: " + acfFilePath.string(), SeverityLevel::Err);
+            if (parsed)
+            {
+                Logger::log("ACF file has no AppState block: " + acfFilePath.string(), SeverityLevel::Warning);
+            }
             return game;
         }
 
-        std::string line;
-        while (std::getline(file, line))
+        game.appId = appState->get("appid");
+        game.name = appState->get("name");
+        game.installDir = appState->get("installdir");
+        return game;
+    }
+
+    std::vector<fs::path> parseLibraryFoldersFile(const fs::path &vdfPath)
+    {
+        std::vector<fs::path> libraries;
+        KeyValuesDocument document;
+
+        if (!document.parseFile(vdfPath))
+        {
+            Logger::log("Failed to parse " + vdfPath.string() + ": " + document.error(), SeverityLevel::Warning);
+            return libraries;
+        }
+
+        const KeyValue *folders = document.root().find("libraryfolders");
+        if (folders == nullptr)
         {
-            line.erase(0, line.find_first_not_of(" \t"));
-            line.erase(line.find_last_not_of(" \t") + 1);
+            return libraries;
+        }
 
-            if (line.find("\"appid\"") == 0)
+        for (const KeyValue &entry : folders->children())
+        {
+            // Current format: "<n>" { "path" "<dir>" ... }
+            // Legacy format: "<n>" "<dir>", mixed with non-numeric bookkeeping keys
+            if (entry.isBlock)
             {
-                size_t start = line.find("\"", 8);
-                size_t end = line.find("\"", start + 1);
-                if (start != std::string::npos && end != std::string::npos)
+                std::string_view path = entry.get("path");
+                if (!path.empty())
                 {
-                    game.appId = line.substr(start + 1, end - start - 1);
+                    libraries.emplace_back(std::string(path));
                 }
             }
-            else if (line.find("\"name\"") == 0)
+            else if (!entry.key.empty() && std::all_of(entry.key.begin(), entry.key.end(), [](unsigned char c)
+                                                       { return std::isdigit(c); }))
             {
-                size_t start = line.find("\"", 7);
-                size_t end = line.find("\"", start + 1);
-                if (start != std::string::npos && end != std::string::npos)
-                {
-                    game.name = line.substr(start + 1, end - start - 1);
-                }
+                libraries.emplace_back(std::string(entry.value));
+            }
+        }
+
+        return libraries;
+    }
+
+    std::vector<fs::path> getLibraryFolders(const fs::path &steamDir)
+    {
+        std::vector<fs::path> libraries{steamDir};
+        std::vector<fs::path> seen;
+
+        std::error_code ec;
+        seen.push_back(fs::weakly_canonical(steamDir, ec));
+
+        fs::path vdfPath = steamDir / "steamapps" / "libraryfolders.vdf";
+        for (const auto &library : parseLibraryFoldersFile(vdfPath))
+        {
+            // The main installation is usually listed too, often through a different symlinked path
+            fs::path canonical = fs::weakly_canonical(library, ec);
+            if (std::find(seen.begin(), seen.end(), canonical) != seen.end())
+            {
+                continue;
             }
-            else if (line.find("\"installdir\"") == 0)
+            seen.push_back(canonical);
+
+            if (!directoryExists(library / "steamapps"))
             {
-                size_t start = line.find("\"", 12);
-                size_t end = line.find("\"", start + 1);
-                if (start != std::string::npos && end != std::string::npos)
-                {
-                    game.installDir = line.substr(start + 1, end - start - 1);
-                }
+                Logger::log("Skipping unavailable Steam library: " + library.string(), SeverityLevel::Warning);
+                continue;
             }
+            libraries.push_back(library);
         }
 
-        return game;
+        return libraries;
     }
 
-    std::vector<GameInfo> getInstalledGames(const fs::path &steamDir)
+    namespace
     {
-        std::vector<GameInfo> games;
-        fs::path steamappsPath = steamDir / "steamapps";
+        constexpr std::size_t kManifestBatchSize = 32;
 
-        Logger::log("Scanning for games in: " + steamappsPath.string(), SeverityLevel::Info);
+        [[nodiscard]] double millisecondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
 
-        if (!directoryExists(steamappsPath))
+        [[nodiscard]] std::uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start)
         {
-            Logger::log("Steamapps directory not found: " + steamappsPath.string(), SeverityLevel::Warning);
-            return games;
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
         }
 
-        try
+        void listLibraryManifests(const fs::path &libraryPath, std::vector<fs::path> &manifests)
         {
-            for (const auto &entry : fs::directory_iterator(steamappsPath))
+            fs::path steamappsPath = libraryPath / "steamapps";
+
+            SLC_LOG_INFO("Scanning for games in: " + steamappsPath.string());
+
+            if (!directoryExists(steamappsPath))
+            {
+                Logger::log("Steamapps directory not found: " + steamappsPath.string(), SeverityLevel::Warning);
+                return;
+            }
+
+            try
             {
-                if (entry.is_regular_file())
+                for (const auto &entry : fs::directory_iterator(steamappsPath))
                 {
                     std::string filename = entry.path().filename().string();
                     constexpr std::string_view acfPrefix = "appmanifest_";
                     constexpr std::string_view acfSuffix = ".acf";
                     if (filename.size() > acfPrefix.size() + acfSuffix.size() &&
                         filename.compare(0, acfPrefix.size(), acfPrefix) == 0 &&
-                        filename.compare(filename.size() - acfSuffix.size(), acfSuffix.size(), acfSuffix) == 0)
+                        filename.compare(filename.size() - acfSuffix.size(), acfSuffix.size(), acfSuffix) == 0 &&
+                        entry.is_regular_file())
                     {
-                        GameInfo game = parseAcfFile(entry.path());
-                        if (!game.name.empty() && !game.appId.empty())
-                        {
-                            Logger::log("Found game: " + game.name + " (ID: " + game.appId + ")", SeverityLevel::Info);
-                            games.push_back(std::move(game));
-                        }
+                        manifests.push_back(entry.path());
                     }
                 }
             }
+            catch (const fs::filesystem_error &e)
+            {
+                Logger::log("Error scanning steamapps directory: " + std::string(e.what()), SeverityLevel::Err);
+            }
+
+            // Directory order is arbitrary; sort so the game list is stable between runs
+            std::sort(manifests.begin(), manifests.end());
         }
-        catch (const fs::filesystem_error &e)
+
+        /**
+         * Identifies the physical volume a library lives on, so libraries sharing a
+         * drive are scanned by the same worker instead of competing for its seeks.
+         */
+        [[nodiscard]] std::string deviceKey(const fs::path &path)
         {
-            Logger::log("Error scanning steamapps directory: " + std::string(e.what()), SeverityLevel::Err);
+#ifdef _WIN32
+            return to_lower(path.root_name().string());
+#else
+            struct stat st{};
+            if (::stat(path.c_str(), &st) != 0)
+            {
+                return path.string();
+            }
+            return std::to_string(static_cast<unsigned long long>(st.st_dev));
+#endif
         }
 
-        Logger::log("Found " + std::to_string(games.size()) + " installed games", SeverityLevel::Info);
-        return games;
+        /**
+         * Lists the manifests of every library, one thread per device.
+         */
+        [[nodiscard]] std::vector<std::vector<fs::path>> listManifests(const std::vector<fs::path> &libraries)
+        {
+            std::vector<std::string> deviceKeys;
+            std::vector<std::vector<size_t>> librariesByDevice;
+            for (size_t i = 0; i < libraries.size(); ++i)
+            {
+                std::string key = deviceKey(libraries[i]);
+                auto it = std::find(deviceKeys.begin(), deviceKeys.end(), key);
+                if (it == deviceKeys.end())
+                {
+                    deviceKeys.push_back(std::move(key));
+                    librariesByDevice.emplace_back();
+                    it = deviceKeys.end() - 1;
+                }
+                librariesByDevice[static_cast<size_t>(it - deviceKeys.begin())].push_back(i);
+            }
+
+            std::vector<std::vector<fs::path>> manifestsByLibrary(libraries.size());
+            auto scanDevice = [&](const std::vector<size_t> &libraryIndices)
+            {
+                for (size_t index : libraryIndices)
+                {
+                    listLibraryManifests(libraries[index], manifestsByLibrary[index]);
+                }
+            };
+
+            if (librariesByDevice.size() == 1)
+            {
+                scanDevice(librariesByDevice.front());
+            }
+            else
+            {
+                std::vector<std::thread> workers;
+                workers.reserve(librariesByDevice.size());
+                for (const auto &libraryIndices : librariesByDevice)
+                {
+                    workers.emplace_back(scanDevice, std::cref(libraryIndices));
+                }
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+            }
+            return manifestsByLibrary;
+        }
+    } // anonymous namespace
+
+    std::vector<GameInfo> getInstalledGames(const fs::path &steamDir)
+    {
+        return getInstalledGames(steamDir, GameScanOptions{});
     }
 
-    std::optional<GameInfo> findGameByName(const std::vector<GameInfo> &games, std::string_view gameName)
+    std::vector<GameInfo> getInstalledGames(const fs::path &steamDir, const GameScanOptions &options)
     {
-        std::string lowerGameName = to_lower(gameName);
+        GameScanStats stats;
+        const auto scanStart = std::chrono::steady_clock::now();
+        auto phaseStart = scanStart;
 
-        for (const auto &game : games)
+        auto cancelled = [&options]()
         {
-            std::string lowerCurrentGame = to_lower(game.name);
-
-            if (lowerCurrentGame == lowerGameName || lowerCurrentGame.find(lowerGameName) != std::string::npos)
+            return options.cancel != nullptr && options.cancel->load(std::memory_order_relaxed);
+        };
+
+        std::vector<fs::path> libraries = getLibraryFolders(steamDir);
+        stats.libraryCount = libraries.size();
+        stats.libraryMs = millisecondsSince(phaseStart);
+        Logger::log("Found " + std::to_string(libraries.size()) + " Steam library folder(s)", SeverityLevel::Info);
+
+        // Phase 1: collect every manifest path, remembering which library it came from
+        phaseStart = std::chrono::steady_clock::now();
+        std::vector<fs::path> manifests;
+        std::vector<size_t> manifestLibrary;
+        if (!cancelled())
+        {
+            std::vector<std::vector<fs::path>> manifestsByLibrary = listManifests(libraries);
+            for (size_t library = 0; library < manifestsByLibrary.size(); ++library)
             {
-                return game;
+                for (auto &manifest : manifestsByLibrary[library])
+                {
+                    manifests.push_back(std::move(manifest));
+                    manifestLibrary.push_back(library);
+                }
             }
         }
-        return std::nullopt;
-    }
+        stats.manifestCount = manifests.size();
+        stats.enumerateMs = millisecondsSince(phaseStart);
 
-    bool isLogFile(std::string_view filename)
-    {
-        std::string lowerFilename = to_lower(filename);
+        GameScanProgress progress;
+        progress.manifestCount = manifests.size();
+        std::mutex progressMutex; // guards progress and serializes onGames
+        if (options.onGames)
+        {
+            options.onGames({}, progress);
+        }
+
+        // Phase 2: parse into preallocated slots; each batch writes a disjoint range
+        phaseStart = std::chrono::steady_clock::now();
+        std::vector<GameInfo> slots(manifests.size());
+        auto parseBatch = [&](size_t begin, size_t end)
+        {
+            if (cancelled())
+            {
+                return;
+            }
+            for (size_t i = begin; i < end; ++i)
+            {
+                slots[i] = parseAcfFile(manifests[i]);
+            }
+            if (!options.onGames)
+            {
+                return;
+            }
+
+            std::vector<GameInfo> batch;
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (!slots[i].name.empty() && !slots[i].appId.empty())
+                {
+                    batch.push_back(slots[i]);
+                    batch.back().libraryPath = libraries[manifestLibrary[i]];
+                }
+            }
+            std::lock_guard<std::mutex> lock(progressMutex);
+            progress.manifestsParsed += end - begin;
+            progress.gamesFound += batch.size();
+            options.onGames(batch, progress);
+        };
+
+        size_t batchCount = (manifests.size() + kManifestBatchSize - 1) / kManifestBatchSize;
+        unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(batchCount, 1)));
+
+        if (threads <= 1)
+        {
+            // Still batch by batch, so progress and cancellation work without a pool
+            for (size_t begin = 0; begin < manifests.size(); begin += kManifestBatchSize)
+            {
+                parseBatch(begin, std::min(begin + kManifestBatchSize, manifests.size()));
+            }
+        }
+        else
+        {
+            WorkStealingPool pool(threads);
+            for (size_t begin = 0; begin < manifests.size(); begin += kManifestBatchSize)
+            {
+                size_t end = std::min(begin + kManifestBatchSize, manifests.size());
+                pool.submit([&parseBatch, begin, end](std::size_t)
+                            { parseBatch(begin, end); });
+            }
+            pool.wait();
+        }
+        stats.threads = threads;
+        stats.parseMs = millisecondsSince(phaseStart);
 
-        for (const auto &ext : logFileExtensions)
+        std::vector<GameInfo> games;
+        games.reserve(slots.size());
+        for (size_t i = 0; i < slots.size(); ++i)
         {
-            if (lowerFilename.length() >= ext.length() &&
-                lowerFilename.compare(lowerFilename.length() - ext.length(),
-                                      ext.length(), ext) == 0)
+            GameInfo &game = slots[i];
+            if (!game.name.empty() && !game.appId.empty())
             {
-                return true;
+                SLC_LOG_DEBUG("Found game: " + game.name + " (ID: " + game.appId + ")");
+                game.libraryPath = libraries[manifestLibrary[i]];
+                games.push_back(std::move(game));
             }
         }
+        stats.gameCount = games.size();
+
+        std::ostringstream timing;
+        timing << std::fixed << std::setprecision(1)
+               << "Found " << games.size() << " installed games from " << stats.manifestCount << " manifests"
+               << " (libraries " << stats.libraryMs << " ms, enumerate " << stats.enumerateMs
+               << " ms, parse " << stats.parseMs << " ms on " << stats.threads << " thread(s))";
+        Logger::log(timing.str(), SeverityLevel::Info);
+        BinaryLog::emit(BinaryLog::Event::GamesEnumerated, SeverityLevel::Info, games.size(), stats.manifestCount,
+                        nanosecondsSince(scanStart));
+
+        if (options.stats != nullptr)
+        {
+            *options.stats = stats;
+        }
+        return games;
+    }
 
-        static constexpr std::array logPatterns = {
-            std::string_view{"log"}, std::string_view{"crash"}, std::string_view{"error"},
-            std::string_view{"debug"}, std::string_view{"console"}, std::string_view{"output"},
-            std::string_view{"stderr"}, std::string_view{"stdout"}, std::string_view{"trace"},
-            std::string_view{"dump"}, std::string_view{"report"}};
+    std::optional<GameInfo> findGameByName(const std::vector<GameInfo> &games, std::string_view gameName)
+    {
+        std::string lowerGameName = to_lower(gameName);
 
-        for (const auto &pattern : logPatterns)
+        for (const auto &game : games)
         {
-            if (lowerFilename.find(pattern) != std::string::npos)
+            std::string lowerCurrentGame = to_lower(game.name);
+
+            if (lowerCurrentGame == lowerGameName || lowerCurrentGame.find(lowerGameName) != std::string::npos)
             {
-                return true;
+                return game;
             }
         }
+        return std::nullopt;
+    }
 
-        return false;
+    bool isLogFile(std::string_view filename)
+    {
+        return classifyLogFile(filename).isLog;
     }
 
     std::string formatFileSize(std::uintmax_t size)
@@ -337,111 +644,381 @@ namespace SteamUtils
         return oss.str();
     }
 
-    std::string formatFileTime(const fs::path &filePath)
+    namespace
     {
-        try
+        constexpr std::int64_t kNsPerSecond = 1000000000;
+
+        [[nodiscard]] std::int64_t floorDiv(std::int64_t value, std::int64_t divisor)
         {
-            auto ftime = fs::last_write_time(filePath);
-            auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-                ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
-            auto time_t = std::chrono::system_clock::to_time_t(sctp);
+            std::int64_t quotient = value / divisor;
+            return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+        }
+
+        /**
+         * Direct-mapped cache of "YYYY-MM-DD HH:MM:" prefixes keyed by epoch minute.
+         * Time zone offsets are whole minutes, so the seconds can be appended as-is.
+         */
+        struct MinutePrefixCache
+        {
+            static constexpr std::size_t kSlots = 64;
+
+            std::array<std::int64_t, kSlots> minutes;
+            std::array<std::array<char, 32>, kSlots> prefixes{};
+            std::array<std::size_t, kSlots> lengths{};
+
+            MinutePrefixCache() { minutes.fill(std::numeric_limits<std::int64_t>::min()); }
+        };
+    } // anonymous namespace
+
+    std::string formatTimestamp(std::int64_t epochNs)
+    {
+        std::int64_t seconds = floorDiv(epochNs, kNsPerSecond);
+        std::int64_t minute = floorDiv(seconds, 60);
+        int second = static_cast<int>(seconds - minute * 60);
 
+        thread_local MinutePrefixCache cache;
+        std::size_t slot = static_cast<std::size_t>(minute) % MinutePrefixCache::kSlots;
+
+        if (cache.minutes[slot] != minute)
+        {
+            std::time_t time = static_cast<std::time_t>(minute * 60);
             std::tm tmBuf{};
 #ifdef _WIN32
-            localtime_s(&tmBuf, &time_t);
+            localtime_s(&tmBuf, &time);
 #else
-            localtime_r(&time_t, &tmBuf);
+            localtime_r(&time, &tmBuf);
 #endif
-            std::ostringstream oss;
-            oss << std::put_time(&tmBuf, "%Y-%m-%d %H:%M:%S");
-            return oss.str();
+            cache.lengths[slot] = std::strftime(cache.prefixes[slot].data(), cache.prefixes[slot].size(), "%Y-%m-%d %H:%M:", &tmBuf);
+            cache.minutes[slot] = minute;
         }
-        catch (const std::exception &e)
+
+        std::string result(cache.prefixes[slot].data(), cache.lengths[slot]);
+        result.push_back(static_cast<char>('0' + second / 10));
+        result.push_back(static_cast<char>('0' + second % 10));
+        return result;
+    }
+
+    std::string formatLocalTime(std::time_t time)
+    {
+        return formatTimestamp(static_cast<std::int64_t>(time) * kNsPerSecond);
+    }
+
+    std::int64_t toEpochNs(fs::file_time_type time)
+    {
+        using std::chrono::duration_cast;
+        using std::chrono::nanoseconds;
+        using std::chrono::seconds;
+
+        // C++17 has no clock_cast. Measure the file clock's epoch offset once and round it to
+        // whole seconds: standard libraries use a fixed, whole-second offset, so the conversion
+        // is exact there and identical across calls.
+        static const nanoseconds offset = []
+        {
+            nanoseconds fileNow = duration_cast<nanoseconds>(fs::file_time_type::clock::now().time_since_epoch());
+            nanoseconds systemNow = duration_cast<nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+            std::int64_t offsetNs = (fileNow - systemNow).count();
+            std::int64_t offsetSeconds = floorDiv(offsetNs + kNsPerSecond / 2, kNsPerSecond);
+            return duration_cast<nanoseconds>(seconds(offsetSeconds));
+        }();
+
+        return (duration_cast<nanoseconds>(time.time_since_epoch()) - offset).count();
+    }
+
+    std::string formatFileTime(const fs::path &filePath)
+    {
+        std::error_code ec;
+        auto ftime = fs::last_write_time(filePath, ec);
+        if (ec)
         {
             return "Unknown";
         }
+        return formatTimestamp(toEpochNs(ftime));
     }
 
-    void searchLogsInDirectory(const fs::path &directory, std::vector<LogFile> &logFiles,
-                               int maxDepth, int currentDepth)
+    std::string getLogFileType(std::string_view filename)
+    {
+        LogCategory category = classifyLogFile(filename).category;
+        return std::string(logCategoryName(category == LogCategory::None ? LogCategory::Game : category));
+    }
+
+    namespace
     {
-        if (currentDepth >= maxDepth || !directoryExists(directory))
+        /**
+         * Forwards each visited directory's files to ScanOptions::onFiles with running
+         * totals, and tells the walkers when ScanOptions::cancel has been set.
+         */
+        class ScanFeed
         {
-            return;
-        }
+        public:
+            explicit ScanFeed(const ScanOptions &options) : onFiles_(options.onFiles), cancel_(options.cancel) {}
 
-        try
+            [[nodiscard]] bool cancelled() const noexcept
+            {
+                return cancel_ != nullptr && cancel_->load(std::memory_order_relaxed);
+            }
+
+            void report(const std::vector<LogFile> &logFiles, std::size_t firstNew)
+            {
+                if (!onFiles_)
+                {
+                    return;
+                }
+                std::vector<LogFile> batch(logFiles.begin() + static_cast<std::ptrdiff_t>(firstNew), logFiles.end());
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++progress_.directoriesScanned;
+                progress_.filesFound += batch.size();
+                onFiles_(batch, progress_);
+            }
+
+        private:
+            const ScanBatchCallback &onFiles_;
+            const std::atomic<bool> *cancel_;
+            std::mutex mutex_; // guards progress_ and serializes the callback
+            ScanProgress progress_;
+        };
+
+        struct ScanContext
         {
-            for (const auto &entry : fs::directory_iterator(directory))
+            WalkerBackend backend;
+            int maxDepth;
+            const ScanIndex *previousIndex; // nullptr when the index is disabled or missing
+            ScanFeed *feed;                 // nullptr when nobody watches the scan
+        };
+
+        /**
+         * Scans one directory level, or replays it from the previous scan index when
+         * the directory's stamp is unchanged. Subdirectories within the depth limit
+         * are passed to descend once the level is done; when a builder is given the
+         * visit is recorded for the next index, and when visited is given the
+         * directory is appended to it.
+         */
+        void visitDirectory(const ScanContext &context, const fs::path &directory, int depth,
+                            std::vector<LogFile> &logFiles, ScanIndexBuilder *builder,
+                            std::vector<VisitedDirectory> *visited,
+                            const std::function<void(const fs::path &)> &descend)
+        {
+            if (depth >= context.maxDepth || (context.feed != nullptr && context.feed->cancelled()))
+            {
+                return;
+            }
+
+            const bool descendChildren = depth < context.maxDepth - 1;
+            const std::size_t firstNew = logFiles.size();
+            // Descending from inside the listing would let a serial walk append a child's files before this level's are counted
+            std::vector<fs::path> subdirectories;
+
+            if (builder == nullptr)
             {
-                try
+                bool scanned = scanDirectoryLevel(directory, context.backend, logFiles, [&](const fs::path &subdirectory)
+                                                  {
+                                                      if (descendChildren)
+                                                      {
+                                                          subdirectories.push_back(subdirectory);
+                                                      } });
+                if (!scanned)
                 {
-                    if (entry.is_regular_file())
-                    {
-                        std::string filename = entry.path().filename().string();
+                    return;
+                }
+                if (visited != nullptr)
+                {
+                    visited->push_back({directory, depth});
+                }
+            }
+            else
+            {
+                // Stat before listing so a change racing with the scan leaves a stale stamp and forces a rescan next time
+                DirectoryStamp stamp;
+                if (!readDirectoryStamp(directory, stamp))
+                {
+                    return;
+                }
 
-                        if (isLogFile(filename))
+                if (visited != nullptr)
+                {
+                    visited->push_back({directory, depth});
+                }
+
+                std::string key = directory.string();
+                std::vector<std::string> fileNames;
+                std::vector<std::string> childNames;
+
+                const IndexDirectory *cached = context.previousIndex != nullptr
+                                                   ? context.previousIndex->findDirectory(key)
+                                                   : nullptr;
+
+                if (cached != nullptr && cached->stamp == stamp)
+                {
+                    const ScanIndex &index = *context.previousIndex;
+                    const IndexString *files = index.files(*cached);
+                    for (std::uint32_t i = 0; i < cached->fileCount; ++i)
+                    {
+                        std::string_view name = index.string(files[i]);
+                        if (restatLogFile(directory, name, logFiles))
                         {
-                            LogFile logFile;
-                            logFile.path = entry.path();
-                            logFile.filename = filename;
-                            logFile.size = entry.file_size();
-                            logFile.lastModified = formatFileTime(logFile.path);
-
-                            std::string lowerFilename = to_lower(filename);
-
-                            if (lowerFilename.find("crash") != std::string::npos ||
-                                lowerFilename.find("dump") != std::string::npos)
-                            {
-                                logFile.type = "crash_log";
-                            }
-                            else if (lowerFilename.find("error") != std::string::npos)
-                            {
-                                logFile.type = "error_log";
-                            }
-                            else if (lowerFilename.find("debug") != std::string::npos)
-                            {
-                                logFile.type = "debug_log";
-                            }
-                            else if (lowerFilename.find("console") != std::string::npos)
-                            {
-                                logFile.type = "console_log";
-                            }
-                            else
-                            {
-                                logFile.type = "game_log";
-                            }
-
-                            Logger::log("Found log file: " + logFile.path.string() + " (" + formatFileSize(logFile.size) + ")", SeverityLevel::Debug);
-                            logFiles.push_back(std::move(logFile));
+                            fileNames.emplace_back(name);
                         }
                     }
-                    else if (entry.is_directory() && currentDepth < maxDepth - 1)
+
+                    const IndexString *children = index.children(*cached);
+                    for (std::uint32_t i = 0; i < cached->childCount; ++i)
                     {
-                        searchLogsInDirectory(entry.path(), logFiles, maxDepth, currentDepth + 1);
+                        childNames.emplace_back(index.string(children[i]));
+                        if (descendChildren)
+                        {
+                            subdirectories.push_back(directory / childNames.back());
+                        }
                     }
+
+                    builder->addDirectory(std::move(key), stamp, std::move(fileNames), std::move(childNames), true);
                 }
-                catch (const std::exception &e)
+                else
                 {
-                    continue;
+                    bool scanned = scanDirectoryLevel(directory, context.backend, logFiles, [&](const fs::path &subdirectory)
+                                                      {
+                                                          childNames.push_back(subdirectory.filename().string());
+                                                          if (descendChildren)
+                                                          {
+                                                              subdirectories.push_back(subdirectory);
+                                                          } });
+                    if (!scanned)
+                    {
+                        return;
+                    }
+
+                    for (std::size_t i = firstNew; i < logFiles.size(); ++i)
+                    {
+                        fileNames.push_back(logFiles[i].filename);
+                    }
+                    builder->addDirectory(std::move(key), stamp, std::move(fileNames), std::move(childNames), false);
                 }
             }
+
+            if (context.feed != nullptr)
+            {
+                context.feed->report(logFiles, firstNew);
+            }
+            for (const auto &subdirectory : subdirectories)
+            {
+                descend(subdirectory);
+            }
         }
-        catch (const fs::filesystem_error &e)
+
+        /**
+         * Fans the search roots and every subdirectory out over a work-stealing pool.
+         * Each worker appends into its own buffers; buffers are merged once at the end.
+         */
+        class ParallelLogScan
         {
-            Logger::log("Error scanning directory " + directory.string() + ": " + e.what(), SeverityLevel::Err);
-        }
-    }
+        public:
+            ParallelLogScan(unsigned threads, const ScanContext &context, bool recordIndex, bool recordVisited)
+                : pool_(threads), context_(context), buffers_(pool_.size()),
+                  builders_(recordIndex ? pool_.size() : 0), visited_(recordVisited ? pool_.size() : 0)
+            {
+            }
 
-    std::vector<LogFile> findGameLogs(const fs::path &steamDir, const GameInfo &game)
-    {
-        std::vector<LogFile> logFiles;
-        std::vector<fs::path> searchPaths;
+            void addRoot(const fs::path &root)
+            {
+                pool_.submit([this, root](std::size_t worker)
+                             { scan(root, 0, worker); });
+            }
+
+            [[nodiscard]] std::vector<LogFile> collect(ScanIndexBuilder *builder, std::vector<VisitedDirectory> *visited)
+            {
+                pool_.wait();
+
+                std::size_t total = 0;
+                for (const auto &buffer : buffers_)
+                {
+                    total += buffer.size();
+                }
+
+                std::vector<LogFile> merged;
+                merged.reserve(total);
+                for (auto &buffer : buffers_)
+                {
+                    std::move(buffer.begin(), buffer.end(), std::back_inserter(merged));
+                    buffer.clear();
+                }
+
+                if (builder != nullptr)
+                {
+                    for (auto &workerBuilder : builders_)
+                    {
+                        builder->merge(std::move(workerBuilder));
+                    }
+                }
+                if (visited != nullptr)
+                {
+                    for (auto &workerVisited : visited_)
+                    {
+                        std::move(workerVisited.begin(), workerVisited.end(), std::back_inserter(*visited));
+                        workerVisited.clear();
+                    }
+                }
+                return merged;
+            }
+
+        private:
+            void scan(const fs::path &directory, int depth, std::size_t worker)
+            {
+                ScanIndexBuilder *builder = builders_.empty() ? nullptr : &builders_[worker];
+                std::vector<VisitedDirectory> *visited = visited_.empty() ? nullptr : &visited_[worker];
+                visitDirectory(context_, directory, depth, buffers_[worker], builder, visited, [this, depth](const fs::path &subdirectory)
+                               { pool_.submit([this, subdirectory, depth](std::size_t worker)
+                                              { scan(subdirectory, depth + 1, worker); }); });
+            }
+
+            WorkStealingPool pool_;
+            ScanContext context_;
+            std::vector<std::vector<LogFile>> buffers_;
+            std::vector<ScanIndexBuilder> builders_;
+            std::vector<std::vector<VisitedDirectory>> visited_;
+        };
+
+        void walkLogTree(const ScanContext &context, const fs::path &directory, int depth,
+                         std::vector<LogFile> &logFiles, ScanIndexBuilder *builder,
+                         std::vector<VisitedDirectory> *visited)
+        {
+            visitDirectory(context, directory, depth, logFiles, builder, visited, [&](const fs::path &subdirectory)
+                           { walkLogTree(context, subdirectory, depth + 1, logFiles, builder, visited); });
+        }
+
+        [[nodiscard]] fs::path getScanIndexPath(const GameInfo &game)
+        {
+            fs::path cacheDir = getCacheDirectory();
+            if (cacheDir.empty())
+            {
+                return {};
+            }
+            return cacheDir / ("scan-index-" + sanitizeFileName(game.appId) + ".bin");
+        }
+    } // anonymous namespace
+
+    void searchLogsInDirectory(const fs::path &directory, std::vector<LogFile> &logFiles,
+                               int maxDepth, int currentDepth)
+    {
+        ScanContext context{WalkerBackend::Auto, maxDepth, nullptr, nullptr};
+        walkLogTree(context, directory, currentDepth, logFiles, nullptr, nullptr);
+    }
+
+    std::vector<LogFile> findGameLogs(const fs::path &steamDir, const GameInfo &game)
+    {
+        return findGameLogs(steamDir, game, ScanOptions{});
+    }
+
+    std::vector<LogFile> findGameLogs(const fs::path &steamDir, const GameInfo &game,
+                                      const ScanOptions &options)
+    {
+        std::vector<LogFile> logFiles;
+        std::vector<fs::path> searchPaths;
         fs::path home = getHomeDirectory();
 
         Logger::log("Searching for logs for game: " + game.name + " (ID: " + game.appId + ")", SeverityLevel::Info);
+        const auto scanStart = std::chrono::steady_clock::now();
 
-        searchPaths.push_back(steamDir / "steamapps" / "common" / game.installDir);
+        // Both the install dir and the Proton prefix live in the library the game was installed to
+        const fs::path &libraryPath = game.libraryPath.empty() ? steamDir : game.libraryPath;
+        searchPaths.push_back(libraryPath / "steamapps" / "common" / game.installDir);
 
 #ifdef _WIN32
         if (!home.empty())
@@ -463,7 +1040,7 @@ namespace SteamUtils
             searchPaths.push_back(home / ("." + game.installDir));
             searchPaths.push_back(home / ".local" / "share" / game.name);
             searchPaths.push_back(home / ".config" / game.name);
-            fs::path compatdata = steamDir / "steamapps" / "compatdata" / game.appId / "pfx" / "drive_c" / "users" / "steamuser";
+            fs::path compatdata = libraryPath / "steamapps" / "compatdata" / game.appId / "pfx" / "drive_c" / "users" / "steamuser";
             searchPaths.push_back(compatdata / "AppData" / "Local" / game.installDir);
             searchPaths.push_back(compatdata / "AppData" / "Roaming" / game.installDir);
             searchPaths.push_back(compatdata / "Documents" / game.name);
@@ -485,19 +1062,84 @@ namespace SteamUtils
         std::sort(searchPaths.begin(), searchPaths.end());
         searchPaths.erase(std::unique(searchPaths.begin(), searchPaths.end()), searchPaths.end());
 
-        for (const auto &path : searchPaths)
+        ScanIndex previousIndex;
+        ScanIndexBuilder indexBuilder;
+        fs::path indexPath = options.useIndex ? getScanIndexPath(game) : fs::path{};
+        ScanIndexBuilder *builder = indexPath.empty() ? nullptr : &indexBuilder;
+
+        if (builder != nullptr && previousIndex.open(indexPath))
+        {
+            Logger::log("Loaded scan index with " + std::to_string(previousIndex.directoryCount()) + " directories: " + indexPath.string(), SeverityLevel::Info);
+        }
+
+        ScanFeed feed(options);
+        ScanContext context{options.backend, options.maxDepth, previousIndex.isOpen() ? &previousIndex : nullptr,
+                            options.onFiles || options.cancel != nullptr ? &feed : nullptr};
+
+        if (options.threads == 1)
+        {
+            for (const auto &path : searchPaths)
+            {
+                SLC_LOG_INFO("Searching in: " + path.string());
+                if (BinaryLog::enabled())
+                {
+                    BinaryLog::emit(BinaryLog::Event::ScanStarted, SeverityLevel::Info, 0, 0, 0,
+                                    BinaryLog::intern(game.name), BinaryLog::intern(path.string()));
+                }
+                walkLogTree(context, path, 0, logFiles, builder, options.visitedDirectories);
+            }
+        }
+        else
+        {
+            ParallelLogScan scan(options.threads, context, builder != nullptr, options.visitedDirectories != nullptr);
+            for (const auto &path : searchPaths)
+            {
+                SLC_LOG_INFO("Searching in: " + path.string());
+                if (BinaryLog::enabled())
+                {
+                    BinaryLog::emit(BinaryLog::Event::ScanStarted, SeverityLevel::Info, 0, 0, 0,
+                                    BinaryLog::intern(game.name), BinaryLog::intern(path.string()));
+                }
+                scan.addRoot(path);
+            }
+            logFiles = scan.collect(builder, options.visitedDirectories);
+        }
+
+        if (feed.cancelled())
         {
-            Logger::log("Searching in: " + path.string(), SeverityLevel::Info);
-            searchLogsInDirectory(path, logFiles, 3, 0);
+            // Skipped directories would be missing from the index, and the old one is still good
+            Logger::log("Log scan cancelled after finding " + std::to_string(logFiles.size()) + " files", SeverityLevel::Info);
+            builder = nullptr;
         }
 
+        if (builder != nullptr)
+        {
+            // The new index may replace the file that is still mapped
+            previousIndex.close();
+            Logger::log("Scan index: " + std::to_string(builder->reusedCount()) + " of " + std::to_string(builder->directoryCount()) + " directories unchanged", SeverityLevel::Info);
+            if (!builder->write(indexPath))
+            {
+                Logger::log("Could not update scan index: " + indexPath.string(), SeverityLevel::Warning);
+            }
+        }
+
+        // Workers finish in arbitrary order, so break ties on the path to keep the output deterministic
         std::sort(logFiles.begin(), logFiles.end(),
                   [](const LogFile &a, const LogFile &b)
                   {
-                      return a.lastModified > b.lastModified;
+                      if (a.lastModifiedNs != b.lastModifiedNs)
+                      {
+                          return a.lastModifiedNs > b.lastModifiedNs;
+                      }
+                      return a.path < b.path;
                   });
 
         Logger::log("Found " + std::to_string(logFiles.size()) + " log files for " + game.name, SeverityLevel::Info);
+        if (BinaryLog::enabled())
+        {
+            BinaryLog::emit(BinaryLog::Event::ScanFinished, SeverityLevel::Info, logFiles.size(),
+                            nanosecondsSince(scanStart), 0, BinaryLog::intern(game.name));
+        }
         return logFiles;
     }
 
@@ -571,72 +1213,128 @@ namespace SteamUtils
         return sanitized;
     }
 
-    fs::path createOutputDirectory(std::string_view gameName)
+    namespace
     {
-        fs::path home = getHomeDirectory();
-        if (home.empty())
-        {
-            Logger::log("Could not determine home directory", SeverityLevel::Err);
-            return {};
-        }
-
-        Logger::log("Home directory: " + home.string(), SeverityLevel::Info);
-        fs::path steamLogDir = home / "steam-logs";
-
-        Logger::log("Attempting to create steam-logs directory: " + steamLogDir.string(), SeverityLevel::Info);
-
-        if (!createDirectory(steamLogDir))
+        /**
+         * Creates (or finds) the steam-logs folder in the user's home directory,
+         * falling back to Documents on Windows.
+         */
+        [[nodiscard]] fs::path ensureSteamLogsDirectory()
         {
-            Logger::log("Standard method failed, trying alternative approach...", SeverityLevel::Warning);
-#ifdef _WIN32
-            if (CreateDirectoryA(steamLogDir.string().c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS)
+            fs::path home = getHomeDirectory();
+            if (home.empty())
             {
-                Logger::log("Windows API successfully created/found directory: " + steamLogDir.string(), SeverityLevel::Info);
+                Logger::log("Could not determine home directory", SeverityLevel::Err);
+                return {};
             }
-            else
-            {
-                DWORD error = GetLastError();
-                Logger::log("Windows API failed with error: " + std::to_string(error), SeverityLevel::Err);
 
-                fs::path documentsDir = home / "Documents" / "steam-logs";
-                Logger::log("Trying fallback location: " + documentsDir.string(), SeverityLevel::Info);
+            Logger::log("Home directory: " + home.string(), SeverityLevel::Info);
+            fs::path steamLogDir = home / "steam-logs";
 
-                if (CreateDirectoryA(documentsDir.string().c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS)
+            Logger::log("Attempting to create steam-logs directory: " + steamLogDir.string(), SeverityLevel::Info);
+
+            if (!createDirectory(steamLogDir))
+            {
+                Logger::log("Standard method failed, trying alternative approach...", SeverityLevel::Warning);
+#ifdef _WIN32
+                if (CreateDirectoryA(steamLogDir.string().c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS)
                 {
-                    steamLogDir = documentsDir;
-                    Logger::log("Successfully created fallback directory: " + steamLogDir.string(), SeverityLevel::Info);
+                    Logger::log("Windows API successfully created/found directory: " + steamLogDir.string(), SeverityLevel::Info);
                 }
                 else
                 {
-                    Logger::log("All directory creation attempts failed", SeverityLevel::Err);
-                    return {};
+                    DWORD error = GetLastError();
+                    Logger::log("Windows API failed with error: " + std::to_string(error), SeverityLevel::Err);
+
+                    fs::path documentsDir = home / "Documents" / "steam-logs";
+                    Logger::log("Trying fallback location: " + documentsDir.string(), SeverityLevel::Info);
+
+                    if (CreateDirectoryA(documentsDir.string().c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS)
+                    {
+                        steamLogDir = documentsDir;
+                        Logger::log("Successfully created fallback directory: " + steamLogDir.string(), SeverityLevel::Info);
+                    }
+                    else
+                    {
+                        Logger::log("All directory creation attempts failed", SeverityLevel::Err);
+                        return {};
+                    }
                 }
+#else
+                Logger::log("Failed to create steam-logs directory", SeverityLevel::Err);
+                return {};
+#endif
+            }
+
+            if (!directoryExists(steamLogDir))
+            {
+                Logger::log("Directory verification failed: " + steamLogDir.string(), SeverityLevel::Err);
+                return {};
             }
+
+            return steamLogDir;
+        }
+
+        /**
+         * Names one collection run: "<game>_<YYYYmmdd_HHMMSS>".
+         */
+        [[nodiscard]] std::string collectionName(std::string_view gameName)
+        {
+            auto now = std::chrono::system_clock::now();
+            auto time_t = std::chrono::system_clock::to_time_t(now);
+            std::tm tmBuf{};
+#ifdef _WIN32
+            localtime_s(&tmBuf, &time_t);
 #else
-            Logger::log("Failed to create steam-logs directory", SeverityLevel::Err);
-            return {};
+            localtime_r(&time_t, &tmBuf);
 #endif
+            std::ostringstream timestamp;
+            timestamp << std::put_time(&tmBuf, "%Y%m%d_%H%M%S");
+
+            return sanitizeFileName(gameName) + "_" + timestamp.str();
         }
 
-        if (!directoryExists(steamLogDir))
+        /**
+         * Name a collected file gets in the output: "<n>_<name>", n being its 1-based position.
+         */
+        [[nodiscard]] std::string collectedFileName(size_t index, const std::string &filename)
         {
-            Logger::log("Directory verification failed: " + steamLogDir.string(), SeverityLevel::Err);
-            return {};
+            return sanitizeFileName(std::to_string(index + 1) + "_" + sanitizeFileName(filename));
         }
 
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm tmBuf{};
+        /**
+         * Writes the heading of log_summary.txt, up to the start of the file list.
+         */
+        void writeSummaryHeader(std::ostream &summaryFile, std::string_view gameName, size_t fileCount)
+        {
+            auto now = std::chrono::system_clock::now();
+            auto time_t = std::chrono::system_clock::to_time_t(now);
+            std::tm tmBuf{};
 #ifdef _WIN32
-        localtime_s(&tmBuf, &time_t);
+            localtime_s(&tmBuf, &time_t);
 #else
-        localtime_r(&time_t, &tmBuf);
+            localtime_r(&time_t, &tmBuf);
 #endif
-        std::ostringstream timestamp;
-        timestamp << std::put_time(&tmBuf, "%Y%m%d_%H%M%S");
 
-        std::string sanitizedGameName = sanitizeFileName(gameName);
-        fs::path gameDir = steamLogDir / (sanitizedGameName + "_" + timestamp.str());
+            summaryFile << "Steam Log Collection Summary\n";
+            summaryFile << "============================\n";
+            summaryFile << "Game: " << gameName << "\n";
+            summaryFile << "Collection Date: " << std::put_time(&tmBuf, "%Y-%m-%d %H:%M:%S") << "\n";
+            summaryFile << "Total Files Found: " << fileCount << "\n\n";
+            summaryFile << "Files Collected:\n";
+            summaryFile << "-----------------\n";
+        }
+    } // anonymous namespace
+
+    fs::path createOutputDirectory(std::string_view gameName)
+    {
+        fs::path steamLogDir = ensureSteamLogsDirectory();
+        if (steamLogDir.empty())
+        {
+            return {};
+        }
+
+        fs::path gameDir = steamLogDir / collectionName(gameName);
 
         Logger::log("Creating game-specific directory: " + gameDir.string(), SeverityLevel::Info);
 
@@ -656,21 +1354,122 @@ namespace SteamUtils
         return gameDir;
     }
 
-    bool copyFile(const fs::path &sourcePath, const fs::path &destPath)
+    PruneResult pruneContentStore()
     {
-        try
+        fs::path steamLogDir = ensureSteamLogsDirectory();
+        std::error_code ec;
+        if (steamLogDir.empty() || !fs::is_directory(steamLogDir / ".store", ec))
         {
-            fs::copy_file(sourcePath, destPath, fs::copy_options::overwrite_existing);
-            return true;
+            return {};
         }
-        catch (const fs::filesystem_error &e)
+
+        ContentStore store(steamLogDir / ".store");
+        if (!store.open())
         {
-            Logger::log("Error copying file from " + sourcePath.string() + " to " + destPath.string() + ": " + e.what(), SeverityLevel::Err);
-            return false;
+            return {};
         }
+        PruneResult result = store.prune();
+        store.save();
+        Logger::log("Removed " + std::to_string(result.blobsRemoved) + " unused files (" +
+                        formatFileSize(result.bytesFreed) + ") from " + store.root().string(),
+                    SeverityLevel::Info);
+        return result;
+    }
+
+    fs::path createIncrementalDirectory(std::string_view gameName)
+    {
+        fs::path steamLogDir = ensureSteamLogsDirectory();
+        if (steamLogDir.empty())
+        {
+            return {};
+        }
+
+        fs::path mirrorDir = steamLogDir / (sanitizeFileName(gameName) + "_incremental");
+        if (!createDirectory(mirrorDir) || !directoryExists(mirrorDir))
+        {
+            Logger::log("Failed to create incremental directory: " + mirrorDir.string(), SeverityLevel::Err);
+            return {};
+        }
+        return mirrorDir;
+    }
+
+    fs::path createOutputBundlePath(std::string_view gameName)
+    {
+        fs::path steamLogDir = ensureSteamLogsDirectory();
+        if (steamLogDir.empty())
+        {
+            return {};
+        }
+        fs::path bundlePath = steamLogDir / collectionName(gameName);
+        bundlePath += kBundleExtension;
+        return bundlePath;
+    }
+
+    int writeLogBundle(const std::vector<LogFile> &logFiles, const fs::path &bundlePath, std::string_view gameName)
+    {
+        if (logFiles.empty())
+        {
+            Logger::log(std::string("No log files to bundle for game: ").append(gameName), SeverityLevel::Info);
+            return 0;
+        }
+
+        BundleWriter writer;
+        if (!writer.open(bundlePath, gameName))
+        {
+            return 0;
+        }
+
+        Logger::log("Bundling " + std::to_string(logFiles.size()) + " log files into: " + bundlePath.string(), SeverityLevel::Info);
+
+        auto start = std::chrono::steady_clock::now();
+        std::uintmax_t bytes = 0;
+        for (size_t i = 0; i < logFiles.size(); ++i)
+        {
+            const auto &logFile = logFiles[i];
+            if (writer.addFile(logFile.path, collectedFileName(i, logFile.filename), logFile.type, logFile.lastModifiedNs))
+            {
+                bytes += logFile.size;
+            }
+        }
+
+        if (!writer.finish())
+        {
+            return 0;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::ostringstream summary;
+        summary << "Bundle written: " << writer.memberCount() << "/" << logFiles.size() << " files, about "
+                << formatFileSize(bytes) << " in " << std::fixed << std::setprecision(2) << seconds << " s";
+        Logger::log(summary.str(), SeverityLevel::Info);
+        return static_cast<int>(writer.memberCount());
+    }
+
+    bool copyFile(const fs::path &sourcePath, const fs::path &destPath)
+    {
+        CopyResult result = copyFileFast(sourcePath, destPath);
+        if (!result.success)
+        {
+            Logger::log("Error copying file from " + sourcePath.string() + " to " + destPath.string() + ": " + result.error, SeverityLevel::Err);
+        }
+        return result.success;
     }
 
     int copyLogsToDirectory(const std::vector<LogFile> &logFiles, const fs::path &outputDir, std::string_view gameName)
+    {
+        return copyLogsToDirectory(logFiles, outputDir, gameName, CopyProgressCallback{});
+    }
+
+    int copyLogsToDirectory(const std::vector<LogFile> &logFiles, const fs::path &outputDir, std::string_view gameName,
+                            const CopyProgressCallback &onProgress)
+    {
+        CollectOptions options;
+        options.onProgress = onProgress;
+        return copyLogsToDirectory(logFiles, outputDir, gameName, options);
+    }
+
+    int copyLogsToDirectory(const std::vector<LogFile> &logFiles, const fs::path &outputDir, std::string_view gameName,
+                            const CollectOptions &collectOptions)
     {
         if (logFiles.empty())
         {
@@ -680,58 +1479,124 @@ namespace SteamUtils
 
         Logger::log("Starting to copy " + std::to_string(logFiles.size()) + " log files to: " + outputDir.string(), SeverityLevel::Info);
 
+        std::vector<std::string> destFileNames;
+        std::vector<CopyJob> jobs;
+        destFileNames.reserve(logFiles.size());
+        jobs.reserve(logFiles.size());
+        for (size_t i = 0; i < logFiles.size(); ++i)
+        {
+            std::string destFileName = collectedFileName(i, logFiles[i].filename);
+            jobs.push_back(CopyJob{logFiles[i].path, outputDir / destFileName, logFiles[i].size});
+            destFileNames.push_back(std::move(destFileName));
+        }
+
+        CopyOptions options;
+        options.onProgress = collectOptions.onProgress;
+
+        // Collections live side by side, so a store next to them is on the same filesystem and can be hardlinked
+        std::unique_ptr<ContentStore> store;
+        if (collectOptions.deduplicate)
+        {
+            store = std::make_unique<ContentStore>(outputDir.parent_path() / ".store");
+            if (store->open())
+            {
+                options.copy = [&store](const CopyJob &job, const std::function<void(std::uintmax_t)> &onBytes)
+                { return store->store(job, onBytes); };
+            }
+            else
+            {
+                Logger::log("Content store unavailable, copying without deduplication", SeverityLevel::Warning);
+                store.reset();
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<CopyResult> results = copyFiles(jobs, options);
+        const std::uint64_t elapsedNs = nanosecondsSince(start);
+        double seconds = static_cast<double>(elapsedNs) / 1e9;
+        if (store)
+        {
+            store->save();
+        }
+
+        // The summary is written once the copies are done, in list order
         int copiedCount = 0;
+        std::uintmax_t bytesCopied = 0;
+        std::uintmax_t bytesDeduplicated = 0;
+        int deduplicatedCount = 0;
+        std::array<int, 5> methodCounts{};
         fs::path summaryPath = outputDir / "log_summary.txt";
 
         std::ofstream summaryFile(summaryPath);
         if (summaryFile.is_open())
         {
-            auto now = std::chrono::system_clock::now();
-            auto time_t = std::chrono::system_clock::to_time_t(now);
-            std::tm tmBuf{};
-#ifdef _WIN32
-            localtime_s(&tmBuf, &time_t);
-#else
-            localtime_r(&time_t, &tmBuf);
-#endif
-
-            summaryFile << "Steam Log Collection Summary\n";
-            summaryFile << "============================\n";
-            summaryFile << "Game: " << gameName << "\n";
-            summaryFile << "Collection Date: " << std::put_time(&tmBuf, "%Y-%m-%d %H:%M:%S") << "\n";
-            summaryFile << "Total Files Found: " << logFiles.size() << "\n\n";
-            summaryFile << "Files Collected:\n";
-            summaryFile << "-----------------\n";
+            writeSummaryHeader(summaryFile, gameName, logFiles.size());
         }
 
         for (size_t i = 0; i < logFiles.size(); ++i)
         {
             const auto &logFile = logFiles[i];
+            const CopyResult &result = results[i];
 
-            std::string destFileName = std::to_string(i + 1) + "_" + sanitizeFileName(logFile.filename);
-            destFileName = sanitizeFileName(destFileName);
-
-            fs::path destPath = outputDir / destFileName;
-
-            if (copyFile(logFile.path, destPath))
+            if (result.success)
             {
                 copiedCount++;
-                Logger::log("Copied: " + logFile.filename + "-->" + destFileName, SeverityLevel::Info);
+                bytesCopied += result.bytesCopied;
+                methodCounts[static_cast<size_t>(result.method)]++;
+                if (result.deduplicated)
+                {
+                    deduplicatedCount++;
+                    bytesDeduplicated += result.bytesCopied;
+                }
+                SLC_LOG_INFO("Copied: " + logFile.filename + "-->" + destFileNames[i] + " (" + copyMethodName(result.method) + ")");
+                if (BinaryLog::enabled())
+                {
+                    BinaryLog::emit(BinaryLog::Event::FileCopied, SeverityLevel::Info, result.bytesCopied,
+                                    static_cast<std::uint64_t>(result.method), result.deduplicated ? 1 : 0,
+                                    logFile.path.string());
+                }
                 if (summaryFile.is_open())
                 {
-                    summaryFile << "[" << (i + 1) << "] " << destFileName << "\n";
+                    summaryFile << "[" << (i + 1) << "] " << destFileNames[i] << "\n";
                     summaryFile << "Original: " << logFile.path.string() << "\n";
                     summaryFile << "Type: " << logFile.type << "\n";
                     summaryFile << "Size: " << formatFileSize(logFile.size) << "\n";
-                    summaryFile << "Last Modified: " << logFile.lastModified << "\n\n";
+                    summaryFile << "Last Modified: " << formatTimestamp(logFile.lastModifiedNs) << "\n";
+                    if (store)
+                    {
+                        summaryFile << "Hash: xxh64:" << toHex(result.contentHash) << "\n";
+                    }
+                    summaryFile << "\n";
                 }
             }
             else
             {
-                Logger::log("Failed to copy: " + logFile.path.string(), SeverityLevel::Err);
+                Logger::log("Failed to copy: " + logFile.path.string() + ": " + result.error, SeverityLevel::Err);
+                if (BinaryLog::enabled())
+                {
+                    BinaryLog::emit(BinaryLog::Event::FileCopyFailed, SeverityLevel::Err, 0, 0, 0,
+                                    logFile.path.string(), result.error);
+                }
             }
         }
 
+        std::ostringstream throughput;
+        throughput << formatFileSize(bytesCopied) << " in " << std::fixed << std::setprecision(2) << seconds << " s ("
+                   << formatFileSize(seconds > 0 ? static_cast<std::uintmax_t>(static_cast<double>(bytesCopied) / seconds) : bytesCopied)
+                   << "/s; " << methodCounts[static_cast<size_t>(CopyMethod::Reflink)] << " reflinked, "
+                   << methodCounts[static_cast<size_t>(CopyMethod::CopyFileRange)] << " copy_file_range, "
+                   << methodCounts[static_cast<size_t>(CopyMethod::Buffered)] << " buffered, "
+                   << methodCounts[static_cast<size_t>(CopyMethod::Hardlink)] << " hardlinked)";
+        Logger::log("Copied " + throughput.str(), SeverityLevel::Info);
+        BinaryLog::emit(BinaryLog::Event::CollectionFinished, SeverityLevel::Info, static_cast<std::uint64_t>(copiedCount),
+                        bytesCopied, elapsedNs);
+        if (store)
+        {
+            Logger::log("Content store: " + std::to_string(deduplicatedCount) + " files (" + formatFileSize(bytesDeduplicated) +
+                            ") already stored, " + std::to_string(copiedCount - deduplicatedCount) + " new",
+                        SeverityLevel::Info);
+        }
+
         if (summaryFile.is_open())
         {
             summaryFile << "Successfully copied " << copiedCount << "/" << logFiles.size() << " files\n";
@@ -740,4 +1605,174 @@ namespace SteamUtils
         Logger::log("Copy operation completed. " + std::to_string(copiedCount) + " files copied successfully.", SeverityLevel::Info);
         return copiedCount;
     }
+
+    int collectLogsIncrementally(const std::vector<LogFile> &logFiles, const fs::path &mirrorDir, std::string_view gameName,
+                                 const CopyProgressCallback &onProgress, IncrementalStats *stats)
+    {
+        IncrementalStats counts;
+        if (logFiles.empty())
+        {
+            Logger::log(std::string("No log files to collect for game: ").append(gameName), SeverityLevel::Info);
+            return 0;
+        }
+
+        const fs::path manifestPath = mirrorDir / CollectionManifest::kFileName;
+        CollectionManifest manifest;
+        manifest.load(manifestPath);
+        Logger::log("Incremental collection into " + mirrorDir.string() + " (" + std::to_string(manifest.size()) +
+                        " files known from earlier runs)",
+                    SeverityLevel::Info);
+
+        struct Plan
+        {
+            std::string mirrorName;
+            FileStamp stamp;
+            FileChange change = FileChange::New;
+            bool failed = false;
+        };
+
+        std::vector<Plan> plans(logFiles.size());
+        std::vector<CopyJob> jobs;
+        std::vector<size_t> jobFiles;
+        for (size_t i = 0; i < logFiles.size(); ++i)
+        {
+            const std::string source = logFiles[i].path.string();
+            const ManifestEntry *entry = manifest.find(source);
+            Plan &plan = plans[i];
+            plan.mirrorName = entry ? entry->mirrorName : manifest.reserveName(sanitizeFileName(logFiles[i].filename));
+
+            if (!readFileStamp(logFiles[i].path, plan.stamp))
+            {
+                Logger::log("Failed to stat: " + source, SeverityLevel::Err);
+                plan.failed = true;
+                continue;
+            }
+
+            fs::path mirrorFile = mirrorDir / plan.mirrorName;
+            plan.change = manifest.classify(source, plan.stamp, mirrorFile);
+            if (plan.change == FileChange::Unchanged)
+            {
+                // Only the mtime moved; record it so the next run skips the window check
+                if (!(entry->stamp == plan.stamp))
+                {
+                    ManifestEntry refreshed = *entry;
+                    refreshed.stamp = plan.stamp;
+                    manifest.set(source, std::move(refreshed));
+                }
+                continue;
+            }
+
+            CopyJob job{logFiles[i].path, mirrorFile, plan.stamp.size};
+            if (plan.change == FileChange::Appended)
+            {
+                job.appendOffset = entry->stamp.size;
+                job.size = plan.stamp.size - entry->stamp.size;
+            }
+            jobs.push_back(std::move(job));
+            jobFiles.push_back(i);
+        }
+
+        CopyOptions options;
+        options.onProgress = onProgress;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<CopyResult> results = copyFiles(jobs, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (size_t j = 0; j < jobs.size(); ++j)
+        {
+            Plan &plan = plans[jobFiles[j]];
+            const std::string source = jobs[j].source.string();
+            if (!results[j].success)
+            {
+                Logger::log("Failed to copy: " + source + ": " + results[j].error, SeverityLevel::Err);
+                plan.failed = true;
+                continue;
+            }
+            counts.bytesCopied += results[j].bytesCopied;
+
+            // Describe what the mirror now holds. A log that kept growing during the copy is longer than
+            // the stamp taken before it; when the source now matches the copy, its current stamp is exact
+            ManifestEntry entry;
+            entry.mirrorName = plan.mirrorName;
+            entry.stamp = plan.stamp;
+            std::error_code ec;
+            entry.stamp.size = fs::file_size(jobs[j].destination, ec);
+            FileStamp after;
+            if (!ec && readFileStamp(jobs[j].source, after) && after.size == entry.stamp.size &&
+                after.inode == plan.stamp.inode && after.device == plan.stamp.device)
+            {
+                entry.stamp = after;
+            }
+            if (ec || !CollectionManifest::hashWindows(jobs[j].destination, entry.stamp.size, entry.prefixHash, entry.tailHash))
+            {
+                Logger::log("Failed to read back: " + jobs[j].destination.string(), SeverityLevel::Err);
+                plan.failed = true;
+                continue;
+            }
+            manifest.set(source, std::move(entry));
+        }
+        manifest.save(manifestPath);
+
+        std::ofstream summaryFile(mirrorDir / "log_summary.txt");
+        if (summaryFile.is_open())
+        {
+            writeSummaryHeader(summaryFile, gameName, logFiles.size());
+        }
+
+        int upToDate = 0;
+        for (size_t i = 0; i < logFiles.size(); ++i)
+        {
+            const Plan &plan = plans[i];
+            if (plan.failed)
+            {
+                counts.failedFiles++;
+                continue;
+            }
+
+            upToDate++;
+            switch (plan.change)
+            {
+            case FileChange::New:
+                counts.newFiles++;
+                break;
+            case FileChange::Unchanged:
+                counts.unchangedFiles++;
+                break;
+            case FileChange::Appended:
+                counts.appendedFiles++;
+                break;
+            case FileChange::Rewritten:
+                counts.rewrittenFiles++;
+                break;
+            }
+
+            if (summaryFile.is_open())
+            {
+                const auto &logFile = logFiles[i];
+                summaryFile << "[" << upToDate << "] " << plan.mirrorName << "\n";
+                summaryFile << "Original: " << logFile.path.string() << "\n";
+                summaryFile << "Type: " << logFile.type << "\n";
+                summaryFile << "Size: " << formatFileSize(logFile.size) << "\n";
+                summaryFile << "Last Modified: " << formatTimestamp(logFile.lastModifiedNs) << "\n";
+                summaryFile << "Status: " << fileChangeName(plan.change) << "\n\n";
+            }
+        }
+
+        std::ostringstream summary;
+        summary << "Incremental collection: " << counts.newFiles << " new, " << counts.appendedFiles << " appended, "
+                << counts.rewrittenFiles << " rewritten, " << counts.unchangedFiles << " unchanged, "
+                << counts.failedFiles << " failed; " << formatFileSize(counts.bytesCopied) << " copied in "
+                << std::fixed << std::setprecision(2) << seconds << " s";
+        Logger::log(summary.str(), SeverityLevel::Info);
+        if (summaryFile.is_open())
+        {
+            summaryFile << summary.str() << "\n";
+        }
+
+        if (stats)
+        {
+            *stats = counts;
+        }
+        return upToDate;
+    }
 }
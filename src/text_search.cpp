@@ -0,0 +1,499 @@
+#include "text_search.hpp"
+#include "cpu_features.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef SLC_HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace SteamUtils
+{
+    namespace
+    {
+        // Searched and published in slices this size; a new keystroke waits for at most one of them
+        constexpr std::size_t kSliceBytes = 1024 * 1024;
+
+        [[nodiscard]] inline unsigned char foldAscii(unsigned char c) noexcept
+        {
+            return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c | 0x20) : c;
+        }
+
+        [[nodiscard]] inline bool isLowerAscii(unsigned char c) noexcept
+        {
+            return c >= 'a' && c <= 'z';
+        }
+
+        [[nodiscard]] inline unsigned countTrailingZeros(std::uint32_t value) noexcept
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, value);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+        }
+
+        [[nodiscard]] bool equalsNeedle(const char *text, const std::string &needle, bool fold) noexcept
+        {
+            if (!fold)
+            {
+                return std::memcmp(text, needle.data(), needle.size()) == 0;
+            }
+            for (std::size_t i = 0; i < needle.size(); ++i)
+            {
+                if (foldAscii(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(needle[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief A literal needle (already lower-cased when folding) and the state of one findAll() call
+         */
+        struct LiteralScan
+        {
+            const char *data;
+            std::size_t size;
+            std::uint64_t base;
+            const std::string &needle;
+            bool fold;
+            std::vector<std::uint64_t> &out;
+            std::size_t limit;
+            std::size_t next = 0; // first position a match may start at without overlapping the previous one
+
+            [[nodiscard]] bool equalsAt(std::size_t position) const noexcept
+            {
+                return equalsNeedle(data + position, needle, fold);
+            }
+
+            /**
+             * @brief Verifies a candidate; returns false once the limit is reached
+             */
+            bool candidate(std::size_t position)
+            {
+                if (position < next || !equalsAt(position))
+                {
+                    return true;
+                }
+                out.push_back(base + position);
+                next = position + needle.size();
+                return out.size() < limit;
+            }
+
+            void scalar(std::size_t from)
+            {
+                const std::size_t last = size - needle.size(); // callers ensure size >= needle.size()
+                const auto first = static_cast<unsigned char>(needle[0]);
+                for (std::size_t i = std::max(from, next); i <= last; i = std::max(i + 1, next))
+                {
+                    if (!fold)
+                    {
+                        const void *hit = std::memchr(data + i, first, last - i + 1);
+                        if (hit == nullptr)
+                        {
+                            return;
+                        }
+                        i = static_cast<std::size_t>(static_cast<const char *>(hit) - data);
+                    }
+                    else if (foldAscii(static_cast<unsigned char>(data[i])) != first)
+                    {
+                        continue;
+                    }
+                    if (!candidate(i))
+                    {
+                        return;
+                    }
+                }
+            }
+
+#ifdef SLC_HAVE_X86_SIMD
+            // Both filters compare the first and last needle bytes at every position of a block at once;
+            // OR-ing 0x20 into the haystack folds letters when the needle byte is a letter
+            void sse2()
+            {
+                const std::size_t m = needle.size();
+                const auto firstByte = static_cast<unsigned char>(needle[0]);
+                const auto lastByte = static_cast<unsigned char>(needle[m - 1]);
+                const __m128i first = _mm_set1_epi8(static_cast<char>(firstByte));
+                const __m128i last = _mm_set1_epi8(static_cast<char>(lastByte));
+                const __m128i firstFold = _mm_set1_epi8(fold && isLowerAscii(firstByte) ? 0x20 : 0);
+                const __m128i lastFold = _mm_set1_epi8(fold && isLowerAscii(lastByte) ? 0x20 : 0);
+
+                std::size_t i = 0;
+                for (; i + m - 1 + 16 <= size; i += 16)
+                {
+                    const __m128i a = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), firstFold);
+                    const __m128i b = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + m - 1)), lastFold);
+                    auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+                    for (; mask != 0; mask &= mask - 1)
+                    {
+                        if (!candidate(i + countTrailingZeros(mask)))
+                        {
+                            return;
+                        }
+                    }
+                }
+                scalar(i);
+            }
+
+            SLC_TARGET_AVX2 void avx2()
+            {
+                const std::size_t m = needle.size();
+                const auto firstByte = static_cast<unsigned char>(needle[0]);
+                const auto lastByte = static_cast<unsigned char>(needle[m - 1]);
+                const __m256i first = _mm256_set1_epi8(static_cast<char>(firstByte));
+                const __m256i last = _mm256_set1_epi8(static_cast<char>(lastByte));
+                const __m256i firstFold = _mm256_set1_epi8(fold && isLowerAscii(firstByte) ? 0x20 : 0);
+                const __m256i lastFold = _mm256_set1_epi8(fold && isLowerAscii(lastByte) ? 0x20 : 0);
+
+                std::size_t i = 0;
+                for (; i + m - 1 + 32 <= size; i += 32)
+                {
+                    const __m256i a = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), firstFold);
+                    const __m256i b = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + m - 1)), lastFold);
+                    auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+                    for (; mask != 0; mask &= mask - 1)
+                    {
+                        if (!candidate(i + countTrailingZeros(mask)))
+                        {
+                            return;
+                        }
+                    }
+                }
+                scalar(i);
+            }
+#endif
+        };
+
+        /**
+         * @brief Length of the text before the line's "\n" or "\r\n"
+         */
+        [[nodiscard]] std::size_t lineContentLength(const char *line, std::size_t length) noexcept
+        {
+            if (length > 0 && line[length - 1] == '\n')
+            {
+                --length;
+            }
+            if (length > 0 && line[length - 1] == '\r')
+            {
+                --length;
+            }
+            return length;
+        }
+
+        /**
+         * @brief Start of the line holding data[end - 1], searching backwards from end
+         */
+        [[nodiscard]] std::size_t lastLineStart(const char *data, std::size_t begin, std::size_t end) noexcept
+        {
+            while (end > begin && data[end - 1] != '\n')
+            {
+                --end;
+            }
+            return end;
+        }
+    } // anonymous namespace
+
+    bool TextMatcher::compile(std::string pattern, SearchOptions options)
+    {
+        pattern_ = std::move(pattern);
+        options_ = options;
+        error_.clear();
+        folded_.clear();
+        regex_.reset();
+
+        if (pattern_.empty())
+        {
+            error_ = "Empty pattern";
+            return false;
+        }
+        if (options_.regex)
+        {
+            auto flags = std::regex::ECMAScript | std::regex::optimize;
+            if (options_.ignoreCase)
+            {
+                flags |= std::regex::icase;
+            }
+            try
+            {
+                regex_ = std::make_unique<std::regex>(pattern_, flags);
+            }
+            catch (const std::regex_error &e)
+            {
+                error_ = e.what();
+                return false;
+            }
+            return true;
+        }
+
+        folded_ = pattern_;
+        if (options_.ignoreCase)
+        {
+            for (char &c : folded_)
+            {
+                c = static_cast<char>(foldAscii(static_cast<unsigned char>(c)));
+            }
+        }
+        return true;
+    }
+
+    std::size_t TextMatcher::findAll(const char *data, std::size_t size, std::uint64_t base,
+                                     std::vector<std::uint64_t> &out, std::size_t limit,
+                                     const std::atomic<bool> *cancel, std::size_t *clippedLines) const
+    {
+        if (out.size() >= limit)
+        {
+            return 0;
+        }
+
+        if (regex_)
+        {
+            // Each line is its own target, so ^ and $ anchor to lines and no match spans two of them
+            std::size_t end = 0;
+            for (std::size_t begin = 0; begin < size;)
+            {
+                if (cancel != nullptr && cancel->load(std::memory_order_relaxed))
+                {
+                    return end;
+                }
+                const void *newline = std::memchr(data + begin, '\n', size - begin);
+                const std::size_t next = newline ? static_cast<std::size_t>(static_cast<const char *>(newline) - data) + 1 : size;
+                const char *line = data + begin;
+                const char *lineEnd = line + lineContentLength(line, next - begin);
+                if (static_cast<std::size_t>(lineEnd - line) > kMaxRegexLineBytes)
+                {
+                    lineEnd = line + kMaxRegexLineBytes;
+                    if (clippedLines != nullptr)
+                    {
+                        ++*clippedLines;
+                    }
+                }
+                try
+                {
+                    for (std::cregex_iterator it(line, lineEnd, *regex_), last; it != last; ++it)
+                    {
+                        if (it->length(0) == 0)
+                        {
+                            continue; // an empty match ("^", "x*") marks a position, not text to jump to
+                        }
+                        out.push_back(base + begin + static_cast<std::size_t>(it->position(0)));
+                        end = begin + static_cast<std::size_t>(it->position(0) + it->length(0));
+                        if (out.size() >= limit)
+                        {
+                            return end;
+                        }
+                    }
+                }
+                catch (const std::regex_error &)
+                {
+                    // error_complexity or error_stack (MSVC gives up instead of overflowing): the line is skipped
+                }
+                begin = next;
+            }
+            return end;
+        }
+
+        if (folded_.empty() || size < folded_.size())
+        {
+            return 0;
+        }
+        LiteralScan scan{data, size, base, folded_, options_.ignoreCase, out, limit};
+#ifdef SLC_HAVE_X86_SIMD
+        if (cpuHasAvx2())
+        {
+            scan.avx2();
+        }
+        else
+        {
+            scan.sse2();
+        }
+#else
+        scan.scalar(0);
+#endif
+        return scan.next;
+    }
+
+    std::size_t TextMatcher::matchLength(const char *data, std::size_t size) const
+    {
+        if (regex_)
+        {
+            const void *newline = std::memchr(data, '\n', size);
+            const std::size_t length = newline ? static_cast<std::size_t>(static_cast<const char *>(newline) - data) + 1 : size;
+            const std::size_t searched = std::min(lineContentLength(data, length), kMaxRegexLineBytes);
+            std::cmatch match;
+            try
+            {
+                if (std::regex_search(data, data + searched, match, *regex_, std::regex_constants::match_continuous))
+                {
+                    return static_cast<std::size_t>(match.length(0));
+                }
+            }
+            catch (const std::regex_error &)
+            {
+            }
+            return 0;
+        }
+
+        if (folded_.empty() || size < folded_.size())
+        {
+            return 0;
+        }
+        return equalsNeedle(data, folded_, options_.ignoreCase) ? folded_.size() : 0;
+    }
+
+    std::size_t TextSearch::firstMatchFrom(std::uint64_t offset) const noexcept
+    {
+        // Matches are published in increasing offset order
+        std::size_t low = 0;
+        std::size_t high = matches_.size();
+        while (low < high)
+        {
+            const std::size_t middle = low + (high - low) / 2;
+            if (matches_[middle] < offset)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    TextSearch::~TextSearch()
+    {
+        cancel();
+    }
+
+    bool TextSearch::start(const char *data, std::size_t size, std::string pattern, SearchOptions options)
+    {
+        cancel();
+        if (!matcher_.compile(std::move(pattern), options))
+        {
+            return false;
+        }
+        active_ = true;
+        launch(data, 0, size);
+        return true;
+    }
+
+    void TextSearch::resume(const char *data, std::size_t size)
+    {
+        pause();
+        if (!active_ || size <= resumeFrom_)
+        {
+            return;
+        }
+
+        // Matches at or past the resume point get found again, possibly longer or merged with new bytes
+        std::size_t count = matches_.size();
+        while (count > 0 && matches_[count - 1] >= resumeFrom_)
+        {
+            --count;
+        }
+        matches_.truncate(count);
+        launch(data, resumeFrom_, size);
+    }
+
+    void TextSearch::pause() noexcept
+    {
+        cancel_.store(true, std::memory_order_relaxed);
+        if (worker_.joinable())
+        {
+            worker_.join();
+        }
+    }
+
+    void TextSearch::cancel() noexcept
+    {
+        pause();
+        matches_.clear();
+        resumeFrom_ = 0;
+        active_ = false;
+        searched_.store(0, std::memory_order_relaxed);
+        clippedLines_.store(0, std::memory_order_relaxed);
+        complete_.store(false, std::memory_order_relaxed);
+    }
+
+    void TextSearch::launch(const char *data, std::size_t begin, std::size_t size)
+    {
+        resumeFrom_ = begin;
+        cancel_.store(false, std::memory_order_relaxed);
+        complete_.store(false, std::memory_order_release);
+        searched_.store(begin, std::memory_order_relaxed);
+        worker_ = std::thread([this, data, begin, size]
+                              { run(data, begin, size); });
+    }
+
+    void TextSearch::run(const char *data, std::size_t begin, std::size_t size)
+    {
+        const bool regex = matcher_.options().regex;
+        // Plain text may straddle a slice boundary, so each slice re-reads the previous one's last few bytes
+        const std::size_t overlap = regex ? 0 : matcher_.pattern().size() - 1;
+        std::vector<std::uint64_t> found;
+        std::size_t lastMatchEnd = begin;
+        std::size_t clipped = 0;
+
+        std::size_t position = begin;
+        while (position < size && !isTruncated())
+        {
+            if (cancel_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            std::size_t end = std::min(size, position + kSliceBytes);
+            if (regex && end < size)
+            {
+                // Regexes see whole lines; a line longer than a slice is taken in one piece
+                const std::size_t cut = lastLineStart(data, position, end);
+                if (cut > position)
+                {
+                    end = cut;
+                }
+                else
+                {
+                    const void *newline = std::memchr(data + end, '\n', size - end);
+                    end = newline ? static_cast<std::size_t>(static_cast<const char *>(newline) - data) + 1 : size;
+                }
+            }
+
+            const std::size_t matchEnd = matcher_.findAll(data + position, end - position, position, found,
+                                                          kMaxMatches - matches_.size(), &cancel_, &clipped);
+            if (cancel_.load(std::memory_order_relaxed))
+            {
+                return; // the slice may be partial, so resumeFrom_ stays at its start
+            }
+            if (!found.empty())
+            {
+                lastMatchEnd = position + matchEnd;
+            }
+            matches_.append(found);
+            found.clear();
+
+            position = end == size ? size : std::max(end - overlap, lastMatchEnd);
+            resumeFrom_ = position;
+            searched_.store(end, std::memory_order_relaxed);
+            clippedLines_.fetch_add(std::exchange(clipped, 0), std::memory_order_relaxed);
+        }
+
+        // Where resume() picks up: a regex re-reads the unfinished last line, plain text the bytes
+        // that could begin a match completed by appended data
+        if (regex)
+        {
+            resumeFrom_ = size == 0 || data[size - 1] == '\n' ? size : std::max(begin, lastLineStart(data, begin, size));
+        }
+        else
+        {
+            resumeFrom_ = std::max({begin, lastMatchEnd, size > overlap ? size - overlap : 0});
+        }
+        complete_.store(true, std::memory_order_release);
+    }
+}
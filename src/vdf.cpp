@@ -0,0 +1,395 @@
+#include "vdf.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <system_error>
+
+namespace SteamUtils
+{
+    namespace
+    {
+        [[nodiscard]] bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept
+        {
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                char ca = (a[i] >= 'A' && a[i] <= 'Z') ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+                char cb = (b[i] >= 'A' && b[i] <= 'Z') ? static_cast<char>(b[i] - 'A' + 'a') : b[i];
+                if (ca != cb)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        enum class TokenType
+        {
+            End,
+            String,
+            Condition,
+            OpenBrace,
+            CloseBrace,
+            Invalid
+        };
+
+        struct Token
+        {
+            TokenType type;
+            std::string_view text;
+            bool hasEscapes;
+        };
+
+        /**
+         * Splits a text KeyValues buffer into tokens without copying: quoted and
+         * bare strings, [$CONDITION] markers, braces. Comments are skipped.
+         */
+        class Tokenizer
+        {
+        public:
+            explicit Tokenizer(std::string_view text) noexcept : text_(text) {}
+
+            Token next() noexcept
+            {
+                skipWhitespaceAndComments();
+                if (pos_ >= text_.size())
+                {
+                    return {TokenType::End, {}, false};
+                }
+
+                char c = text_[pos_];
+                if (c == '{')
+                {
+                    return {TokenType::OpenBrace, text_.substr(pos_++, 1), false};
+                }
+                if (c == '}')
+                {
+                    return {TokenType::CloseBrace, text_.substr(pos_++, 1), false};
+                }
+                if (c == '"')
+                {
+                    return quoted();
+                }
+                if (c == '[')
+                {
+                    std::size_t end = text_.find(']', pos_);
+                    if (end == std::string_view::npos)
+                    {
+                        return {TokenType::Invalid, text_.substr(pos_), false};
+                    }
+                    Token token{TokenType::Condition, text_.substr(pos_, end + 1 - pos_), false};
+                    pos_ = end + 1;
+                    return token;
+                }
+
+                std::size_t start = pos_;
+                while (pos_ < text_.size() && !isDelimiter(text_[pos_]))
+                {
+                    pos_++;
+                }
+                return {TokenType::String, text_.substr(start, pos_ - start), false};
+            }
+
+            Token peek() noexcept
+            {
+                std::size_t saved = pos_;
+                Token token = next();
+                pos_ = saved;
+                return token;
+            }
+
+            [[nodiscard]] std::size_t line() const noexcept
+            {
+                return 1 + static_cast<std::size_t>(std::count(text_.begin(), text_.begin() + static_cast<std::ptrdiff_t>(pos_), '\n'));
+            }
+
+        private:
+            static bool isSpace(char c) noexcept
+            {
+                return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+            }
+
+            static bool isDelimiter(char c) noexcept
+            {
+                return isSpace(c) || c == '"' || c == '{' || c == '}';
+            }
+
+            void skipWhitespaceAndComments() noexcept
+            {
+                while (pos_ < text_.size())
+                {
+                    char c = text_[pos_];
+                    if (isSpace(c))
+                    {
+                        pos_++;
+                    }
+                    else if (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '/')
+                    {
+                        std::size_t end = text_.find('\n', pos_);
+                        pos_ = end == std::string_view::npos ? text_.size() : end + 1;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+            }
+
+            Token quoted() noexcept
+            {
+                std::size_t start = ++pos_;
+                bool hasEscapes = false;
+
+                // memchr skips runs of plain characters; only quotes and backslashes need a look
+                while (pos_ < text_.size())
+                {
+                    const char *from = text_.data() + pos_;
+                    std::size_t left = text_.size() - pos_;
+                    const char *quote = static_cast<const char *>(std::memchr(from, '"', left));
+                    std::size_t quoteOffset = quote ? static_cast<std::size_t>(quote - from) : left;
+                    const char *backslash = static_cast<const char *>(std::memchr(from, '\\', quoteOffset));
+
+                    if (backslash == nullptr)
+                    {
+                        if (quote == nullptr)
+                        {
+                            pos_ = text_.size();
+                            return {TokenType::Invalid, text_.substr(start - 1), false};
+                        }
+                        pos_ += quoteOffset + 1;
+                        return {TokenType::String, text_.substr(start, pos_ - 1 - start), hasEscapes};
+                    }
+
+                    hasEscapes = true;
+                    pos_ += static_cast<std::size_t>(backslash - from) + 2;
+                }
+                return {TokenType::Invalid, text_.substr(start - 1), false};
+            }
+
+            std::string_view text_;
+            std::size_t pos_ = 0;
+        };
+    } // anonymous namespace
+
+    const KeyValue *KeyValue::find(std::string_view childKey) const noexcept
+    {
+        for (const KeyValue *child = firstChild; child != nullptr; child = child->nextSibling)
+        {
+            if (equalsIgnoreCase(child->key, childKey))
+            {
+                return child;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string_view KeyValue::get(std::string_view childKey) const noexcept
+    {
+        const KeyValue *child = find(childKey);
+        return (child != nullptr && !child->isBlock) ? child->value : std::string_view{};
+    }
+
+    void KeyValuesDocument::reset()
+    {
+        // Keep the first arena block around so re-parsing into the same document does not allocate
+        if (blocks_.size() > 1)
+        {
+            blocks_.resize(1);
+        }
+        cursor_ = blocks_.empty() ? nullptr : blocks_.front().get();
+        remaining_ = blocks_.empty() ? 0 : kArenaBlockSize;
+        root_ = KeyValue{};
+        root_.isBlock = true;
+        error_.clear();
+    }
+
+    void *KeyValuesDocument::allocate(std::size_t size, std::size_t alignment)
+    {
+        std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(cursor_) % alignment) % alignment;
+        if (cursor_ == nullptr || padding + size > remaining_)
+        {
+            std::size_t blockSize = std::max(kArenaBlockSize, size + alignment);
+            blocks_.push_back(std::unique_ptr<char[]>(new char[blockSize])); // left uninitialized on purpose
+            cursor_ = blocks_.back().get();
+            remaining_ = blockSize;
+            padding = (alignment - reinterpret_cast<std::uintptr_t>(cursor_) % alignment) % alignment;
+        }
+
+        void *result = cursor_ + padding;
+        cursor_ += padding + size;
+        remaining_ -= padding + size;
+        return result;
+    }
+
+    KeyValue *KeyValuesDocument::newNode()
+    {
+        return new (allocate(sizeof(KeyValue), alignof(KeyValue))) KeyValue{};
+    }
+
+    std::string_view KeyValuesDocument::decodeEscapes(std::string_view raw)
+    {
+        // Decoding never lengthens a string, so the raw size is an upper bound
+        char *out = static_cast<char *>(allocate(raw.size(), 1));
+        std::size_t length = 0;
+
+        for (std::size_t i = 0; i < raw.size(); ++i)
+        {
+            char c = raw[i];
+            if (c == '\\' && i + 1 < raw.size())
+            {
+                switch (raw[++i])
+                {
+                case 'n':
+                    c = '\n';
+                    break;
+                case 't':
+                    c = '\t';
+                    break;
+                case 'r':
+                    c = '\r';
+                    break;
+                default:
+                    c = raw[i]; // \\, \" and unknown escapes keep the escaped character
+                    break;
+                }
+            }
+            out[length++] = c;
+        }
+        return {out, length};
+    }
+
+    bool KeyValuesDocument::parse(std::string_view text)
+    {
+        reset();
+
+        // Skip a UTF-8 byte order mark
+        if (text.size() >= 3 && std::memcmp(text.data(), "\xEF\xBB\xBF", 3) == 0)
+        {
+            text.remove_prefix(3);
+        }
+
+        struct Level
+        {
+            KeyValue *block;
+            KeyValue *lastChild;
+        };
+        constexpr std::size_t kMaxDepth = 128;
+
+        std::vector<Level> stack;
+        stack.push_back(Level{&root_, nullptr});
+        Tokenizer tokenizer(text);
+
+        auto fail = [&](const char *message)
+        {
+            error_ = std::string(message) + " at line " + std::to_string(tokenizer.line());
+            return false;
+        };
+
+        auto textOf = [this](const Token &token)
+        { return token.hasEscapes ? decodeEscapes(token.text) : token.text; };
+
+        while (true)
+        {
+            Token token = tokenizer.next();
+
+            if (token.type == TokenType::End)
+            {
+                return stack.size() == 1 ? true : fail("Unterminated block");
+            }
+            if (token.type == TokenType::CloseBrace)
+            {
+                if (stack.size() == 1)
+                {
+                    return fail("Unexpected '}'");
+                }
+                stack.pop_back();
+                continue;
+            }
+            if (token.type != TokenType::String)
+            {
+                return fail(token.type == TokenType::Invalid ? "Unterminated string" : "Expected a key");
+            }
+
+            KeyValue *node = newNode();
+            node->key = textOf(token);
+
+            Token valueToken = tokenizer.next();
+            if (valueToken.type == TokenType::Condition)
+            {
+                valueToken = tokenizer.next();
+            }
+
+            if (valueToken.type == TokenType::String)
+            {
+                node->value = textOf(valueToken);
+                if (tokenizer.peek().type == TokenType::Condition)
+                {
+                    (void)tokenizer.next();
+                }
+            }
+            else if (valueToken.type == TokenType::OpenBrace)
+            {
+                node->isBlock = true;
+            }
+            else
+            {
+                return fail(valueToken.type == TokenType::Invalid ? "Unterminated string" : "Expected a value or '{'");
+            }
+
+            Level &level = stack.back();
+            if (level.lastChild == nullptr)
+            {
+                level.block->firstChild = node;
+            }
+            else
+            {
+                level.lastChild->nextSibling = node;
+            }
+            level.lastChild = node;
+
+            if (node->isBlock)
+            {
+                if (stack.size() > kMaxDepth)
+                {
+                    return fail("Nesting too deep");
+                }
+                stack.push_back(Level{node, nullptr});
+            }
+        }
+    }
+
+    bool KeyValuesDocument::parseFile(const fs::path &path)
+    {
+        reset();
+        file_.close();
+
+        std::error_code ec;
+        std::uintmax_t size = fs::file_size(path, ec);
+
+        // Mapping costs more than a read for typical manifest sizes; only large files are mapped
+        if (!ec && size < kMapThreshold)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (file.is_open())
+            {
+                buffer_.resize(static_cast<std::size_t>(size));
+                file.read(buffer_.data(), static_cast<std::streamsize>(size));
+                buffer_.resize(static_cast<std::size_t>(file.gcount()));
+                return parse(buffer_);
+            }
+        }
+        else if (file_.open(path))
+        {
+            return parse(std::string_view(file_.data(), file_.size()));
+        }
+
+        error_ = "Cannot open " + path.string();
+        return false;
+    }
+}
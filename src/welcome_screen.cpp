@@ -2,6 +2,12 @@
 
 #include <imgui.h>
 #include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "colors.hpp"
 #include "fonts.hpp"
@@ -10,6 +16,217 @@
 #include "logger.hpp"
 #include "steam-utils.hpp"
 
+namespace
+{
+    void RunSteamDiscovery(SteamDiscoveryJob &job)
+    {
+        std::filesystem::path steamDir = job.manualDir;
+        if (steamDir.empty())
+        {
+            SteamUtils::SteamSearchOptions options;
+            options.cancel = &job.cancel;
+            options.onProbe = [&job](const std::filesystem::path &path, std::size_t index, std::size_t count)
+            {
+                job.pathsProbed = index;
+                job.pathCount = count;
+                std::lock_guard<std::mutex> lock(job.mutex);
+                job.probing = path;
+            };
+            steamDir = SteamUtils::findSteamDirectory(options);
+            if (steamDir.empty() && !job.cancel)
+            {
+                job.error = "Could not auto-detect Steam directory. Please enter it manually.";
+            }
+        }
+        else if (!SteamUtils::directoryExists(steamDir))
+        {
+            job.error = "The specified directory does not exist: " + steamDir.string();
+            steamDir.clear();
+        }
+        else if (!SteamUtils::isValidSteamDirectory(steamDir))
+        {
+            job.error = "This does not appear to be a valid Steam directory.";
+            steamDir.clear();
+        }
+
+        if (steamDir.empty() || job.cancel)
+        {
+            job.finished = true;
+            return;
+        }
+
+        job.steamDir = steamDir;
+        job.steamFound = true;
+
+        SteamUtils::GameScanOptions options;
+        options.cancel = &job.cancel;
+        options.onGames = [&job](const std::vector<SteamUtils::GameInfo> &games,
+                                 const SteamUtils::GameScanProgress &progress)
+        {
+            job.manifestCount = progress.manifestCount;
+            job.manifestsParsed = progress.manifestsParsed;
+            if (!games.empty())
+            {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                job.pending.insert(job.pending.end(), games.begin(), games.end());
+            }
+        };
+        job.games = SteamUtils::getInstalledGames(steamDir, options);
+        job.finished = true;
+    }
+
+    void StartSteamDiscovery(AppState &state, std::filesystem::path manualDir)
+    {
+        // A run still probing a slow drive is left to finish in the background
+        AbandonSteamDiscovery(state);
+
+        SteamDiscoveryTask &task = state.steamDiscovery;
+        task.job = std::make_shared<SteamDiscoveryJob>();
+        task.job->manualDir = std::move(manualDir);
+        task.worker = std::thread([job = task.job]()
+                                  { RunSteamDiscovery(*job); });
+    }
+
+    void RenderProbeStatus(AppState &state, float width)
+    {
+        SteamDiscoveryJob &job = *state.steamDiscovery.job;
+        if (job.manualDir.empty())
+        {
+            std::filesystem::path probing;
+            {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                probing = job.probing;
+            }
+            std::size_t count = job.pathCount;
+            ImGui::TextColored(UIColors::LavenderBlue, "Checking location %zu of %zu",
+                               std::min(job.pathsProbed.load() + 1, count), count);
+            ImGui::PushTextWrapPos(ImGui::GetCursorPosX() + width);
+            ImGui::TextDisabled("%s", probing.string().c_str());
+            ImGui::PopTextWrapPos();
+        }
+        else
+        {
+            ImGui::TextColored(UIColors::LavenderBlue, "Checking %s", job.manualDir.string().c_str());
+        }
+
+        if (UIWidgets::SecondaryButton("Cancel", ImVec2(width, 0)))
+        {
+            AbandonSteamDiscovery(state);
+        }
+    }
+}
+
+void UpdateSteamDiscovery(AppState &state)
+{
+    SteamDiscoveryTask &task = state.steamDiscovery;
+    for (auto it = task.abandoned.begin(); it != task.abandoned.end();)
+    {
+        if (it->first->finished)
+        {
+            it->second.join();
+            it = task.abandoned.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (!task.job)
+    {
+        return;
+    }
+
+    std::shared_ptr<SteamDiscoveryJob> job = task.job;
+    if (job->steamFound && !state.steamDirFound)
+    {
+        state.steamDir = job->steamDir;
+        state.steamDirFound = true;
+        state.scanningGames = true;
+        state.games.clear();
+        state.errorMessage.clear();
+        state.currentScreen = Screen::GameSelection;
+        if (job->manualDir.empty())
+        {
+            UIToast::Success("Steam directory auto-detected successfully.");
+            Logger::log("Found Steam directory: " + state.steamDir.string(), SeverityLevel::Info);
+        }
+        else
+        {
+            UIToast::Success("Manual Steam directory set successfully.");
+            Logger::log("Using manual Steam directory: " + state.steamDir.string(), SeverityLevel::Info);
+        }
+    }
+
+    if (state.scanningGames)
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        std::move(job->pending.begin(), job->pending.end(), std::back_inserter(state.games));
+        job->pending.clear();
+    }
+
+    if (!job->finished)
+    {
+        return;
+    }
+
+    task.worker.join();
+    task.job.reset();
+    state.scanningGames = false;
+
+    if (!job->error.empty())
+    {
+        UIToast::Error(job->error);
+    }
+    if (!job->steamFound)
+    {
+        return;
+    }
+
+    // Games arrived batch by batch; switch to library order without losing the game being viewed
+    std::string selectedAppId;
+    std::filesystem::path selectedLibrary;
+    if (state.selectedGameIndex >= 0 && state.selectedGameIndex < static_cast<int>(state.games.size()))
+    {
+        selectedAppId = state.games[state.selectedGameIndex].appId;
+        selectedLibrary = state.games[state.selectedGameIndex].libraryPath;
+    }
+
+    state.games = std::move(job->games);
+    if (!selectedAppId.empty())
+    {
+        const auto it = std::find_if(state.games.begin(), state.games.end(),
+                                     [&](const SteamUtils::GameInfo &game)
+                                     { return game.appId == selectedAppId && game.libraryPath == selectedLibrary; });
+        state.selectedGameIndex = it != state.games.end() ? static_cast<int>(it - state.games.begin()) : -1;
+    }
+
+    if (job->cancel)
+    {
+        UIToast::Info("Stopped loading games with " + std::to_string(state.games.size()) + " found.");
+    }
+}
+
+void StopLoadingGames(AppState &state)
+{
+    if (state.steamDiscovery.job)
+    {
+        state.steamDiscovery.job->cancel = true;
+    }
+}
+
+void AbandonSteamDiscovery(AppState &state)
+{
+    SteamDiscoveryTask &task = state.steamDiscovery;
+    if (task.job)
+    {
+        task.job->cancel = true;
+        task.abandoned.emplace_back(std::move(task.job), std::move(task.worker));
+        task.job.reset();
+    }
+    state.scanningGames = false;
+}
+
 void RenderWelcomeScreen(AppState &state)
 {
     ImVec2 windowSize = ImGui::GetContentRegionAvail();
@@ -74,24 +291,23 @@ void RenderWelcomeScreen(AppState &state)
     float buttonWidth = contentWidth - innerPadding * 2;
     float buttonHeight = std::max(windowSize.y * 0.06f, 45.0f);
 
-    if (UIWidgets::PrimaryButton("Auto-Detect Steam Directory",
+    const bool probing = state.steamDiscovery.job != nullptr;
+    if (probing)
+        ImGui::BeginDisabled();
+
+    if (UIWidgets::PrimaryButton(probing ? "Searching..." : "Auto-Detect Steam Directory",
                                  ImVec2(buttonWidth, buttonHeight)))
     {
-        state.statusMessage = "Searching for Steam...";
-        state.steamDir = SteamUtils::findSteamDirectory();
+        StartSteamDiscovery(state, {});
+    }
 
-        if (!state.steamDir.empty())
-        {
-            state.steamDirFound = true;
-            UIToast::Success("Steam directory auto-detected successfully.");
-            Logger::log("Found Steam directory: " + state.steamDir.string(), SeverityLevel::Info);
-            state.games = SteamUtils::getInstalledGames(state.steamDir);
-            state.currentScreen = Screen::GameSelection;
-        }
-        else
-        {
-            UIToast::Error("Could not auto-detect Steam directory. Please enter it manually.");
-        }
+    if (probing)
+        ImGui::EndDisabled();
+
+    if (probing)
+    {
+        ImGui::Spacing();
+        RenderProbeStatus(state, buttonWidth);
     }
 
     ImGui::Spacing();
@@ -140,22 +356,10 @@ void RenderWelcomeScreen(AppState &state)
         {
             UIToast::Error("Please enter a Steam directory path.");
         }
-        else if (!SteamUtils::directoryExists(manualPath))
-        {
-            UIToast::Error("The specified directory does not exist: " + manualPath);
-        }
-        else if (!SteamUtils::isValidSteamDirectory(manualPath))
-        {
-            UIToast::Error("This does not appear to be a valid Steam directory.");
-        }
         else
         {
-            state.steamDir = manualPath;
-            state.steamDirFound = true;
-            UIToast::Success("Manual Steam directory set successfully.");
-            Logger::log("Using manual Steam directory: " + state.steamDir.string(), SeverityLevel::Info);
-            state.games = SteamUtils::getInstalledGames(state.steamDir);
-            state.currentScreen = Screen::GameSelection;
+            // Replaces a probe that is still running; the path is checked off the UI thread too
+            StartSteamDiscovery(state, manualPath);
         }
     }
 
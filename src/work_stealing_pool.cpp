@@ -0,0 +1,142 @@
+#include "work_stealing_pool.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+namespace SteamUtils
+{
+    namespace
+    {
+        thread_local const WorkStealingPool *tlsPool = nullptr;
+        thread_local std::size_t tlsWorkerIndex = 0;
+    } // anonymous namespace
+
+    WorkStealingPool::WorkStealingPool(std::size_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        workers_.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+
+        threads_.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            threads_.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        workAvailable_.notify_all();
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void WorkStealingPool::submit(Task task)
+    {
+        // Tasks spawned by a worker go to its own deque; external submissions are spread round-robin
+        std::size_t target = (tlsPool == this)
+                                 ? tlsWorkerIndex
+                                 : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+            workers_[target]->tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        workAvailable_.notify_one();
+    }
+
+    void WorkStealingPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        allDone_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+
+    bool WorkStealingPool::popLocal(std::size_t index, Task &task)
+    {
+        Worker &worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool WorkStealingPool::steal(std::size_t thief, Task &task)
+    {
+        for (std::size_t offset = 1; offset < workers_.size(); ++offset)
+        {
+            Worker &victim = *workers_[(thief + offset) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::run(std::size_t index)
+    {
+        tlsPool = this;
+        tlsWorkerIndex = index;
+
+        while (true)
+        {
+            Task task;
+            if (popLocal(index, task) || steal(index, task))
+            {
+                queued_.fetch_sub(1, std::memory_order_acq_rel);
+                try
+                {
+                    task(index);
+                }
+                catch (const std::exception &e)
+                {
+                    Logger::log(std::string("Unhandled exception in worker task: ") + e.what(), SeverityLevel::Err);
+                }
+
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    allDone_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            workAvailable_.wait(lock, [this]
+                                { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,293 @@
+// Turns a binary diagnostics file (--binary-log / SLC_BINARY_LOG) back into
+// readable text, or into JSON with one object per line.
+//
+// Usage: slc-log-decode [--json] <file>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_log.hpp"
+#include "copy_engine.hpp"
+#include "log_classifier.hpp"
+
+namespace
+{
+    using namespace BinaryLog;
+
+    struct Decoder
+    {
+        std::unordered_map<std::uint32_t, std::string> strings;
+        bool json = false;
+
+        [[nodiscard]] const std::string &lookup(std::uint32_t id) const
+        {
+            static const std::string missing = "<missing string>";
+            auto it = strings.find(id);
+            return it != strings.end() ? it->second : missing;
+        }
+
+        /**
+         * Names for the enum-valued fields; empty for plain numbers
+         */
+        [[nodiscard]] static std::string_view enumName(Event event, int field, std::uint64_t value)
+        {
+            if (event == Event::LogFileFound && field == 2 && value <= static_cast<std::uint64_t>(SteamUtils::LogCategory::Console))
+            {
+                return SteamUtils::logCategoryName(static_cast<SteamUtils::LogCategory>(value));
+            }
+            if (event == Event::FileCopied && field == 1 && value <= static_cast<std::uint64_t>(SteamUtils::CopyMethod::Hardlink))
+            {
+                return SteamUtils::copyMethodName(static_cast<SteamUtils::CopyMethod>(value));
+            }
+            return {};
+        }
+
+        static void appendJsonString(std::string &out, std::string_view text)
+        {
+            out.push_back('"');
+            for (char c : text)
+            {
+                switch (c)
+                {
+                case '"':
+                    out.append("\\\"");
+                    break;
+                case '\\':
+                    out.append("\\\\");
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\r':
+                    out.append("\\r");
+                    break;
+                case '\t':
+                    out.append("\\t");
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char escape[8];
+                        std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+                        out.append(escape);
+                    }
+                    else
+                    {
+                        out.push_back(c);
+                    }
+                }
+            }
+            out.push_back('"');
+        }
+
+        [[nodiscard]] static std::string formatTime(std::int64_t timeNs)
+        {
+            std::time_t seconds = static_cast<std::time_t>(timeNs / 1000000000);
+            std::tm tmBuf{};
+#ifdef _WIN32
+            localtime_s(&tmBuf, &seconds);
+#else
+            localtime_r(&seconds, &tmBuf);
+#endif
+            char text[64];
+            std::size_t length = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tmBuf);
+            std::snprintf(text + length, sizeof(text) - length, ".%06lld",
+                          static_cast<long long>((timeNs % 1000000000) / 1000));
+            return text;
+        }
+
+        void print(const BinaryLogRecord &record, std::string &out) const
+        {
+            const auto event = static_cast<Event>(record.event);
+            const bool known = record.event < kEventCount;
+            const char *level = Logger::levelName(static_cast<SeverityLevel>(record.level));
+            out.clear();
+
+            if (json)
+            {
+                out.append("{\"time_ns\":").append(std::to_string(record.timeNs));
+                out.append(",\"level\":\"").append(level).append("\"");
+                out.append(",\"thread\":").append(std::to_string(record.thread));
+                out.append(",\"event\":");
+                appendJsonString(out, known ? kEventInfo[record.event].name : "unknown");
+                for (int i = 0; known && i < 3; ++i)
+                {
+                    if (const char *name = kEventInfo[record.event].values[i])
+                    {
+                        out.append(",\"").append(name).append("\":");
+                        std::string_view text = enumName(event, i, record.values[i]);
+                        if (text.empty())
+                        {
+                            out.append(std::to_string(record.values[i]));
+                        }
+                        else
+                        {
+                            appendJsonString(out, text);
+                        }
+                    }
+                }
+                for (int i = 0; known && i < 2; ++i)
+                {
+                    const char *name = kEventInfo[record.event].strings[i];
+                    if (name != nullptr && record.strings[i] != 0)
+                    {
+                        out.append(",\"").append(name).append("\":");
+                        appendJsonString(out, lookup(record.strings[i]));
+                    }
+                }
+                out.append("}\n");
+                return;
+            }
+
+            out.append(formatTime(record.timeNs)).append(" [").append(level).append("] t");
+            out.append(std::to_string(record.thread)).push_back(' ');
+            if (!known)
+            {
+                out.append("unknown event ").append(std::to_string(record.event)).push_back('\n');
+                return;
+            }
+            if (event == Event::Message)
+            {
+                out.append(lookup(record.strings[0])).push_back('\n');
+                return;
+            }
+
+            const EventInfo &info = kEventInfo[record.event];
+            out.append(info.name);
+            for (int i = 0; i < 2; ++i)
+            {
+                if (info.strings[i] != nullptr && record.strings[i] != 0)
+                {
+                    out.append(" ").append(info.strings[i]).append("=").append(lookup(record.strings[i]));
+                }
+            }
+            for (int i = 0; i < 3; ++i)
+            {
+                if (info.values[i] != nullptr)
+                {
+                    std::string_view text = enumName(event, i, record.values[i]);
+                    out.append(" ").append(info.values[i]).append("=");
+                    out.append(text.empty() ? std::to_string(record.values[i]) : std::string(text));
+                }
+            }
+            out.push_back('\n');
+        }
+
+        [[nodiscard]] bool readStrings(const std::vector<char> &payload, std::uint32_t count)
+        {
+            std::size_t offset = 0;
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                std::uint32_t id = 0;
+                std::uint32_t length = 0;
+                if (payload.size() - offset < sizeof(id) + sizeof(length))
+                {
+                    return false;
+                }
+                std::memcpy(&id, payload.data() + offset, sizeof(id));
+                std::memcpy(&length, payload.data() + offset + sizeof(id), sizeof(length));
+                offset += sizeof(id) + sizeof(length);
+                if (payload.size() - offset < length)
+                {
+                    return false;
+                }
+                strings[id].assign(payload.data() + offset, length);
+                offset += length;
+            }
+            return true;
+        }
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    Decoder decoder;
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0)
+        {
+            decoder.json = true;
+        }
+        else if (path == nullptr)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = nullptr;
+            break;
+        }
+    }
+    if (path == nullptr)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--json] <file>" << '\n';
+        return 1;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    BinaryLogHeader header{};
+    if (!in.is_open() || !in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        std::cerr << path << ": not a binary log" << '\n';
+        return 1;
+    }
+    if (header.version != kVersion || header.recordSize != sizeof(BinaryLogRecord))
+    {
+        std::cerr << path << ": unsupported version " << header.version << " (record size " << header.recordSize << ")" << '\n';
+        return 1;
+    }
+
+    std::vector<char> payload;
+    std::string line;
+    std::uint64_t records = 0;
+    BinaryLogBlockHeader block{};
+    while (in.read(reinterpret_cast<char *>(&block), sizeof(block)))
+    {
+        payload.resize(block.bytes);
+        if (!in.read(payload.data(), static_cast<std::streamsize>(block.bytes)))
+        {
+            std::cerr << path << ": truncated block ignored" << '\n';
+            break;
+        }
+
+        if (block.kind == kStringBlock)
+        {
+            if (!decoder.readStrings(payload, block.count))
+            {
+                std::cerr << path << ": malformed string block" << '\n';
+                return 1;
+            }
+        }
+        else if (block.kind == kRecordBlock && block.bytes == std::uint64_t{block.count} * sizeof(BinaryLogRecord))
+        {
+            for (std::uint32_t i = 0; i < block.count; ++i)
+            {
+                BinaryLogRecord record;
+                std::memcpy(&record, payload.data() + i * sizeof(BinaryLogRecord), sizeof(record));
+                decoder.print(record, line);
+                std::cout << line;
+            }
+            records += block.count;
+        }
+        else
+        {
+            std::cerr << path << ": skipping unknown block kind " << block.kind << '\n';
+        }
+    }
+
+    if (!decoder.json)
+    {
+        std::cerr << records << " records, " << decoder.strings.size() << " strings" << '\n';
+    }
+    return 0;
+}